@@ -9,6 +9,8 @@ use {
 pub const FOREIGN_FN_IFACE_DIR_NAME: &'static str = "ffi";
 const RUST_VISIBLE_FILE_EXT: &'static str = ".rs.h";
 const VULKAN_ITEM_REGEX: &'static str = r"(PFN_)?((vk)|(Vk)|(VK)).*";
+const OS_DIR_NAME: &'static str = "os";
+const OS_SPECIFIC_DIR_NAMES: [&'static str; 3] = ["windows", "macos", "linux"];
 
 // TODO: panic if found several files with the same name
 
@@ -26,7 +28,7 @@ pub fn process_c_srcs(dir: &Path, include_dirs: &Vec<PathBuf>, cc_build: &mut cc
                 let builder = bindgen::Builder::default()
                     .clang_args(
                         include_dirs.iter()
-                            .map(|path| format!("-F{}", path.display()))
+                            .map(|path| format!("-I{}", path.display()))
                     )
                     .blacklist_item(VULKAN_ITEM_REGEX)
                     .raw_line("#![allow(unused_variables)]")
@@ -64,6 +66,10 @@ fn process_ffi_dir(dir: &Path, mut builder: bindgen::Builder, cc_build: &mut cc:
         let path = entry.path();
 
         if path.is_dir() {
+            if is_foreign_os_dir(&path) {
+                continue;
+            }
+
             let (subdir_builder, subdir_bindins_count) = process_ffi_dir(
                 &path,
                 builder,
@@ -92,4 +98,20 @@ fn process_ffi_dir(dir: &Path, mut builder: bindgen::Builder, cc_build: &mut cc:
     }
 
     Ok((builder, bindings_count))
-}
\ No newline at end of file
+}
+
+// `ffi/os/<os name>` directories contain sources for the specific OS only
+fn is_foreign_os_dir(dir: &Path) -> bool {
+    let is_os_subdir = dir.parent()
+        .and_then(|parent| parent.file_name())
+        .map(|parent_name| parent_name == OS_DIR_NAME)
+        .unwrap_or(false);
+
+    let dir_name = dir.file_name()
+        .map(|name| name.to_string_lossy().to_string())
+        .unwrap_or_default();
+
+    is_os_subdir
+        && OS_SPECIFIC_DIR_NAMES.contains(&dir_name.as_str())
+        && dir_name != std::env::consts::OS
+}
@@ -1,4 +1,4 @@
-use std::{path::PathBuf, io, fmt, env};
+use std::{path::{Path, PathBuf}, io, fmt, env};
 
 pub mod shader;
 pub mod ffi;
@@ -15,6 +15,7 @@ pub enum Error {
     ShaderCompile(shaderc::Error),
     EnvVar(env::VarError),
     Internal(String),
+    Shaders(Vec<(PathBuf, Error)>),
 }
 
 impl fmt::Display for Error {
@@ -28,6 +29,15 @@ impl fmt::Display for Error {
             Self::ShaderCompile(err) => write!(f, "shader compiler error: {}", err),
             Self::EnvVar(err) => write!(f, "env variable error: {}", err),
             Self::Internal(err) => write!(f, "internal error: {}", err),
+            Self::Shaders(errors) => {
+                writeln!(f, "{} shader(s) failed to compile:", errors.len())?;
+
+                for (path, err) in errors {
+                    writeln!(f, "{}: {}", path.display(), err)?;
+                }
+
+                Ok(())
+            },
         }
     }
 }
@@ -69,13 +79,18 @@ pub fn project_build(
 
         cc_build.define("___windows___", None)
             .define("VK_USE_PLATFORM_WIN32_KHR", None)
+            .define("_CRT_SECURE_NO_WARNINGS", None)
             .flag(c11_std_flag)
             .flag(anno_union_suppress_warn);
     } else if cfg!(target_os = "macos") {
         cc_build.define("___macos___", None)
             .define("VK_USE_PLATFORM_MACOS_MVK", None);
     } else if cfg!(target_os = "linux") {
-        cc_build.define("___linux___", None);
+        // `log(level, target, ...)` is the FFI logging entry point, not the math builtin
+        let builtin_log_suppress = "-fno-builtin-log";
+
+        cc_build.define("___linux___", None)
+            .flag(builtin_log_suppress);
     } else {
         cc_build.define("___unknown___", None);
     }
@@ -90,6 +105,12 @@ pub fn project_build(
 
     cc_build.compile("apriori2.c.ffi");
 
+    let link_kind = if cfg!(target_os = "windows") {
+        "static"
+    } else {
+        "dylib"
+    };
+
     for lib in libraries {
         let lib_name = lib.file_stem()
             .ok_or(Error::FilenameExpected(lib.clone()))?;
@@ -97,8 +118,12 @@ pub fn project_build(
             .parent()
             .ok_or(Error::ParentDirExpected(lib.clone()))?;
 
-        println!("cargo:rustc-link-search=native={}", lib_dir.display());
-        println!("cargo:rustc-link-lib=static={}", lib_name.to_string_lossy());
+        // A bare library name is looked up in the system paths
+        if lib_dir != Path::new("") {
+            println!("cargo:rustc-link-search=native={}", lib_dir.display());
+        }
+
+        println!("cargo:rustc-link-lib={}={}", link_kind, lib_name.to_string_lossy());
     }
 
     Ok(())
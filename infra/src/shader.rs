@@ -1,7 +1,16 @@
 use {
     std::{
         fs,
-        io::prelude::*,
+        env,
+        thread,
+        cell::RefCell,
+        collections::HashMap,
+        rc::Rc,
+        sync::{
+            Arc,
+            mpsc,
+            atomic::{AtomicUsize, Ordering},
+        },
         path::{Path, PathBuf}
     },
     shaderc::{
@@ -21,6 +30,114 @@ use {
     },
 };
 
+const SHADER_CACHE_FILE_NAME: &'static str = "shader_cache.txt";
+const SHADER_SIZE_REPORT_FILE_NAME: &'static str = "shader_sizes.txt";
+
+// The SPIR-V of the variants is kept in `OUT_DIR/<SHADER_SPIRV_DIR_NAME>`
+// and packed into `OUT_DIR/<SHADER_PACK_FILE_NAME>`
+const SHADER_SPIRV_DIR_NAME: &'static str = "spirv";
+const SHADER_PACK_FILE_NAME: &'static str = "shader_pack.spv";
+const SHADER_PACK_NAME: &'static str = "shader_pack";
+const SHADER_PACK_SYMBOL: &'static str = "apriori_shader_pack";
+
+// Overrides the optimization level: zero, size or performance
+const SHADER_OPTIMIZATION_ENV_VAR: &'static str = "APRIORI_SHADER_OPTIMIZATION";
+
+// Set to 1 to report the optimized sizes against the unoptimized ones
+// (every optimized variant is compiled twice)
+const SHADER_SIZE_BASELINE_ENV_VAR: &'static str = "APRIORI_SHADER_SIZE_BASELINE";
+
+// Bump when the generated files change: the cached shaders are generated again
+const SHADER_GENERATOR_VERSION: u32 = 3;
+
+const SHADER_ENTRY_POINT_NAME: &'static str = "main";
+
+// `#pragma shader_variant <AXIS>` declares a permutation axis of the shader
+const SHADER_VARIANT_PRAGMA: &'static str = "#pragma shader_variant";
+
+// Every axis doubles the SPIR-V variants
+const SHADER_MAX_VARIANT_AXES: usize = 6;
+
+struct CompiledShader {
+    hash: u64,
+    includes: Vec<PathBuf>,
+
+    // SPIR-V bytes without the optimization and the debug info (if measured)
+    unoptimized_size: Option<usize>,
+    size: usize,
+}
+
+type ShaderCompileOutput = Result<CompiledShader>;
+
+/// How the SPIR-V of all the shaders is compiled
+#[derive(Debug, Clone, Copy)]
+struct ShaderBuildParams {
+    optimization_level_name: &'static str,
+
+    // Source and line info for the shader debuggers (RenderDoc)
+    is_debug_info: bool,
+
+    // The unoptimized SPIR-V is compiled for the size report too
+    is_size_baseline: bool,
+}
+
+impl ShaderBuildParams {
+    /// Shaders compiled at runtime are meant for tuning: unoptimized with the debug info
+    fn hot_reload() -> Self {
+        Self {
+            optimization_level_name: "zero",
+            is_debug_info: true,
+            is_size_baseline: false,
+        }
+    }
+
+    /// Debug builds are unoptimized with the debug info,
+    /// release builds are optimized for performance with the debug info and names stripped
+    fn new() -> Result<Self> {
+        println!("cargo:rerun-if-env-changed={}", SHADER_OPTIMIZATION_ENV_VAR);
+        println!("cargo:rerun-if-env-changed={}", SHADER_SIZE_BASELINE_ENV_VAR);
+
+        let is_debug = cfg!(debug_assertions);
+
+        let optimization_level_name = match env::var(SHADER_OPTIMIZATION_ENV_VAR) {
+            Ok(level) => match level.as_str() {
+                "zero" => "zero",
+                "size" => "size",
+                "performance" => "performance",
+                _ => return Err(
+                    Error::ShaderFile(
+                        format!(
+                            "{}: unknown optimization level {} (expected zero, size or performance)",
+                            SHADER_OPTIMIZATION_ENV_VAR,
+                            level
+                        )
+                    )
+                ),
+            },
+            Err(_) if is_debug => "zero",
+            Err(_) => "performance",
+        };
+
+        let is_size_baseline = env::var(SHADER_SIZE_BASELINE_ENV_VAR)
+            .map(|value| value == "1")
+            .unwrap_or(false);
+
+        Ok(Self {
+            optimization_level_name,
+            is_debug_info: is_debug,
+            is_size_baseline,
+        })
+    }
+
+    fn optimization_level(&self) -> Option<shaderc::OptimizationLevel> {
+        match self.optimization_level_name {
+            "size" => Some(shaderc::OptimizationLevel::Size),
+            "performance" => Some(shaderc::OptimizationLevel::Performance),
+            _ => None,
+        }
+    }
+}
+
 pub fn process_shader_srcs(src_path: &PathBuf, dir: &Path) -> Result<()> {
     const SHADER_DIR_NAME: &'static str = "gpu";
 
@@ -34,7 +151,56 @@ pub fn process_shader_srcs(src_path: &PathBuf, dir: &Path) -> Result<()> {
 
         if let Some(dir_name) = path.components().last() {
             if dir_name.as_os_str().to_string_lossy() == SHADER_DIR_NAME {
-                process_shader_dir(src_path, dir, &path)?;
+                let mut shader_paths = vec![];
+                collect_shader_paths(&path, &mut shader_paths)?;
+
+                let out_dir = PathBuf::from(env::var("OUT_DIR")?);
+                let build_params = ShaderBuildParams::new()?;
+                let mut cache = ShaderCache::load(&out_dir)?;
+                let mut errors = vec![];
+                let mut shaders = vec![];
+                let mut stale_shaders = vec![];
+
+                for file_path in &shader_paths {
+                    println!("cargo:rerun-if-changed={}", file_path.display());
+
+                    match ShaderSource::new(src_path, dir, &out_dir, file_path, build_params) {
+                        Ok(shader) => {
+                            println!("cargo:rerun-if-changed={}", shader.ffi_header.display());
+                            println!("cargo:rerun-if-changed={}", shader.ffi_src.display());
+
+                            if shader.is_fresh(&cache) {
+                                shaders.push(shader);
+                            } else {
+                                stale_shaders.push(shader);
+                            }
+                        },
+                        Err(err) => errors.push((file_path.clone(), err)),
+                    }
+                }
+
+                for (shader, output) in compile_shaders(src_path, stale_shaders)? {
+                    match output {
+                        Ok(compiled_shader) => {
+                            cache.insert(&shader.file_path, compiled_shader);
+                            shaders.push(shader);
+                        },
+                        Err(err) => errors.push((shader.file_path, err)),
+                    }
+                }
+
+                // The successfully compiled shaders are kept even if the others failed
+                cache.save()?;
+                cache.write_size_report(&out_dir, &shader_paths, build_params)?;
+
+                if !errors.is_empty() {
+                    return Err(Error::Shaders(errors));
+                }
+
+                // The pack layout doesn't depend on the order of the compilation
+                shaders.sort_by(|lhs, rhs| lhs.file_path.cmp(&rhs.file_path));
+                write_shader_pack(src_path, &out_dir, &shaders)?;
+
                 break;
             }
         }
@@ -43,105 +209,851 @@ pub fn process_shader_srcs(src_path: &PathBuf, dir: &Path) -> Result<()> {
     Ok(())
 }
 
-fn process_shader_dir(src_path: &PathBuf, top_shader_dir: &Path, dir: &Path) -> Result<()> {
+/// A shader variant compiled at runtime (the hot reload)
+pub struct HotShader {
+    pub spirv: Vec<u32>,
+
+    // Resolved by the include callback, the shader depends on them
+    pub includes: Vec<PathBuf>,
+}
+
+/// Compiles a variant of the shader in-process, the same way as the build does
+/// (`src_path` is the root of the includes), but unoptimized and with the debug info.
+/// `variant` is the bitmask of the `#pragma shader_variant` axes.
+pub fn compile_hot_shader(src_path: &PathBuf, file_path: &Path, variant: u32) -> Result<HotShader> {
+    let mut compiler = Compiler::new()
+        .ok_or(Error::Internal("shader compiler allocation failure".to_string()))?;
+
+    // The hot shaders have no SPIR-V files of the build
+    let shader = ShaderSource::new(
+        src_path,
+        src_path,
+        &env::temp_dir(),
+        file_path,
+        ShaderBuildParams::hot_reload()
+    )?;
+
+    if variant >= shader.variant_count() {
+        return Err(
+            Error::ShaderFile(
+                format!(
+                    "the shader {} has no variant {} ({} variants)",
+                    file_path.display(), variant, shader.variant_count()
+                )
+            )
+        );
+    }
+
+    let includes = Rc::new(RefCell::new(vec![]));
+    let (spirv, _) = compile_shader_variant(&mut compiler, src_path, &shader, variant, includes.clone())?;
+
+    let mut includes = includes.replace(vec![]);
+    includes.sort();
+    includes.dedup();
+
+    Ok(HotShader {
+        spirv: spirv.chunks_exact(std::mem::size_of::<u32>())
+            .map(|word| u32::from_ne_bytes([word[0], word[1], word[2], word[3]]))
+            .collect(),
+        includes,
+    })
+}
+
+fn collect_shader_paths(dir: &Path, shader_paths: &mut Vec<PathBuf>) -> Result<()> {
     for entry in fs::read_dir(dir)? {
         let entry = entry?;
         let path = entry.path();
 
         if path.is_dir() {
-            process_shader_dir(src_path, top_shader_dir, &path)?;
+            collect_shader_paths(&path, shader_paths)?;
         } else {
-            compile_shader(src_path, top_shader_dir, &path)?;
+            shader_paths.push(path);
         }
     }
 
     Ok(())
 }
 
-fn compile_shader(src_path: &PathBuf, top_shader_dir: &Path, file_path: &Path) -> Result<()> {
-    let mut options = CompileOptions::new()
-        .ok_or(Error::Internal("shader compile options allocation failure".to_string()))?;
+/// Compiles the shaders on `NUM_JOBS` (set by cargo) workers with a compiler per worker.
+/// Returns the output of every shader, failed or not.
+fn compile_shaders(src_path: &PathBuf, shaders: Vec<ShaderSource>)
+    -> Result<Vec<(ShaderSource, ShaderCompileOutput)>>
+{
+    if shaders.is_empty() {
+        return Ok(vec![]);
+    }
+
+    let worker_count = env::var("NUM_JOBS").ok()
+        .and_then(|jobs| jobs.parse::<usize>().ok())
+        .unwrap_or(1)
+        .max(1)
+        .min(shaders.len());
+
+    let shaders = Arc::new(shaders);
+    let next_shader_idx = Arc::new(AtomicUsize::new(0));
+    let (output_sender, output_receiver) = mpsc::channel();
+
+    let workers = (0..worker_count)
+        .map(|_| {
+            let src_path = src_path.clone();
+            let shaders = shaders.clone();
+            let next_shader_idx = next_shader_idx.clone();
+            let output_sender = output_sender.clone();
+
+            thread::spawn(move || {
+                let mut compiler = Compiler::new();
+
+                loop {
+                    let shader_idx = next_shader_idx.fetch_add(1, Ordering::Relaxed);
+                    if shader_idx >= shaders.len() {
+                        break;
+                    }
+
+                    let output = match compiler.as_mut() {
+                        Some(compiler) => compile_shader(compiler, &src_path, &shaders[shader_idx]),
+                        None => Err(Error::Internal("shader compiler allocation failure".to_string())),
+                    };
+
+                    // The receiver outlives the workers
+                    let _ = output_sender.send((shader_idx, output));
+                }
+            })
+        })
+        .collect::<Vec<_>>();
+
+    drop(output_sender);
+
+    let mut outputs = (0..shaders.len()).map(|_| None).collect::<Vec<_>>();
+    for (shader_idx, output) in output_receiver {
+        outputs[shader_idx] = Some(output);
+    }
+
+    for worker in workers {
+        worker.join()
+            .map_err(|_| Error::Internal("shader compiler worker panicked".to_string()))?;
+    }
+
+    let shaders = Arc::try_unwrap(shaders)
+        .map_err(|_| Error::Internal("shader sources are still shared".to_string()))?;
+
+    Ok(
+        shaders.into_iter()
+            .zip(outputs)
+            .map(|(shader, output)| {
+                let output = output.unwrap_or_else(
+                    || Err(Error::Internal("the shader was not compiled".to_string()))
+                );
+
+                (shader, output)
+            })
+            .collect()
+    )
+}
+
+/// 64-bit FNV-1a: stable across the toolchains, unlike `DefaultHasher`
+struct ContentHasher(u64);
 
-    options.set_include_callback(include_callback(src_path));
+impl ContentHasher {
+    fn new() -> Self {
+        Self(0xcbf29ce484222325)
+    }
+
+    fn write(&mut self, bytes: &[u8]) {
+        // The length separates the adjacent fields
+        for byte in (bytes.len() as u64).to_le_bytes().iter().chain(bytes) {
+            self.0 ^= *byte as u64;
+            self.0 = self.0.wrapping_mul(0x100000001b3);
+        }
+    }
+
+    fn finish(&self) -> u64 {
+        self.0
+    }
+}
+
+struct ShaderCacheEntry {
+    hash: u64,
+
+    // Resolved by the include callback during the last compilation
+    includes: Vec<PathBuf>,
+
+    unoptimized_size: Option<usize>,
+    size: usize,
+}
+
+/// Shader source path -> the hash of everything its generated files depend on.
+/// Kept in `OUT_DIR`: a missing or unreadable cache only means a full rebuild.
+struct ShaderCache {
+    file_path: PathBuf,
+    entries: HashMap<PathBuf, ShaderCacheEntry>,
+    is_modified: bool,
+}
+
+impl ShaderCache {
+    fn load(dir: &Path) -> Result<Self> {
+        let file_path = dir.join(SHADER_CACHE_FILE_NAME);
+        let mut entries = HashMap::new();
+
+        // One shader per line: path, hash, SPIR-V sizes (`-` if not measured), includes (tab separated)
+        for line in fs::read_to_string(&file_path).unwrap_or_default().lines() {
+            let mut fields = line.split('\t');
+
+            let (path, hash, unoptimized_size, size) = match (
+                fields.next(),
+                fields.next().and_then(|hash| u64::from_str_radix(hash, 16).ok()),
+                fields.next().map(|size| size.parse().ok()),
+                fields.next().and_then(|size| size.parse().ok()),
+            ) {
+                (Some(path), Some(hash), Some(unoptimized_size), Some(size))
+                    => (path, hash, unoptimized_size, size),
+                _ => continue,
+            };
+
+            entries.insert(
+                PathBuf::from(path),
+                ShaderCacheEntry {
+                    hash,
+                    includes: fields.map(PathBuf::from).collect(),
+                    unoptimized_size,
+                    size,
+                }
+            );
+        }
+
+        Ok(Self {
+            file_path,
+            entries,
+            is_modified: false,
+        })
+    }
+
+    fn save(&self) -> Result<()> {
+        if !self.is_modified {
+            return Ok(());
+        }
+
+        let mut content = String::new();
+
+        for (path, entry) in &self.entries {
+            content.push_str(&path.to_string_lossy());
+            let unoptimized_size = entry.unoptimized_size
+                .map(|size| size.to_string())
+                .unwrap_or("-".to_string());
+
+            content.push_str(&format!("\t{:016x}\t{}\t{}", entry.hash, unoptimized_size, entry.size));
+
+            for include in &entry.includes {
+                content.push('\t');
+                content.push_str(&include.to_string_lossy());
+            }
+
+            content.push('\n');
+        }
+
+        fs::write(&self.file_path, content)?;
+
+        Ok(())
+    }
+
+    /// `None` if an include is gone: the shader must be compiled again
+    fn shader_hash(source_text: &str, options_fingerprint: &str, includes: &[PathBuf]) -> Option<u64> {
+        let mut hasher = ContentHasher::new();
+
+        hasher.write(&SHADER_GENERATOR_VERSION.to_le_bytes());
+        hasher.write(options_fingerprint.as_bytes());
+        hasher.write(source_text.as_bytes());
+
+        for include in includes {
+            hasher.write(include.to_string_lossy().as_bytes());
+            hasher.write(&fs::read(include).ok()?);
+        }
+
+        Some(hasher.finish())
+    }
+
+    fn is_fresh(&self, file_path: &Path, source_text: &str, options_fingerprint: &str) -> bool {
+        self.entries.get(file_path)
+            .and_then(|entry| {
+                Self::shader_hash(source_text, options_fingerprint, &entry.includes)
+                    .map(|hash| hash == entry.hash)
+            })
+            .unwrap_or(false)
+    }
+
+    fn includes(&self, file_path: &Path) -> &[PathBuf] {
+        self.entries.get(file_path)
+            .map(|entry| entry.includes.as_slice())
+            .unwrap_or(&[])
+    }
 
-    let source_language;
-    if let Some(ext) = file_path.extension() {
-        if ext == "glsl" {
-            source_language = shaderc::SourceLanguage::GLSL;
-        } else if ext == "hlsl" {
-            source_language = shaderc::SourceLanguage::HLSL;
+    fn insert(&mut self, file_path: &Path, compiled_shader: CompiledShader) {
+        self.entries.insert(
+            file_path.to_path_buf(),
+            ShaderCacheEntry {
+                hash: compiled_shader.hash,
+                includes: compiled_shader.includes,
+                unoptimized_size: compiled_shader.unoptimized_size,
+                size: compiled_shader.size,
+            }
+        );
+
+        self.is_modified = true;
+    }
+
+    /// The SPIR-V sizes of the current shaders, cached ones included.
+    /// Printed into the build script output (`cargo build -vv`) and `OUT_DIR/shader_sizes.txt`.
+    fn write_size_report(&self, dir: &Path, shader_paths: &[PathBuf], build_params: ShaderBuildParams) -> Result<()> {
+        let mut report = format!(
+            "optimization: {}, debug info: {}\n",
+            build_params.optimization_level_name,
+            build_params.is_debug_info
+        );
+
+        // The baseline total is reported only if every shader has it
+        let mut total_unoptimized_size = Some(0);
+        let mut total_size = 0;
+
+        let format_sizes = |unoptimized_size: Option<usize>, size: usize| match unoptimized_size {
+            Some(unoptimized_size) => format!("{} -> {} bytes", unoptimized_size, size),
+            None => format!("{} bytes", size),
+        };
+
+        for path in shader_paths {
+            if let Some(entry) = self.entries.get(path) {
+                report.push_str(
+                    &format!(
+                        "{}: {}\n",
+                        path.display(),
+                        format_sizes(entry.unoptimized_size, entry.size)
+                    )
+                );
+
+                total_unoptimized_size = total_unoptimized_size
+                    .zip(entry.unoptimized_size)
+                    .map(|(total, size)| total + size);
+                total_size += entry.size;
+            }
+        }
+
+        report.push_str(&format!("total: {}\n", format_sizes(total_unoptimized_size, total_size)));
+
+        for line in report.lines() {
+            println!("shader size report: {}", line);
+        }
+
+        write_if_changed(&dir.join(SHADER_SIZE_REPORT_FILE_NAME), &report)
+    }
+}
+
+/// Keeps the mtime of an unchanged file, so nothing depending on it is rebuilt
+fn write_if_changed<C: AsRef<[u8]>>(path: &Path, content: C) -> Result<()> {
+    let content = content.as_ref();
+
+    if let Ok(old_content) = fs::read(path) {
+        if old_content == content {
+            return Ok(());
+        }
+    }
+
+    fs::write(path, content)?;
+
+    Ok(())
+}
+
+/// Everything about a shader known without compiling it
+struct ShaderSource {
+    file_path: PathBuf,
+    file_name: String,
+    source_language_name: &'static str,
+    macros: Vec<(String, Option<String>)>,
+    build_params: ShaderBuildParams,
+
+    // Everything above changing the SPIR-V
+    options_fingerprint: String,
+
+    text: String,
+
+    // The variant bit of an axis is its index
+    variant_axes: Vec<String>,
+
+    // The text without the variant pragmas (blank lines keep the line numbers)
+    compile_text: String,
+
+    ffi_dir: PathBuf,
+    ffi_header: PathBuf,
+    ffi_src: PathBuf,
+    ffi_pack_header: PathBuf,
+
+    // The SPIR-V file path without the variant and the extension
+    spv_base: PathBuf,
+}
+
+impl ShaderSource {
+    fn new(
+        src_path: &PathBuf,
+        top_shader_dir: &Path,
+        out_dir: &Path,
+        file_path: &Path,
+        build_params: ShaderBuildParams
+    ) -> Result<Self> {
+        let source_language_name;
+        if let Some(ext) = file_path.extension() {
+            if ext == "glsl" {
+                source_language_name = "glsl";
+            } else if ext == "hlsl" {
+                source_language_name = "hlsl";
+            } else {
+                return Err(
+                    Error::ShaderFile(
+                        format!(
+                            "the shader {} has unknown extension {}",
+                            file_path.display(), ext.to_string_lossy()
+                        )
+                    )
+                )
+            }
         } else {
             return Err(
                 Error::ShaderFile(
                     format!(
-                        "the shader {} has unknown extension {}",
-                        file_path.display(), ext.to_string_lossy()
+                        "the shader {} has no extension",
+                        file_path.display()
                     )
                 )
             )
         }
-    } else {
-        return Err(
-            Error::ShaderFile(
-                format!(
-                    "the shader {} has no extension",
-                    file_path.display()
+
+        let macros = vec![("___gpu___".to_string(), None)];
+
+        let options_fingerprint = format!(
+            "language={};entry_point={};macros={:?};build={:?}",
+            source_language_name,
+            SHADER_ENTRY_POINT_NAME,
+            macros,
+            build_params
+        );
+
+        let text = fs::read_to_string(file_path)?;
+        let (variant_axes, compile_text) = Self::parse_variant_axes(file_path, &text)?;
+
+        let file_name = file_path
+            .file_stem()
+            .expect("shader file name")
+            .to_str()
+            .expect("shader file name str")
+            .to_string();
+
+        let parent_dir = file_path.parent()
+            .ok_or(Error::ShaderFile("unable to get shader parent dir".into()))?;
+
+        let shader_relative_path  = diff_paths(
+            parent_dir,
+            top_shader_dir
+        ).ok_or(Error::ShaderFile("unable to get shader relative path".into()))?;
+
+        let generated_dir = src_path
+            .join(FOREIGN_FN_IFACE_DIR_NAME)
+            .join(GENERATED_FILE_DIR);
+
+        let ffi_dir = generated_dir.join(&shader_relative_path);
+        let ffi_pack_header = generated_dir.join(format!("{}.h", SHADER_PACK_NAME));
+
+        let spv_base = out_dir
+            .join(SHADER_SPIRV_DIR_NAME)
+            .join(&shader_relative_path)
+            .join(&file_name);
+
+        let ffi_base = ffi_dir.join(&file_name);
+
+        let mut ffi_header = ffi_base.clone();
+        ffi_header.set_extension("h");
+
+        let mut ffi_src = ffi_base.clone();
+        ffi_src.set_extension("c");
+
+        Ok(Self {
+            file_path: file_path.to_path_buf(),
+            file_name,
+            source_language_name,
+            macros,
+            build_params,
+            options_fingerprint,
+            text,
+            variant_axes,
+            compile_text,
+            ffi_dir,
+            ffi_header,
+            ffi_src,
+            ffi_pack_header,
+            spv_base,
+        })
+    }
+
+    fn parse_variant_axes(file_path: &Path, text: &str) -> Result<(Vec<String>, String)> {
+        let mut variant_axes: Vec<String> = vec![];
+        let mut compile_text = String::with_capacity(text.len());
+
+        for line in text.lines() {
+            match line.trim_start().strip_prefix(SHADER_VARIANT_PRAGMA) {
+                Some(axis) if axis.is_empty() || axis.starts_with(char::is_whitespace) => {
+                    let axis = axis.trim();
+
+                    let is_identifier = axis.starts_with(|c: char| c.is_ascii_alphabetic() || c == '_')
+                        && axis.chars().all(|c| c.is_ascii_alphanumeric() || c == '_');
+
+                    if !is_identifier {
+                        return Err(
+                            Error::ShaderFile(
+                                format!(
+                                    "the shader {} has invalid variant axis \"{}\"",
+                                    file_path.display(), axis
+                                )
+                            )
+                        );
+                    }
+
+                    if variant_axes.iter().any(|known_axis| known_axis == axis) {
+                        return Err(
+                            Error::ShaderFile(
+                                format!(
+                                    "the shader {} has duplicate variant axis {}",
+                                    file_path.display(), axis
+                                )
+                            )
+                        );
+                    }
+
+                    variant_axes.push(axis.to_string());
+                },
+                _ => compile_text.push_str(line),
+            }
+
+            compile_text.push('\n');
+        }
+
+        if variant_axes.len() > SHADER_MAX_VARIANT_AXES {
+            return Err(
+                Error::ShaderFile(
+                    format!(
+                        "the shader {} has {} variant axes (max {})",
+                        file_path.display(), variant_axes.len(), SHADER_MAX_VARIANT_AXES
+                    )
                 )
-            )
-        )
+            );
+        }
+
+        Ok((variant_axes, compile_text))
     }
 
+    fn variant_count(&self) -> u32 {
+        1 << self.variant_axes.len()
+    }
+
+    fn spv_path(&self, variant: u32) -> PathBuf {
+        let mut path = self.spv_base.clone().into_os_string();
+
+        if !self.variant_axes.is_empty() {
+            path.push(format!(".{}", variant));
+        }
+
+        path.push(".spv");
+        path.into()
+    }
+
+    fn is_fresh(&self, cache: &ShaderCache) -> bool {
+        let is_fresh = self.ffi_header.is_file()
+            && self.ffi_src.is_file()
+            && (0..self.variant_count()).all(|variant| self.spv_path(variant).is_file())
+            && cache.is_fresh(&self.file_path, &self.text, &self.options_fingerprint);
+
+        if is_fresh {
+            for include in cache.includes(&self.file_path) {
+                println!("cargo:rerun-if-changed={}", include.display());
+            }
+        }
+
+        is_fresh
+    }
+}
+
+fn shader_compile_options(
+    src_path: &PathBuf,
+    shader: &ShaderSource,
+    variant: u32,
+    includes: Rc<RefCell<Vec<PathBuf>>>,
+    optimization_level: Option<shaderc::OptimizationLevel>,
+    is_debug_info: bool
+) -> Result<CompileOptions<'static>> {
+    let mut options = CompileOptions::new()
+        .ok_or(Error::Internal("shader compile options allocation failure".to_string()))?;
+
+    options.set_include_callback(include_callback(src_path, includes));
+
+    let source_language = match shader.source_language_name {
+        "glsl" => shaderc::SourceLanguage::GLSL,
+        _ => shaderc::SourceLanguage::HLSL,
+    };
+
     options.set_source_language(source_language);
-    options.add_macro_definition("___gpu___", None);
-    // TODO options.set_optimization_level(level)
+    for (name, value) in &shader.macros {
+        options.add_macro_definition(name, value.as_deref());
+    }
 
-    let source_text = fs::read_to_string(file_path)?;
-    let shader_kind = shaderc::ShaderKind::InferFromSource;
-    let input_file_name = file_path.to_string_lossy();
-    let entry_point_name = "main";
+    // Every axis is defined as 0 or 1, so the shader can use `#if`
+    for (axis_idx, axis) in shader.variant_axes.iter().enumerate() {
+        let value = if variant & (1 << axis_idx) != 0 { "1" } else { "0" };
+        options.add_macro_definition(axis, Some(value));
+    }
 
-    let mut compiler = Compiler::new()
-        .ok_or(Error::Internal("shader compiler allocation failure".to_string()))?;
+    // Without the debug info shaderc strips the debug and the name instructions
+    // when the optimization is enabled
+    if is_debug_info {
+        options.set_generate_debug_info();
+    }
+
+    if let Some(level) = optimization_level {
+        options.set_optimization_level(level);
+    }
+
+    Ok(options)
+}
+
+/// Compiles one variant, returns its SPIR-V and the size of its unoptimized SPIR-V (if measured)
+fn compile_shader_variant(
+    compiler: &mut Compiler,
+    src_path: &PathBuf,
+    shader: &ShaderSource,
+    variant: u32,
+    includes: Rc<RefCell<Vec<PathBuf>>>,
+) -> Result<(Vec<u8>, Option<usize>)> {
+    let optimization_level = shader.build_params.optimization_level();
+
+    let options = shader_compile_options(
+        src_path,
+        shader,
+        variant,
+        includes,
+        optimization_level,
+        shader.build_params.is_debug_info
+    )?;
+
+    let shader_kind = shaderc::ShaderKind::InferFromSource;
+    let input_file_name = shader.file_path.to_string_lossy();
 
     let spirv = compiler.compile_into_spirv(
-        &source_text,
+        &shader.compile_text,
         shader_kind,
         &input_file_name,
-        entry_point_name,
+        SHADER_ENTRY_POINT_NAME,
         Some(&options)
     )?;
 
-    let binary_spirv = spirv.as_binary();
-    let binary_spirv_code_size = binary_spirv.len() * std::mem::size_of_val(&binary_spirv[0]);
-    let file_name = file_path
-        .file_stem()
-        .expect("shader file name")
-        .to_str()
-        .expect("shader file name str");
+    // The baseline for the size report, compiled only on request
+    // and only when there is something to compare with
+    let unoptimized_size = match optimization_level {
+        Some(_) if !shader.build_params.is_size_baseline => None,
+        Some(_) => {
+            let unoptimized_options = shader_compile_options(
+                src_path,
+                shader,
+                variant,
+                Rc::new(RefCell::new(vec![])),
+                None,
+                false
+            )?;
 
-    let parent_dir = file_path.parent()
-        .ok_or(Error::ShaderFile("unable to get shader parent dir".into()))?;
+            let unoptimized_spirv = compiler.compile_into_spirv(
+                &shader.compile_text,
+                shader_kind,
+                &input_file_name,
+                SHADER_ENTRY_POINT_NAME,
+                Some(&unoptimized_options)
+            )?;
 
-    let shader_relative_path  = diff_paths(
-        parent_dir,
-        top_shader_dir
-    ).ok_or(Error::ShaderFile("unable to get shader relative path".into()))?;
+            Some(unoptimized_spirv.as_binary_u8().len())
+        },
+        None => Some(spirv.as_binary_u8().len()),
+    };
 
-    let shader_ffi_dir = src_path
-        .join(FOREIGN_FN_IFACE_DIR_NAME)
-        .join(GENERATED_FILE_DIR)
-        .join(shader_relative_path);
+    Ok((spirv.as_binary_u8().to_vec(), unoptimized_size))
+}
+
+/// Writes the SPIR-V of every variant into `OUT_DIR`, the shader pack is made of them
+fn compile_shader(compiler: &mut Compiler, src_path: &PathBuf, shader: &ShaderSource) -> ShaderCompileOutput {
+    let includes = Rc::new(RefCell::new(vec![]));
+
+    let mut size = 0;
+    let mut unoptimized_size = Some(0);
+
+    if let Some(spv_dir) = shader.spv_base.parent() {
+        fs::create_dir_all(spv_dir)?;
+    }
+
+    for variant in 0..shader.variant_count() {
+        let (spirv, variant_unoptimized_size) = compile_shader_variant(
+            compiler,
+            src_path,
+            shader,
+            variant,
+            includes.clone()
+        )?;
+
+        write_if_changed(&shader.spv_path(variant), &spirv)?;
+
+        size += spirv.len();
+        unoptimized_size = unoptimized_size
+            .zip(variant_unoptimized_size)
+            .map(|(total, variant_size)| total + variant_size);
+    }
+
+    let mut includes = includes.replace(vec![]);
+    includes.sort();
+    includes.dedup();
+
+    for include in &includes {
+        println!("cargo:rerun-if-changed={}", include.display());
+    }
+
+    let hash = ShaderCache::shader_hash(&shader.text, &shader.options_fingerprint, &includes)
+        .ok_or(Error::ShaderFile(format!("{}: an include is unreadable", shader.file_path.display())))?;
+
+    Ok(CompiledShader {
+        hash,
+        includes,
+        unoptimized_size,
+        size,
+    })
+}
+
+/// Packs the SPIR-V of all the shaders into one blob and generates its index:
+/// the `.h`/`.c` of every shader refer to their ranges of the pack.
+///
+/// The pack is embedded by the assembler (`.incbin`), so the C compiler doesn't parse
+/// the SPIR-V as text. MSVC has no `.incbin`: the pack is a byte array there.
+fn write_shader_pack(src_path: &PathBuf, out_dir: &Path, shaders: &[ShaderSource]) -> Result<()> {
+    let mut pack = vec![];
+
+    for shader in shaders {
+        let mut variant_ranges = vec![];
+
+        for variant in 0..shader.variant_count() {
+            let spirv = fs::read(shader.spv_path(variant))?;
 
-    let shader_ffi_base = shader_ffi_dir.join(file_name);
+            // SPIR-V is made of words: every range stays aligned
+            variant_ranges.push((pack.len(), spirv.len()));
+            pack.extend_from_slice(&spirv);
+        }
 
-    if !shader_ffi_dir.exists() {
-        fs::create_dir_all(shader_ffi_dir)?;
+        write_shader_ffi(shader, &variant_ranges)?;
     }
 
-    let mut shader_ffi_header = shader_ffi_base.clone();
-    shader_ffi_header.set_extension("h");
+    let pack_path = out_dir.join(SHADER_PACK_FILE_NAME);
+    write_if_changed(&pack_path, &pack)?;
+
+    let generated_dir = src_path
+        .join(FOREIGN_FN_IFACE_DIR_NAME)
+        .join(GENERATED_FILE_DIR);
+
+    fs::create_dir_all(&generated_dir)?;
+
+    let pack_header = generated_dir.join(format!("{}.h", SHADER_PACK_NAME));
+    let pack_src = generated_dir.join(format!("{}.c", SHADER_PACK_NAME));
+
+    let do_not_modify_comment = r#"// This file generated automatically.
+// DO NOT MODIFY IT MANUALLY!"#;
+
+    let pack_header_content = format! {
+r#"{do_not_modify_comment}
+
+#ifndef ___FFI_SHADER_PACK_H___
+#define ___FFI_SHADER_PACK_H___
+
+#include <stdint.h>
+
+// The SPIR-V of all the shaders, {pack_size} bytes aligned to 16
+extern const uint8_t {pack_symbol}[];
+
+#define SHADER_PACK_CODE(offset) ((uint32_t *)({pack_symbol} + (offset)))
+
+#endif // ___FFI_SHADER_PACK_H___"#,
+    do_not_modify_comment = do_not_modify_comment,
+    pack_size = pack.len(),
+    pack_symbol = SHADER_PACK_SYMBOL
+};
 
-    println!("cargo:rerun-if-changed={}", shader_ffi_header.display());
+    let pack_src_content = if cfg!(target_os = "windows") {
+        let pack_hex = pack.chunks(16)
+            .map(|line| line.iter()
+                .map(|byte| format!("{:#04X}", byte))
+                .collect::<Vec<_>>()
+                .join(", ")
+            )
+            .collect::<Vec<_>>()
+            .join(",\n    ");
+
+        format! {
+r#"{do_not_modify_comment}
+
+#include "{header_file_path}"
+
+__declspec(align(16)) const uint8_t {pack_symbol}[] = {{
+    {pack_hex}
+}};
+"#,
+    do_not_modify_comment = do_not_modify_comment,
+    header_file_path = pack_header.display(),
+    pack_symbol = SHADER_PACK_SYMBOL,
+    // An empty array is not valid C
+    pack_hex = if pack.is_empty() { "0".to_string() } else { pack_hex }
+}
+    } else {
+        format! {
+r#"{do_not_modify_comment}
+
+#include "{header_file_path}"
+
+#ifdef __APPLE__
+#   define SHADER_PACK_SECTION_BEGIN ".const_data\n"
+#   define SHADER_PACK_SECTION_END ".text\n"
+#   define SHADER_PACK_SYMBOL "_{pack_symbol}"
+#else
+#   define SHADER_PACK_SECTION_BEGIN ".pushsection .rodata, \"a\"\n"
+#   define SHADER_PACK_SECTION_END ".popsection\n"
+#   define SHADER_PACK_SYMBOL "{pack_symbol}"
+#endif // __APPLE__
+
+__asm__(
+    SHADER_PACK_SECTION_BEGIN
+    ".balign 16\n"
+    ".globl " SHADER_PACK_SYMBOL "\n"
+    SHADER_PACK_SYMBOL ":\n"
+    ".incbin \"{pack_path}\"\n"
+    SHADER_PACK_SECTION_END
+);
+"#,
+    do_not_modify_comment = do_not_modify_comment,
+    header_file_path = pack_header.display(),
+    pack_symbol = SHADER_PACK_SYMBOL,
+    pack_path = pack_path.display().to_string().replace('\\', "/")
+}
+    };
+
+    write_if_changed(&pack_header, &pack_header_content)?;
+    write_if_changed(&pack_src, &pack_src_content)?;
+
+    Ok(())
+}
+
+/// `variant_ranges` are the offsets and the sizes of the variants in the shader pack
+fn write_shader_ffi(shader: &ShaderSource, variant_ranges: &[(usize, usize)]) -> Result<()> {
+    let file_path = &shader.file_path;
+    let file_name = &shader.file_name;
+    let shader_ffi_header = &shader.ffi_header;
+    let shader_ffi_src = &shader.ffi_src;
+
+    if !shader.ffi_dir.exists() {
+        fs::create_dir_all(&shader.ffi_dir)?;
+    }
 
     let do_not_modify_comment = format! {
 r#"// This file generated automatically.
@@ -156,20 +1068,23 @@ r#"// This file generated automatically.
     );
 
     let shader_snake_name = file_name.to_case(Case::Snake);
-    let shader_fn_decl = format!("uint32_t *{}()", shader_snake_name);
-    let shader_code_size_fn_decl = format!("size_t {}_code_size()", shader_snake_name);
 
-    let spirv_binary_hex = binary_spirv.iter()
-        .map(|word| format!("{:#010X}", word))
-        .collect::<Vec<_>>()
-        .join(",\n\t\t");
+    let pack_header = shader.ffi_pack_header.display();
+
+    let (shader_ffi_header_content, shader_ffi_src_content);
+    if shader.variant_axes.is_empty() {
+        let (offset, size) = variant_ranges[0];
+
+        let shader_fn_decl = format!("uint32_t *{}()", shader_snake_name);
+        let shader_code_size_fn_decl = format!("size_t {}_code_size()", shader_snake_name);
 
-    let shader_ffi_header_content = format! {
+        shader_ffi_header_content = format! {
 r#"{do_not_modify_comment}
 
 #ifndef {header_guard}
 #define {header_guard}
 
+#include <stddef.h>
 #include <stdint.h>
 
 {shader_fn_decl};
@@ -183,17 +1098,14 @@ r#"{do_not_modify_comment}
     shader_code_size_fn_decl = shader_code_size_fn_decl,
 };
 
-    let shader_ffi_src_content = format! {
+        shader_ffi_src_content = format! {
 r#"{do_not_modify_comment}
 
 #include "{header_file_path}"
+#include "{pack_header_file_path}"
 
 {shader_fn_decl} {{
-    static uint32_t shader_src[] = {{
-        {spirv_binary}
-    }};
-
-    return shader_src;
+    return SHADER_PACK_CODE({shader_offset}ULL);
 }}
 
 {shader_code_size_fn_decl} {{
@@ -202,38 +1114,111 @@ r#"{do_not_modify_comment}
 "#,
     do_not_modify_comment = do_not_modify_comment,
     header_file_path = shader_ffi_header.display(),
+    pack_header_file_path = pack_header,
+    shader_fn_decl = shader_fn_decl,
+    shader_offset = offset,
+    shader_code_size_fn_decl = shader_code_size_fn_decl,
+    shader_code_size = size
+};
+    } else {
+        let variant_macro_prefix = format!("{}_VARIANT", file_name.to_case(Case::UpperSnake));
+        let variant_count = variant_ranges.len();
+
+        let variant_axis_defs = shader.variant_axes.iter()
+            .enumerate()
+            .map(|(axis_idx, axis)| format!("#define {}_{} (1u << {})", variant_macro_prefix, axis, axis_idx))
+            .collect::<Vec<_>>()
+            .join("\n");
+
+        let shader_fn_decl = format!("uint32_t *{}(uint32_t variant)", shader_snake_name);
+        let shader_code_size_fn_decl = format!("size_t {}_code_size(uint32_t variant)", shader_snake_name);
+
+        shader_ffi_header_content = format! {
+r#"{do_not_modify_comment}
+
+#ifndef {header_guard}
+#define {header_guard}
+
+#include <stddef.h>
+#include <stdint.h>
+
+// `variant` is a bitmask of the axes below
+{variant_axis_defs}
+#define {variant_macro_prefix}_COUNT {variant_count}u
+
+// NULL if the variant is out of range
+{shader_fn_decl};
+
+// 0 if the variant is out of range
+{shader_code_size_fn_decl};
+
+#endif // {header_guard}"#,
+    do_not_modify_comment = do_not_modify_comment,
+    header_guard = header_guard,
+    variant_axis_defs = variant_axis_defs,
+    variant_macro_prefix = variant_macro_prefix,
+    variant_count = variant_count,
     shader_fn_decl = shader_fn_decl,
-    spirv_binary = spirv_binary_hex,
     shader_code_size_fn_decl = shader_code_size_fn_decl,
-    shader_code_size = binary_spirv_code_size
 };
 
-    let mut out = fs::OpenOptions::new()
-        .create(true)
-        .write(true)
-        .truncate(true)
-        .open(shader_ffi_header.clone())?;
+        let variant_offset_table = variant_ranges.iter()
+            .map(|(offset, _)| format!("{}ULL", offset))
+            .collect::<Vec<_>>()
+            .join(",\n    ");
+
+        let variant_code_size_table = variant_ranges.iter()
+            .map(|(_, size)| format!("{}ULL", size))
+            .collect::<Vec<_>>()
+            .join(",\n    ");
 
-    out.write_all(shader_ffi_header_content.as_bytes())?;
+        shader_ffi_src_content = format! {
+r#"{do_not_modify_comment}
 
-    // Impl
-    let mut shader_ffi_src = shader_ffi_base.clone();
-    shader_ffi_src.set_extension("c");
+#include "{header_file_path}"
+#include "{pack_header_file_path}"
 
-    println!("cargo:rerun-if-changed={}", shader_ffi_src.display());
+// The shader pack ranges indexed by the variant bitmask
+static const size_t shader_offsets[] = {{
+    {variant_offset_table}
+}};
 
-    let mut out = fs::OpenOptions::new()
-        .create(true)
-        .write(true)
-        .truncate(true)
-        .open(shader_ffi_src)?;
+static const size_t shader_code_sizes[] = {{
+    {variant_code_size_table}
+}};
 
-    out.write_all(shader_ffi_src_content.as_bytes())?;
+{shader_fn_decl} {{
+    if (variant >= {variant_macro_prefix}_COUNT)
+        return NULL;
+
+    return SHADER_PACK_CODE(shader_offsets[variant]);
+}}
+
+{shader_code_size_fn_decl} {{
+    if (variant >= {variant_macro_prefix}_COUNT)
+        return 0;
+
+    return shader_code_sizes[variant];
+}}
+"#,
+    do_not_modify_comment = do_not_modify_comment,
+    header_file_path = shader_ffi_header.display(),
+    pack_header_file_path = pack_header,
+    variant_offset_table = variant_offset_table,
+    variant_code_size_table = variant_code_size_table,
+    variant_macro_prefix = variant_macro_prefix,
+    shader_fn_decl = shader_fn_decl,
+    shader_code_size_fn_decl = shader_code_size_fn_decl,
+};
+    }
+
+    write_if_changed(shader_ffi_header, &shader_ffi_header_content)?;
+    write_if_changed(shader_ffi_src, &shader_ffi_src_content)?;
 
     Ok(())
 }
 
-fn include_callback(src_path: &PathBuf)
+fn include_callback(src_path: &PathBuf, includes: Rc<RefCell<Vec<PathBuf>>>)
     -> impl Fn(&str, IncludeType, &str, usize) -> IncludeCallbackResult
 {
     let src_path = src_path.clone();
@@ -265,9 +1250,11 @@ fn include_callback(src_path: &PathBuf)
             }
         }
 
-        let header_content = fs::read_to_string(header_path)
+        let header_content = fs::read_to_string(&header_path)
             .map_err(|err| err.to_string())?;
 
+        includes.borrow_mut().push(header_path);
+
         let resolved_include = ResolvedInclude {
             resolved_name: standard_path.to_string_lossy().to_string(),
             content: header_content
@@ -1,7 +1,7 @@
 use {
     std::{
         env,
-        path::Path
+        path::{Path, PathBuf}
     },
     infra::{self, project_build}
 };
@@ -10,17 +10,31 @@ fn main() -> infra::Result<()> {
     let project_path = Path::new(env!("CARGO_MANIFEST_DIR"));
     let src_path = project_path.join("src");
 
-    let vulkan_sdk = env::var("VULKAN_SDK")?;
-    let vulkan_sdk = Path::new(&vulkan_sdk);
-
-    let include_dirs = vec![
-        src_path.clone(),
-        vulkan_sdk.join("Include")
+    let mut include_dirs = vec![
+        src_path.clone()
     ];
 
-    let libraries = vec![
-        vulkan_sdk.join("Lib").join("vulkan-1")
-    ];
+    let mut libraries = vec![];
+
+    if cfg!(target_os = "linux") {
+        // Vulkan SDK is optional on Linux:
+        // the headers and the loader are usually installed system-wide.
+        match env::var("VULKAN_SDK") {
+            Ok(vulkan_sdk) => {
+                let vulkan_sdk = Path::new(&vulkan_sdk);
+
+                include_dirs.push(vulkan_sdk.join("include"));
+                libraries.push(vulkan_sdk.join("lib").join("vulkan"));
+            },
+            Err(_) => libraries.push(PathBuf::from("vulkan"))
+        }
+    } else {
+        let vulkan_sdk = env::var("VULKAN_SDK")?;
+        let vulkan_sdk = Path::new(&vulkan_sdk);
+
+        include_dirs.push(vulkan_sdk.join("Include"));
+        libraries.push(vulkan_sdk.join("Lib").join("vulkan-1"));
+    }
 
     project_build(src_path, include_dirs, libraries)?;
 
@@ -1,47 +1,77 @@
 use {
-    std::ffi::{c_void, CStr},
+    std::{
+        ffi::{c_void, CStr, CString},
+        path::Path,
+    },
     libc::c_char,
     log::{log, error},
-    printf::printf
+    printf::printf,
+    crate::ffi,
+    super::Result,
 };
 
 const LOG_TARGET: &'static str = "apriori-log";
 
-#[no_mangle]
-extern "C" fn ffi_log(level: *const c_char, target: *const c_char, format: *const c_char, args: *mut c_void) {
-    macro_rules! as_str {
-        ($str:expr) => {
-            unsafe {
-                match CStr::from_ptr($str).to_str() {
-                    Ok(value) => value,
-                    Err(err) => {
-                        error! {
-                            target: LOG_TARGET,
-                            "FFI log error while converting \"{}\" to &str -- {}",
-                            stringify![$str],
-                            err
-                        };
-
-                        return;
-                    }
+macro_rules! as_str {
+    ($str:expr) => {
+        unsafe {
+            match CStr::from_ptr($str).to_str() {
+                Ok(value) => value,
+                Err(err) => {
+                    error! {
+                        target: LOG_TARGET,
+                        "FFI log error while converting \"{}\" to &str -- {}",
+                        stringify![$str],
+                        err
+                    };
+
+                    return;
                 }
             }
-        };
+        }
+    };
+}
+
+// The values of the C `LogLevel` enum
+fn ffi_level(level: u32) -> Option<log::Level> {
+    match level {
+        1 => Some(log::Level::Error),
+        2 => Some(log::Level::Warn),
+        3 => Some(log::Level::Info),
+        4 => Some(log::Level::Debug),
+        5 => Some(log::Level::Trace),
+        _ => None,
     }
+}
 
-    let level: log::Level = match as_str![level].parse() {
-        Ok(lvl) => lvl,
-        Err(err) => {
+macro_rules! unwrap_level {
+    ($level:expr) => {
+        match ffi_level($level) {
+            Some(level) => level,
+            None => {
                 error! {
-                target: LOG_TARGET,
-                "FFI log error while parsing log level -- {}",
-                err
-            };
+                    target: LOG_TARGET,
+                    "FFI log error: unknown log level {}",
+                    $level
+                };
 
-            return;
+                return;
+            }
         }
     };
+}
+
+/// Called by the C log macros before anything is formatted
+#[no_mangle]
+extern "C" fn ffi_log_enabled(level: u32) -> bool {
+    ffi_level(level)
+        .map(|level| level <= log::max_level())
+        .unwrap_or(false)
+}
 
+#[no_mangle]
+extern "C" fn ffi_log(level: u32, target: *const c_char, format: *const c_char, args: *mut c_void) {
+    let level = unwrap_level![level];
     let target = as_str![target];
 
     let message = unsafe {
@@ -54,3 +84,82 @@ extern "C" fn ffi_log(level: *const c_char, target: *const c_char, format: *cons
         "{}", message
     };
 }
+
+/// The async log thread writes the messages formatted by the logging threads
+#[no_mangle]
+extern "C" fn ffi_log_message(level: u32, target: *const c_char, message: *const c_char) {
+    let level = unwrap_level![level];
+    let target = as_str![target];
+    let message = unsafe { CStr::from_ptr(message) }.to_string_lossy();
+
+    log! {
+        target: target,
+        level,
+        "{}", message
+    };
+}
+
+/// Moves the FFI log output to a background thread,
+/// so the render thread never waits for the logger I/O.
+/// The messages are truncated to 512 bytes and dropped if the queue is full.
+pub fn start_async_ffi_log() -> Result<()> {
+    unsafe {
+        ffi::start_async_log().try_unwrap::<()>()?;
+    }
+
+    Ok(())
+}
+
+/// Writes the queued FFI messages and returns to the synchronous logging
+pub fn stop_async_ffi_log() {
+    unsafe {
+        ffi::stop_async_log();
+    }
+}
+
+/// The FFI messages lost because the async log queue was full
+pub fn async_ffi_log_dropped_count() -> u32 {
+    unsafe {
+        ffi::async_log_dropped_count()
+    }
+}
+
+/// Records the FFI messages up to `level` into per-thread binary buffers:
+/// only the raw arguments are copied, the text is formatted by `decode_binary_log`.
+/// Independent of the `log` max level, so trace messages can be kept
+/// (including the trace and debug messages of the release builds). `None` disables it.
+pub fn set_binary_log_level(level: Option<log::Level>) {
+    unsafe {
+        ffi::set_binary_log_max_level(level.map(|level| level as u32).unwrap_or(0));
+    }
+}
+
+/// Moves the recorded binary messages into a dump file
+pub fn dump_binary_log<P: AsRef<Path>>(path: P) -> Result<()> {
+    let path = CString::new(path.as_ref().to_string_lossy().as_bytes())?;
+
+    unsafe {
+        ffi::dump_binary_log(path.as_ptr()).try_unwrap::<()>()?;
+    }
+
+    Ok(())
+}
+
+/// Formats a binary log dump into text lines ordered by time
+pub fn decode_binary_log<P: AsRef<Path>, T: AsRef<Path>>(dump_path: P, text_path: T) -> Result<()> {
+    let dump_path = CString::new(dump_path.as_ref().to_string_lossy().as_bytes())?;
+    let text_path = CString::new(text_path.as_ref().to_string_lossy().as_bytes())?;
+
+    unsafe {
+        ffi::decode_binary_log(dump_path.as_ptr(), text_path.as_ptr()).try_unwrap::<()>()?;
+    }
+
+    Ok(())
+}
+
+/// The binary messages lost because a thread buffer was full
+pub fn binary_log_dropped_count() -> u32 {
+    unsafe {
+        ffi::binary_log_dropped_count()
+    }
+}
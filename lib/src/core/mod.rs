@@ -1,11 +1,12 @@
 pub mod vulkan_instance;
 pub mod log;
+pub mod profiler;
 
 use {
     std::{
         fmt,
         sync::PoisonError,
-        ffi::CStr,
+        ffi::{CStr, NulError},
         os::raw::c_char,
     },
     crate::{ffi, io},
@@ -22,6 +23,7 @@ pub enum Error {
     Sync(String),
     Serialization(String),
     Io(std::io::Error),
+    Nul(NulError),
 }
 
 impl From<std::str::Utf8Error> for Error {
@@ -36,6 +38,12 @@ impl From<std::io::Error> for Error {
     }
 }
 
+impl From<NulError> for Error {
+    fn from(err: NulError) -> Self {
+        Self::Nul(err)
+    }
+}
+
 impl From<ron::error::Error> for Error {
     fn from(err: ron::error::Error) -> Self {
         Self::Serialization(err.to_string())
@@ -60,6 +68,7 @@ impl fmt::Display for Error {
             Self::Sync(err) => write!(f, "{}", err),
             Self::Serialization(err) => write!(f, "{}", err),
             Self::Io(err) => write!(f, "(io error) {}", err),
+            Self::Nul(err) => write!(f, "{}", err),
         }
     }
 }
@@ -0,0 +1,147 @@
+use {
+    std::{
+        fs::File,
+        io::{BufWriter, Write},
+        ffi::CStr,
+        marker::PhantomData,
+        os::raw::c_char,
+        path::Path,
+    },
+    crate::ffi,
+    super::Result,
+};
+
+const DRAIN_CHUNK_SIZE: usize = 4096;
+
+/// Opens a CPU profiler zone ending when the returned guard is dropped:
+/// `let _zone = profile_zone!("draw_frame");`
+/// (binding it to `_` would end the zone at once).
+#[macro_export]
+macro_rules! profile_zone {
+    ($name:literal) => {
+        $crate::core::profiler::ProfileZone::begin(concat!($name, "\0"))
+    };
+}
+
+/// The zones are recorded into a per-thread ring,
+/// so the guard must be dropped on the thread that created it.
+pub struct ProfileZone {
+    zone: u32,
+    _not_send: PhantomData<*const ()>,
+}
+
+impl ProfileZone {
+    /// Use `profile_zone!`: `name` must be nul-terminated
+    #[doc(hidden)]
+    pub fn begin(name: &'static str) -> Self {
+        debug_assert!(name.ends_with('\0'));
+
+        let zone;
+        unsafe {
+            zone = ffi::begin_cpu_zone(name.as_ptr() as *const c_char);
+        }
+
+        Self {
+            zone,
+            _not_send: PhantomData,
+        }
+    }
+}
+
+impl Drop for ProfileZone {
+    fn drop(&mut self) {
+        unsafe {
+            ffi::end_cpu_zone(self.zone);
+        }
+    }
+}
+
+/// The profiler is enabled from the start, so the startup zones are recorded
+pub fn set_enabled(is_enabled: bool) {
+    unsafe {
+        ffi::set_cpu_profiler_enabled(is_enabled);
+    }
+}
+
+/// The zones skipped because a thread ring was full between two exports
+pub fn dropped_zone_count() -> u32 {
+    unsafe {
+        ffi::cpu_profiler_dropped_zone_count()
+    }
+}
+
+/// Moves the zones recorded since the last export into a Chrome `trace_event` JSON file
+/// (viewable in `chrome://tracing` or Perfetto).
+pub fn export_chrome_trace<P: AsRef<Path>>(path: P) -> Result<()> {
+    let mut file = BufWriter::new(File::create(path)?);
+    let mut events = Vec::with_capacity(DRAIN_CHUNK_SIZE);
+    let pid = std::process::id();
+    let mut is_first = true;
+
+    write!(file, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[")?;
+
+    loop {
+        let drained_count;
+        unsafe {
+            drained_count = ffi::drain_cpu_zone_events(
+                events.as_mut_ptr(),
+                DRAIN_CHUNK_SIZE as u32
+            ) as usize;
+
+            events.set_len(drained_count);
+        }
+
+        for event in &events {
+            if !is_first {
+                write!(file, ",")?;
+            }
+            is_first = false;
+
+            write_trace_event(&mut file, event, pid)?;
+        }
+
+        if drained_count < DRAIN_CHUNK_SIZE {
+            break;
+        }
+    }
+
+    writeln!(file, "]}}")?;
+    file.flush()?;
+
+    Ok(())
+}
+
+fn write_trace_event(file: &mut impl Write, event: &ffi::CpuZoneEvent, pid: u32) -> Result<()> {
+    let ts_us = event.timestamp_ns / 1000;
+    let ts_ns_rem = event.timestamp_ns % 1000;
+
+    if event.name.is_null() {
+        write!(
+            file,
+            "{{\"ph\":\"E\",\"ts\":{}.{:03},\"pid\":{},\"tid\":{}}}",
+            ts_us, ts_ns_rem, pid, event.thread_idx
+        )?;
+    } else {
+        // The zone names are static C strings
+        let name = unsafe { CStr::from_ptr(event.name) }.to_string_lossy();
+
+        write!(file, "{{\"ph\":\"B\",\"name\":\"")?;
+
+        for c in name.chars() {
+            match c {
+                '"' => write!(file, "\\\"")?,
+                '\\' => write!(file, "\\\\")?,
+                c if c.is_control() => write!(file, "\\u{:04x}", c as u32)?,
+                c => write!(file, "{}", c)?,
+            }
+        }
+
+        write!(
+            file,
+            "\",\"ts\":{}.{:03},\"pid\":{},\"tid\":{}}}",
+            ts_us, ts_ns_rem, pid, event.thread_idx
+        )?;
+    }
+
+    Ok(())
+}
@@ -0,0 +1,217 @@
+#include <stdio.h>
+
+#include "async_log.impl.h"
+
+#include "ffi/util/mod.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(AsyncLog)
+
+#define ASYNC_LOG_RING_MASK (ASYNC_LOG_RING_CAPACITY - 1)
+
+static_assert(
+    IS_UINT32_POW_OF_2(ASYNC_LOG_RING_CAPACITY, uint32_t),
+    "the async log ring capacity must be a power of 2"
+);
+
+// This function is implemented in Rust, `message` is already formatted
+void ffi_log_message(LogLevel level, const char *target, const char *message);
+
+struct AsyncLog async_log = { 0 };
+
+bool is_async_log_empty(struct AsyncLog *ring) {
+    struct AsyncLogSlot *slot = &ring->slots[ring->dequeue_pos & ASYNC_LOG_RING_MASK];
+
+    return os_atomic_load_u32(&slot->sequence) != ring->dequeue_pos + 1;
+}
+
+bool pop_async_log_message(struct AsyncLog *ring) {
+    if (is_async_log_empty(ring))
+        return false;
+
+    struct AsyncLogSlot *slot = &ring->slots[ring->dequeue_pos & ASYNC_LOG_RING_MASK];
+
+    ffi_log_message(slot->level, slot->target, slot->message);
+
+    os_atomic_store_u32(&slot->sequence, ring->dequeue_pos + ASYNC_LOG_RING_CAPACITY);
+    ring->dequeue_pos += 1;
+
+    return true;
+}
+
+void report_async_log_drops(struct AsyncLog *ring) {
+    char message[ASYNC_LOG_MESSAGE_SIZE] = { 0 };
+    uint32_t dropped_count = os_atomic_load_u32(&ring->dropped_count);
+
+    if (dropped_count == ring->reported_dropped_count)
+        return;
+
+    snprintf(
+        message,
+        ASYNC_LOG_MESSAGE_SIZE,
+        "%d log messages dropped: the async log ring is full",
+        AS(dropped_count - ring->reported_dropped_count, int)
+    );
+
+    ffi_log_message(LOG_LEVEL_WARN, LOG_TARGET, message);
+
+    ring->reported_dropped_count = dropped_count;
+}
+
+void async_log_main(Handle arg) {
+    struct AsyncLog *ring = arg;
+
+    while (true) {
+        if (pop_async_log_message(ring))
+            continue;
+
+        report_async_log_drops(ring);
+
+        // The ring is drained before the thread exits
+        if (os_atomic_load_u32(&ring->is_stopping))
+            break;
+
+        lock_os_mutex(ring->mutex);
+
+        uint32_t is_waiting = false;
+        os_atomic_cas_u32(&ring->is_consumer_waiting, &is_waiting, true);
+
+        // A producer that missed the waiting flag has published its message before it
+        if (is_async_log_empty(ring) && !os_atomic_load_u32(&ring->is_stopping))
+            wait_os_cond(ring->cond, ring->mutex);
+
+        os_atomic_store_u32(&ring->is_consumer_waiting, false);
+
+        unlock_os_mutex(ring->mutex);
+    }
+}
+
+void wake_async_log(struct AsyncLog *ring) {
+    lock_os_mutex(ring->mutex);
+    broadcast_os_cond(ring->cond);
+    unlock_os_mutex(ring->mutex);
+}
+
+bool push_async_log_message(LogLevel level, const char *target, const char *format, va_list args) {
+    struct AsyncLog *ring = &async_log;
+    struct AsyncLogSlot *slot = NULL;
+    va_list slot_args;
+
+    // Registered before the running check: `stop_async_log` either sees the producer
+    // or the producer sees the stopped log (both are full barriers)
+    os_atomic_add_u32(&ring->producer_count, 1);
+
+    if (!os_atomic_load_u32(&ring->is_running)) {
+        os_atomic_add_u32(&ring->producer_count, UINT32_MAX);
+        return false;
+    }
+
+    uint32_t pos = os_atomic_load_u32(&ring->enqueue_pos);
+
+    while (true) {
+        slot = &ring->slots[pos & ASYNC_LOG_RING_MASK];
+
+        int32_t diff = AS(os_atomic_load_u32(&slot->sequence) - pos, int32_t);
+
+        if (diff == 0) {
+            // On failure `pos` is reloaded
+            if (os_atomic_cas_u32(&ring->enqueue_pos, &pos, pos + 1))
+                break;
+        } else if (diff < 0) {
+            // The consumer has not freed the slot yet: the ring is full
+            os_atomic_add_u32(&ring->dropped_count, 1);
+            os_atomic_add_u32(&ring->producer_count, UINT32_MAX);
+            return true;
+        } else {
+            pos = os_atomic_load_u32(&ring->enqueue_pos);
+        }
+    }
+
+    va_copy(slot_args, args);
+    vsnprintf(slot->message, ASYNC_LOG_MESSAGE_SIZE, format, slot_args);
+    va_end(slot_args);
+
+    slot->level = level;
+    slot->target = target;
+
+    os_atomic_store_u32(&slot->sequence, pos + 1);
+
+    if (os_atomic_add_u32(&ring->is_consumer_waiting, 0))
+        wake_async_log(ring);
+
+    os_atomic_add_u32(&ring->producer_count, UINT32_MAX);
+    return true;
+}
+
+Result start_async_log() {
+    Result result = { 0 };
+    struct AsyncLog *ring = &async_log;
+
+    if (os_atomic_load_u32(&ring->is_running))
+        goto exit;
+
+    ring->is_stopping = false;
+    ring->enqueue_pos = 0;
+    ring->dequeue_pos = 0;
+    ring->dropped_count = 0;
+    ring->reported_dropped_count = 0;
+    ring->is_consumer_waiting = false;
+
+    for (uint32_t i = 0; i < ASYNC_LOG_RING_CAPACITY; ++i)
+        ring->slots[i].sequence = i;
+
+    result = new_os_mutex();
+    RESULT_UNWRAP(ring->mutex, result);
+
+    result = new_os_cond();
+    RESULT_UNWRAP(ring->cond, result);
+
+    result = new_os_thread(async_log_main, ring);
+    RESULT_UNWRAP(ring->thread, result);
+
+    os_atomic_store_u32(&ring->is_running, true);
+
+    debug(LOG_TARGET, "async log started");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_os_cond(ring->cond);
+        drop_os_mutex(ring->mutex);
+
+        ring->cond = NULL;
+        ring->mutex = NULL;
+    });
+}
+
+void stop_async_log() {
+    struct AsyncLog *ring = &async_log;
+
+    uint32_t is_running = true;
+
+    // The new messages are written synchronously,
+    // the pushed ones are drained by the thread before it exits
+    if (!os_atomic_cas_u32(&ring->is_running, &is_running, false))
+        return;
+
+    // A producer may still be filling its slot or waking the thread up
+    while (os_atomic_load_u32(&ring->producer_count) != 0)
+        yield_os_thread();
+
+    os_atomic_store_u32(&ring->is_stopping, true);
+
+    wake_async_log(ring);
+    join_os_thread(ring->thread);
+
+    drop_os_cond(ring->cond);
+    drop_os_mutex(ring->mutex);
+
+    ring->thread = NULL;
+    ring->cond = NULL;
+    ring->mutex = NULL;
+
+    debug(LOG_TARGET, "async log stopped");
+}
+
+uint32_t async_log_dropped_count() {
+    return os_atomic_load_u32(&async_log.dropped_count);
+}
@@ -0,0 +1,54 @@
+#ifndef ___APRIORI2_CORE_ASYNC_LOG_IMPL_H___
+#define ___APRIORI2_CORE_ASYNC_LOG_IMPL_H___
+
+#include <stdarg.h>
+#include <stdbool.h>
+
+#include "mod.h"
+#include "ffi/core/log.h"
+#include "ffi/os/thread.h"
+
+#define ASYNC_LOG_RING_CAPACITY 1024
+#define ASYNC_LOG_MESSAGE_SIZE 512
+
+// A slot is free for the producer at `sequence == position`
+// and ready for the consumer at `sequence == position + 1`
+struct AsyncLogSlot {
+    volatile uint32_t sequence;
+
+    LogLevel level;
+    const char *target;
+
+    // Truncated to the slot size
+    char message[ASYNC_LOG_MESSAGE_SIZE];
+};
+
+// Bounded multi-producer ring, the background thread is the only consumer
+struct AsyncLog {
+    volatile uint32_t is_running;
+    volatile uint32_t is_stopping;
+
+    // The producers inside of `push_async_log_message`:
+    // the ring and its mutex are not torn down until they leave
+    volatile uint32_t producer_count;
+
+    volatile uint32_t enqueue_pos;
+    uint32_t dequeue_pos;
+
+    volatile uint32_t dropped_count;
+    uint32_t reported_dropped_count;
+
+    // The producers take the mutex only to wake up the sleeping consumer
+    volatile uint32_t is_consumer_waiting;
+    OsMutex mutex;
+    OsCond cond;
+
+    OsThread thread;
+
+    struct AsyncLogSlot slots[ASYNC_LOG_RING_CAPACITY];
+};
+
+// Returns false if the async log is not running: the message must be written synchronously
+bool push_async_log_message(LogLevel level, const char *target, const char *format, va_list args);
+
+#endif // ___APRIORI2_CORE_ASYNC_LOG_IMPL_H___
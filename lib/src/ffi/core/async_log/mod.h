@@ -0,0 +1,20 @@
+#ifndef ___APRIORI2_CORE_ASYNC_LOG_H___
+#define ___APRIORI2_CORE_ASYNC_LOG_H___
+
+#include <stdint.h>
+
+#include "ffi/core/result.h"
+
+// Starts the background thread writing the FFI log messages:
+// the logging threads only format the message into a ring slot and never wait for I/O.
+// Does nothing if the thread is already running.
+Result start_async_log();
+
+// Waits for the threads still pushing a message,
+// writes the queued messages and joins the background thread
+void stop_async_log();
+
+// The messages lost because the ring was full
+uint32_t async_log_dropped_count();
+
+#endif // ___APRIORI2_CORE_ASYNC_LOG_H___
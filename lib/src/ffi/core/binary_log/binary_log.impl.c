@@ -0,0 +1,463 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "binary_log.impl.h"
+
+#include "ffi/util/mod.h"
+#include "ffi/os/thread.h"
+#include "ffi/os/time.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(BinaryLog)
+
+#define BINARY_LOG_RING_MASK (BINARY_LOG_RING_SIZE - 1)
+#define BINARY_LOG_VALUE_SIZE sizeof(uint64_t)
+
+static_assert(
+    IS_UINT32_POW_OF_2(BINARY_LOG_RING_SIZE, uint32_t),
+    "the binary log ring size must be a power of 2"
+);
+
+typedef enum LogLengthModifier {
+    LOG_LENGTH_NONE,
+    LOG_LENGTH_HH,
+    LOG_LENGTH_H,
+    LOG_LENGTH_L,
+    LOG_LENGTH_LL,
+    LOG_LENGTH_Z,
+    LOG_LENGTH_J,
+    LOG_LENGTH_T,
+    LOG_LENGTH_BIG_L
+} LogLengthModifier;
+
+volatile uint32_t binary_log_max_level = LOG_LEVEL_OFF;
+
+struct BinaryLog binary_log = { 0 };
+
+OS_THREAD_LOCAL struct BinaryLogThread binary_log_thread = { 0 };
+
+bool is_log_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+BinaryLogArgKind log_integer_arg_kind(LogLengthModifier length, bool is_signed) {
+    switch (length) {
+    case LOG_LENGTH_L:
+        return is_signed ? BINARY_LOG_ARG_LONG : BINARY_LOG_ARG_ULONG;
+    case LOG_LENGTH_LL:
+    case LOG_LENGTH_J:
+        return is_signed ? BINARY_LOG_ARG_LLONG : BINARY_LOG_ARG_ULLONG;
+    case LOG_LENGTH_Z:
+    case LOG_LENGTH_T:
+        return BINARY_LOG_ARG_SIZE;
+    default:
+        // `char` and `short` are promoted to `int`
+        return is_signed ? BINARY_LOG_ARG_INT : BINARY_LOG_ARG_UINT;
+    }
+}
+
+void parse_log_conversion(const char *spec, struct LogConversion *conversion) {
+    const char *c = spec + 1;
+    LogLengthModifier length = LOG_LENGTH_NONE;
+
+    memset(conversion, 0, sizeof(struct LogConversion));
+    conversion->is_supported = true;
+    conversion->has_value = true;
+
+    while (*c != '\0' && strchr("-+ #0", *c) != NULL)
+        ++c;
+
+    if (*c == '*') {
+        conversion->star_count += 1;
+        ++c;
+    } else {
+        while (is_log_digit(*c))
+            ++c;
+    }
+
+    if (*c == '.') {
+        ++c;
+
+        if (*c == '*') {
+            conversion->star_count += 1;
+            ++c;
+        } else {
+            while (is_log_digit(*c))
+                ++c;
+        }
+    }
+
+    switch (*c) {
+    case 'h':
+        ++c;
+        length = *c == 'h' ? (++c, LOG_LENGTH_HH) : LOG_LENGTH_H;
+        break;
+    case 'l':
+        ++c;
+        length = *c == 'l' ? (++c, LOG_LENGTH_LL) : LOG_LENGTH_L;
+        break;
+    case 'z': ++c; length = LOG_LENGTH_Z; break;
+    case 'j': ++c; length = LOG_LENGTH_J; break;
+    case 't': ++c; length = LOG_LENGTH_T; break;
+    case 'L': ++c; length = LOG_LENGTH_BIG_L; break;
+    default: break;
+    }
+
+    conversion->conversion = *c;
+    conversion->end = *c == '\0' ? c : c + 1;
+
+    switch (*c) {
+    case '%':
+        conversion->has_value = false;
+        break;
+    case 'd':
+    case 'i':
+        conversion->kind = log_integer_arg_kind(length, true);
+        break;
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+        conversion->kind = log_integer_arg_kind(length, false);
+        break;
+    case 'c':
+        conversion->kind = BINARY_LOG_ARG_INT;
+        conversion->is_supported = length == LOG_LENGTH_NONE;
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        conversion->kind = BINARY_LOG_ARG_DOUBLE;
+        conversion->is_supported = length != LOG_LENGTH_BIG_L;
+        break;
+    case 'p':
+        conversion->kind = BINARY_LOG_ARG_PTR;
+        break;
+    case 's':
+        conversion->kind = BINARY_LOG_ARG_STRING;
+        conversion->is_supported = length == LOG_LENGTH_NONE;
+        break;
+    default:
+        conversion->has_value = false;
+        conversion->is_supported = false;
+        break;
+    }
+}
+
+// Returns `BINARY_LOG_SITE_REGISTERING` if the site can't be recorded (yet)
+uint32_t register_binary_log_site(struct BinaryLogSite *site, const char *target, const char *format) {
+    struct LogConversion conversion = { 0 };
+    uint32_t site_id = 0;
+
+    // Another thread has registered the site or is registering it
+    if (!os_atomic_cas_u32(&site->id, &site_id, BINARY_LOG_SITE_REGISTERING))
+        return site_id;
+
+    uint32_t site_idx = os_atomic_add_u32(&binary_log.site_count, 1);
+
+    // The site stays in the registering state: it is never recorded
+    if (site_idx >= MAX_BINARY_LOG_SITES)
+        return BINARY_LOG_SITE_REGISTERING;
+
+    struct BinaryLogSiteInfo *info = &binary_log.sites[site_idx];
+    info->target = target;
+    info->is_supported = true;
+
+    for (const char *c = format; *c != '\0';) {
+        if (*c != '%') {
+            ++c;
+            continue;
+        }
+
+        parse_log_conversion(c, &conversion);
+        c = conversion.end;
+
+        uint32_t arg_count = info->arg_count + conversion.star_count + AS(conversion.has_value, uint32_t);
+
+        if (!conversion.is_supported || arg_count > MAX_BINARY_LOG_SITE_ARGS) {
+            info->is_supported = false;
+            info->arg_count = 0;
+            break;
+        }
+
+        for (uint32_t i = 0; i < conversion.star_count; ++i)
+            info->args[info->arg_count++] = BINARY_LOG_ARG_INT;
+
+        if (conversion.has_value)
+            info->args[info->arg_count++] = conversion.kind;
+    }
+
+    os_atomic_store_ptr(&info->format, AS(format, Handle));
+
+    site_id = site_idx + 1;
+    os_atomic_store_u32(&site->id, site_id);
+
+    return site_id;
+}
+
+Result new_binary_log_ring() {
+    Result result = { 0 };
+
+    struct BinaryLogRing *ring = ALLOC(result, struct BinaryLogRing);
+
+    result.object = ring;
+
+    FN_FORCE_EXIT(result);
+}
+
+bool register_binary_log_thread(struct BinaryLogThread *thread) {
+    // The warnings below may be recorded by this very thread
+    thread->is_unavailable = true;
+
+    Result result = new_binary_log_ring();
+    if (result.error != SUCCESS) {
+        warn(LOG_TARGET, "the thread log is not recorded: %s", AS(result.object, const char*));
+        return false;
+    }
+
+    uint32_t thread_idx = os_atomic_add_u32(&binary_log.thread_count, 1);
+    if (thread_idx >= MAX_BINARY_LOG_THREADS) {
+        warn(LOG_TARGET, "the thread log is not recorded: more than %d threads", MAX_BINARY_LOG_THREADS);
+
+        free(result.object);
+        return false;
+    }
+
+    thread->ring = result.object;
+    thread->thread_idx = thread_idx;
+    thread->is_unavailable = false;
+
+    os_atomic_store_ptr(&binary_log.rings[thread_idx], thread->ring);
+    return true;
+}
+
+void copy_to_binary_log_ring(struct BinaryLogRing *ring, uint32_t pos, const Byte *src, uint32_t size) {
+    uint32_t offset = pos & BINARY_LOG_RING_MASK;
+    uint32_t first_size = size < BINARY_LOG_RING_SIZE - offset ? size : BINARY_LOG_RING_SIZE - offset;
+
+    memcpy(ring->bytes + offset, src, first_size);
+    memcpy(ring->bytes, src + first_size, size - first_size);
+}
+
+void copy_from_binary_log_ring(struct BinaryLogRing *ring, uint32_t pos, Byte *dst, uint32_t size) {
+    uint32_t offset = pos & BINARY_LOG_RING_MASK;
+    uint32_t first_size = size < BINARY_LOG_RING_SIZE - offset ? size : BINARY_LOG_RING_SIZE - offset;
+
+    memcpy(dst, ring->bytes + offset, first_size);
+    memcpy(dst + first_size, ring->bytes, size - first_size);
+}
+
+void write_binary_log_u64(Byte *record, uint32_t *size, uint64_t value) {
+    memcpy(record + *size, &value, BINARY_LOG_VALUE_SIZE);
+    *size += BINARY_LOG_VALUE_SIZE;
+}
+
+void write_binary_log_args(
+    struct BinaryLogSite *site,
+    LogLevel level,
+    const char *target,
+    const char *format,
+    va_list args
+) {
+    struct BinaryLogThread *thread = &binary_log_thread;
+    Byte record[BINARY_LOG_MAX_RECORD_SIZE];
+    uint32_t size = sizeof(struct BinaryLogRecordHeader);
+
+    uint32_t site_id = os_atomic_load_u32(&site->id);
+    if (site_id == 0)
+        site_id = register_binary_log_site(site, target, format);
+
+    if (site_id == BINARY_LOG_SITE_REGISTERING)
+        return;
+
+    if (thread->ring == NULL && !thread->is_unavailable)
+        register_binary_log_thread(thread);
+
+    if (thread->is_unavailable)
+        return;
+
+    struct BinaryLogSiteInfo *info = &binary_log.sites[site_id - 1];
+
+    for (uint32_t i = 0; i < info->arg_count; ++i) {
+        switch (info->args[i]) {
+        case BINARY_LOG_ARG_INT:
+            write_binary_log_u64(record, &size, AS(AS(va_arg(args, int), int64_t), uint64_t));
+            break;
+        case BINARY_LOG_ARG_UINT:
+            write_binary_log_u64(record, &size, va_arg(args, unsigned int));
+            break;
+        case BINARY_LOG_ARG_LONG:
+            write_binary_log_u64(record, &size, AS(AS(va_arg(args, long), int64_t), uint64_t));
+            break;
+        case BINARY_LOG_ARG_ULONG:
+            write_binary_log_u64(record, &size, va_arg(args, unsigned long));
+            break;
+        case BINARY_LOG_ARG_LLONG:
+            write_binary_log_u64(record, &size, AS(va_arg(args, long long), uint64_t));
+            break;
+        case BINARY_LOG_ARG_ULLONG:
+            write_binary_log_u64(record, &size, va_arg(args, unsigned long long));
+            break;
+        case BINARY_LOG_ARG_SIZE:
+            write_binary_log_u64(record, &size, va_arg(args, size_t));
+            break;
+        case BINARY_LOG_ARG_DOUBLE: {
+            double value = va_arg(args, double);
+
+            memcpy(record + size, &value, BINARY_LOG_VALUE_SIZE);
+            size += BINARY_LOG_VALUE_SIZE;
+            break;
+        }
+        case BINARY_LOG_ARG_PTR:
+            write_binary_log_u64(record, &size, AS(va_arg(args, void*), uintptr_t));
+            break;
+        case BINARY_LOG_ARG_STRING: {
+            const char *string = va_arg(args, const char*);
+            uint32_t max_length = BINARY_LOG_MAX_RECORD_SIZE - size - 1
+                - (info->arg_count - i - 1) * BINARY_LOG_VALUE_SIZE;
+            uint32_t length = 0;
+
+            if (string == NULL)
+                string = "(null)";
+
+            if (max_length > BINARY_LOG_MAX_STRING_SIZE)
+                max_length = BINARY_LOG_MAX_STRING_SIZE;
+
+            while (length < max_length && string[length] != '\0')
+                ++length;
+
+            record[size++] = AS(length, Byte);
+            memcpy(record + size, string, length);
+            size += length;
+            break;
+        }
+        }
+    }
+
+    struct BinaryLogRecordHeader header = {
+        .site_id = site_id,
+        .payload_size = AS(size - sizeof(struct BinaryLogRecordHeader), uint16_t),
+        .level = AS(level, uint8_t),
+        .thread_idx = AS(thread->thread_idx, uint8_t),
+        .timestamp_ns = now_ns()
+    };
+    memcpy(record, &header, sizeof(struct BinaryLogRecordHeader));
+
+    struct BinaryLogRing *ring = thread->ring;
+    uint32_t tail = os_atomic_load_u32(&ring->tail);
+
+    if (BINARY_LOG_RING_SIZE - (ring->head - tail) < size) {
+        os_atomic_add_u32(&binary_log.dropped_count, 1);
+        return;
+    }
+
+    copy_to_binary_log_ring(ring, ring->head, record, size);
+    os_atomic_store_u32(&ring->head, ring->head + size);
+}
+
+void write_binary_log(struct BinaryLogSite *site, LogLevel level, const char *target, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    write_binary_log_args(site, level, target, format, args);
+
+    va_end(args);
+}
+
+void set_binary_log_max_level(uint32_t level) {
+    os_atomic_store_u32(&binary_log_max_level, level > LOG_LEVEL_TRACE ? LOG_LEVEL_TRACE : level);
+}
+
+void write_binary_log_string(FILE *file, const char *string) {
+    uint32_t size = string == NULL ? 0 : AS(strlen(string) + 1, uint32_t);
+
+    fwrite(&size, sizeof(uint32_t), 1, file);
+
+    if (size > 0)
+        fwrite(string, 1, size, file);
+}
+
+Result dump_binary_log(const char *path) {
+    ASSERT_NOT_NULL(path);
+
+    Result result = { 0 };
+    Byte record[BINARY_LOG_MAX_RECORD_SIZE];
+    struct BinaryLogRecordHeader header = { 0 };
+
+    FILE *file = fopen(path, "wb");
+    UNWRAP_NOT_NULL(result, FILE_IO, file);
+
+    uint32_t ring_heads[MAX_BINARY_LOG_THREADS] = { 0 };
+    uint32_t thread_count = os_atomic_load_u32(&binary_log.thread_count);
+    if (thread_count > MAX_BINARY_LOG_THREADS)
+        thread_count = MAX_BINARY_LOG_THREADS;
+
+    // The heads are taken before the sites:
+    // a record is committed after its site is published, so the dumped records reference the dumped sites
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        struct BinaryLogRing *ring = os_atomic_load_ptr(&binary_log.rings[i]);
+
+        if (ring != NULL)
+            ring_heads[i] = os_atomic_load_u32(&ring->head);
+    }
+
+    uint32_t site_count = os_atomic_load_u32(&binary_log.site_count);
+    if (site_count > MAX_BINARY_LOG_SITES)
+        site_count = MAX_BINARY_LOG_SITES;
+
+    fwrite(BINARY_LOG_MAGIC, 1, BINARY_LOG_MAGIC_SIZE, file);
+    fwrite(&site_count, sizeof(uint32_t), 1, file);
+
+    // An unpublished site is written empty
+    for (uint32_t i = 0; i < site_count; ++i) {
+        struct BinaryLogSiteInfo *info = &binary_log.sites[i];
+        const char *format = os_atomic_load_ptr(&info->format);
+
+        write_binary_log_string(file, format == NULL ? NULL : info->target);
+        write_binary_log_string(file, format);
+    }
+
+    for (uint32_t i = 0; i < thread_count; ++i) {
+        struct BinaryLogRing *ring = os_atomic_load_ptr(&binary_log.rings[i]);
+
+        if (ring == NULL)
+            continue;
+
+        uint32_t head = ring_heads[i];
+        uint32_t tail = ring->tail;
+
+        while (tail != head) {
+            copy_from_binary_log_ring(ring, tail, AS(&header, Byte*), sizeof(struct BinaryLogRecordHeader));
+
+            uint32_t size = sizeof(struct BinaryLogRecordHeader) + header.payload_size;
+
+            copy_from_binary_log_ring(ring, tail, record, size);
+            fwrite(record, 1, size, file);
+
+            tail += size;
+        }
+
+        os_atomic_store_u32(&ring->tail, tail);
+    }
+
+    if (ferror(file)) {
+        result.error = FILE_IO;
+        EXPECT_SUCCESS(result);
+    }
+
+    result.object = NULL;
+
+    FN_FORCE_EXIT(result, {
+        if (file != NULL)
+            fclose(file);
+    });
+}
+
+uint32_t binary_log_dropped_count() {
+    return os_atomic_load_u32(&binary_log.dropped_count);
+}
@@ -0,0 +1,105 @@
+#ifndef ___APRIORI2_CORE_BINARY_LOG_IMPL_H___
+#define ___APRIORI2_CORE_BINARY_LOG_IMPL_H___
+
+#include <stdbool.h>
+
+#include "mod.h"
+#include "ffi/core/log.h"
+#include "ffi/core/def.h"
+
+#define BINARY_LOG_MAGIC "APBLOG01"
+#define BINARY_LOG_MAGIC_SIZE 8
+
+#define BINARY_LOG_RING_SIZE (1 << 18)
+#define MAX_BINARY_LOG_THREADS 64
+#define MAX_BINARY_LOG_SITES 4096
+#define MAX_BINARY_LOG_SITE_ARGS 16
+#define BINARY_LOG_MAX_RECORD_SIZE 1024
+
+// The string arguments are stored with a single byte length
+#define BINARY_LOG_MAX_STRING_SIZE 255
+
+#define BINARY_LOG_SITE_REGISTERING UINT32_MAX
+
+// The C type an argument is read with: the integers are stored as 64 bits
+typedef enum BinaryLogArgKind {
+    BINARY_LOG_ARG_INT,
+    BINARY_LOG_ARG_UINT,
+    BINARY_LOG_ARG_LONG,
+    BINARY_LOG_ARG_ULONG,
+    BINARY_LOG_ARG_LLONG,
+    BINARY_LOG_ARG_ULLONG,
+    BINARY_LOG_ARG_SIZE,
+    BINARY_LOG_ARG_DOUBLE,
+    BINARY_LOG_ARG_PTR,
+    BINARY_LOG_ARG_STRING
+} BinaryLogArgKind;
+
+struct LogConversion {
+    // One past the conversion character
+    const char *end;
+
+    // The `*` width and precision are `int` arguments preceding the value
+    uint32_t star_count;
+
+    char conversion;
+
+    // False for `%%`
+    bool has_value;
+    BinaryLogArgKind kind;
+
+    // `%n`, `%ls`, `%Lf`...: the site is written without arguments
+    bool is_supported;
+};
+
+struct BinaryLogSiteInfo {
+    const char *target;
+
+    // Published last: NULL while the site is being registered
+    Handle volatile format;
+
+    bool is_supported;
+    uint32_t arg_count;
+    BinaryLogArgKind args[MAX_BINARY_LOG_SITE_ARGS];
+};
+
+// Native layout, followed by `payload_size` bytes of arguments
+struct BinaryLogRecordHeader {
+    uint32_t site_id;
+    uint16_t payload_size;
+    uint8_t level;
+    uint8_t thread_idx;
+    uint64_t timestamp_ns;
+};
+
+// Single producer (the owner thread), single consumer (the dump)
+struct BinaryLogRing {
+    // Free-running byte counters, a record may wrap around the end
+    volatile uint32_t head;
+    volatile uint32_t tail;
+
+    Byte bytes[BINARY_LOG_RING_SIZE];
+};
+
+struct BinaryLogThread {
+    struct BinaryLogRing *ring;
+    uint32_t thread_idx;
+
+    // No more rings or out of memory: the thread records nothing
+    bool is_unavailable;
+};
+
+struct BinaryLog {
+    volatile uint32_t site_count;
+    struct BinaryLogSiteInfo sites[MAX_BINARY_LOG_SITES];
+
+    volatile uint32_t thread_count;
+    Handle volatile rings[MAX_BINARY_LOG_THREADS];
+
+    volatile uint32_t dropped_count;
+};
+
+// `spec` points to the `%`
+void parse_log_conversion(const char *spec, struct LogConversion *conversion);
+
+#endif // ___APRIORI2_CORE_BINARY_LOG_IMPL_H___
@@ -0,0 +1,332 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "binary_log.impl.h"
+
+#include "ffi/util/mod.h"
+#include "ffi/os/time.h"
+
+#define DECODED_SPEC_SIZE 64
+#define DECODED_STAR_SIZE 16
+
+struct BinaryLogRecordRef {
+    uint64_t timestamp_ns;
+    uint32_t offset;
+};
+
+struct BinaryLogDumpSite {
+    const char *target;
+    const char *format;
+};
+
+int compare_binary_log_records(const void *lhs, const void *rhs) {
+    const struct BinaryLogRecordRef *lhs_ref = lhs;
+    const struct BinaryLogRecordRef *rhs_ref = rhs;
+
+    if (lhs_ref->timestamp_ns != rhs_ref->timestamp_ns)
+        return lhs_ref->timestamp_ns < rhs_ref->timestamp_ns ? -1 : 1;
+
+    // A thread's records are in the dump order
+    return lhs_ref->offset < rhs_ref->offset ? -1 : 1;
+}
+
+bool read_dump_u32(DynArray dump, uint32_t *offset, uint32_t *value) {
+    if (dump->count - *offset < sizeof(uint32_t))
+        return false;
+
+    memcpy(value, AS(dump->data, Byte*) + *offset, sizeof(uint32_t));
+    *offset += sizeof(uint32_t);
+
+    return true;
+}
+
+// The strings are stored with the terminating nul, an empty one is NULL
+bool read_dump_string(DynArray dump, uint32_t *offset, const char **string) {
+    uint32_t size = 0;
+
+    if (!read_dump_u32(dump, offset, &size) || dump->count - *offset < size)
+        return false;
+
+    const char *data = AS(AS(dump->data, Byte*) + *offset, const char*);
+
+    if (size > 0 && data[size - 1] != '\0')
+        return false;
+
+    *string = size == 0 ? NULL : data;
+    *offset += size;
+
+    return true;
+}
+
+bool read_payload_u64(const Byte *payload, uint32_t payload_size, uint32_t *offset, uint64_t *value) {
+    if (payload_size - *offset < sizeof(uint64_t))
+        return false;
+
+    memcpy(value, payload + *offset, sizeof(uint64_t));
+    *offset += sizeof(uint64_t);
+
+    return true;
+}
+
+// Rebuilds the conversion for a single 64-bit argument:
+// the `*` fields are replaced by their values and the length modifier by `ll`
+bool build_decoded_spec(
+    const char *spec,
+    const struct LogConversion *conversion,
+    const Byte *payload,
+    uint32_t payload_size,
+    uint32_t *offset,
+    char *decoded_spec
+) {
+    char star[DECODED_STAR_SIZE] = { 0 };
+    uint32_t size = 0;
+
+    for (const char *c = spec; c < conversion->end - 1; ++c) {
+        if (strchr("hlLzjt", *c) != NULL)
+            continue;
+
+        if (*c == '*') {
+            uint64_t value = 0;
+            if (!read_payload_u64(payload, payload_size, offset, &value))
+                return false;
+
+            snprintf(star, DECODED_STAR_SIZE, "%d", AS(AS(value, int64_t), int));
+        } else {
+            star[0] = *c;
+            star[1] = '\0';
+        }
+
+        uint32_t length = AS(strlen(star), uint32_t);
+        if (size + length >= DECODED_SPEC_SIZE - 4)
+            return false;
+
+        memcpy(decoded_spec + size, star, length);
+        size += length;
+    }
+
+    if (strchr("diouxX", conversion->conversion) != NULL) {
+        decoded_spec[size++] = 'l';
+        decoded_spec[size++] = 'l';
+    }
+
+    decoded_spec[size++] = conversion->conversion;
+    decoded_spec[size] = '\0';
+
+    return true;
+}
+
+// The spec is written as is when the arguments do not match it
+void write_decoded_conversion(
+    FILE *text,
+    const char *spec,
+    const struct LogConversion *conversion,
+    const Byte *payload,
+    uint32_t payload_size,
+    uint32_t *offset
+) {
+    char decoded_spec[DECODED_SPEC_SIZE] = { 0 };
+    char string[BINARY_LOG_MAX_STRING_SIZE + 1] = { 0 };
+    uint64_t value = 0;
+    double double_value = 0;
+
+    if (conversion->conversion == '%' && conversion->star_count == 0) {
+        fputc('%', text);
+        return;
+    }
+
+    if (
+        !conversion->is_supported
+        || !build_decoded_spec(spec, conversion, payload, payload_size, offset, decoded_spec)
+    )
+        goto raw_spec;
+
+    switch (conversion->kind) {
+    case BINARY_LOG_ARG_STRING: {
+        if (*offset >= payload_size || payload_size - *offset - 1 < payload[*offset])
+            goto raw_spec;
+
+        uint32_t length = payload[(*offset)++];
+
+        memcpy(string, payload + *offset, length);
+        *offset += length;
+
+        fprintf(text, decoded_spec, string);
+        return;
+    }
+    case BINARY_LOG_ARG_DOUBLE:
+        if (!read_payload_u64(payload, payload_size, offset, &value))
+            goto raw_spec;
+
+        memcpy(&double_value, &value, sizeof(double));
+        fprintf(text, decoded_spec, double_value);
+        return;
+    case BINARY_LOG_ARG_PTR:
+        if (!read_payload_u64(payload, payload_size, offset, &value))
+            goto raw_spec;
+
+        // The address of the recording process
+        fprintf(text, "0x%llx", AS(value, unsigned long long));
+        return;
+    default:
+        if (!read_payload_u64(payload, payload_size, offset, &value))
+            goto raw_spec;
+
+        if (conversion->conversion == 'c')
+            fprintf(text, decoded_spec, AS(value, int));
+        else if (conversion->conversion == 'd' || conversion->conversion == 'i')
+            fprintf(text, decoded_spec, AS(value, long long));
+        else
+            fprintf(text, decoded_spec, AS(value, unsigned long long));
+
+        return;
+    }
+
+raw_spec:
+    fwrite(spec, 1, AS(conversion->end - spec, size_t), text);
+}
+
+void write_decoded_record(FILE *text, const Byte *record, const struct BinaryLogDumpSite *site) {
+    static const char *level_names[] = { "OFF", "ERROR", "WARN", "INFO", "DEBUG", "TRACE" };
+
+    struct BinaryLogRecordHeader header = { 0 };
+    struct LogConversion conversion = { 0 };
+    uint32_t offset = 0;
+
+    memcpy(&header, record, sizeof(struct BinaryLogRecordHeader));
+
+    const Byte *payload = record + sizeof(struct BinaryLogRecordHeader);
+
+    fprintf(
+        text,
+        "%.6f [%d] %-5s %s: ",
+        AS(header.timestamp_ns, double) / AS(NS_PER_SEC, double),
+        header.thread_idx,
+        header.level < STATIC_ARRAY_SIZE(level_names) ? level_names[header.level] : "?",
+        site->target
+    );
+
+    for (const char *c = site->format; *c != '\0';) {
+        if (*c != '%') {
+            fputc(*c, text);
+            ++c;
+            continue;
+        }
+
+        parse_log_conversion(c, &conversion);
+        write_decoded_conversion(text, c, &conversion, payload, header.payload_size, &offset);
+
+        c = conversion.end;
+    }
+
+    fputc('\n', text);
+}
+
+Result decode_binary_log(const char *dump_path, const char *text_path) {
+    ASSERT_NOT_NULL(dump_path);
+    ASSERT_NOT_NULL(text_path);
+
+    Result result = { 0 };
+    DynArray dump = NULL;
+    struct BinaryLogDumpSite *sites = NULL;
+    struct BinaryLogRecordRef *records = NULL;
+    FILE *text = NULL;
+    uint32_t site_count = 0;
+    uint32_t record_count = 0;
+    uint32_t offset = BINARY_LOG_MAGIC_SIZE;
+
+    result = read_binary_file(dump_path);
+    RESULT_UNWRAP(dump, result);
+
+    if (
+        dump->count < BINARY_LOG_MAGIC_SIZE
+        || memcmp(dump->data, BINARY_LOG_MAGIC, BINARY_LOG_MAGIC_SIZE) != 0
+        || !read_dump_u32(dump, &offset, &site_count)
+        || site_count > MAX_BINARY_LOG_SITES
+    ) {
+        result.error = BINARY_LOG_INVALID;
+        EXPECT_SUCCESS(result);
+    }
+
+    sites = ALLOC_ARRAY(result, struct BinaryLogDumpSite, site_count + 1);
+
+    for (uint32_t i = 0; i < site_count; ++i) {
+        if (
+            !read_dump_string(dump, &offset, &sites[i].target)
+            || !read_dump_string(dump, &offset, &sites[i].format)
+        ) {
+            result.error = BINARY_LOG_INVALID;
+            EXPECT_SUCCESS(result);
+        }
+    }
+
+    records = ALLOC_ARRAY(
+        result,
+        struct BinaryLogRecordRef,
+        (dump->count - offset) / sizeof(struct BinaryLogRecordHeader) + 1
+    );
+
+    while (offset < dump->count) {
+        struct BinaryLogRecordHeader header = { 0 };
+
+        if (dump->count - offset < sizeof(struct BinaryLogRecordHeader)) {
+            result.error = BINARY_LOG_INVALID;
+            EXPECT_SUCCESS(result);
+        }
+
+        memcpy(&header, AS(dump->data, Byte*) + offset, sizeof(struct BinaryLogRecordHeader));
+
+        uint32_t size = sizeof(struct BinaryLogRecordHeader) + header.payload_size;
+
+        if (dump->count - offset < size) {
+            result.error = BINARY_LOG_INVALID;
+            EXPECT_SUCCESS(result);
+        }
+
+        // The site is missing from the site table if it wasn't published by the dump start
+        if (
+            header.site_id == 0
+            || header.site_id > site_count
+            || sites[header.site_id - 1].format == NULL
+        ) {
+            offset += size;
+            continue;
+        }
+
+        records[record_count].timestamp_ns = header.timestamp_ns;
+        records[record_count].offset = offset;
+        record_count += 1;
+
+        offset += size;
+    }
+
+    // The threads are dumped one after another
+    qsort(records, record_count, sizeof(struct BinaryLogRecordRef), compare_binary_log_records);
+
+    text = fopen(text_path, "w");
+    UNWRAP_NOT_NULL(result, FILE_IO, text);
+
+    for (uint32_t i = 0; i < record_count; ++i) {
+        const Byte *record = AS(dump->data, Byte*) + records[i].offset;
+        uint32_t site_id = 0;
+
+        memcpy(&site_id, record, sizeof(uint32_t));
+
+        write_decoded_record(text, record, &sites[site_id - 1]);
+    }
+
+    if (ferror(text)) {
+        result.error = FILE_IO;
+        EXPECT_SUCCESS(result);
+    }
+
+    result.object = NULL;
+
+    FN_FORCE_EXIT(result, {
+        if (text != NULL)
+            fclose(text);
+
+        free(records);
+        free(sites);
+        free(dump);
+    });
+}
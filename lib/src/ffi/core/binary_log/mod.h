@@ -0,0 +1,23 @@
+#ifndef ___APRIORI2_CORE_BINARY_LOG_H___
+#define ___APRIORI2_CORE_BINARY_LOG_H___
+
+#include <stdint.h>
+
+#include "ffi/core/result.h"
+
+// The max level written into the binary log (`LOG_LEVEL_*`), 0 disables the binary log.
+// It is independent of the text log level.
+void set_binary_log_max_level(uint32_t level);
+
+// Moves the records of all threads into the file together with the format strings.
+// Only one thread at a time may dump the log.
+Result dump_binary_log(const char *path);
+
+// Formats the records of a dump into text lines.
+// The dump must be produced by a build with the same integer sizes and endianness.
+Result decode_binary_log(const char *dump_path, const char *text_path);
+
+// The records lost because a thread buffer was full
+uint32_t binary_log_dropped_count();
+
+#endif // ___APRIORI2_CORE_BINARY_LOG_H___
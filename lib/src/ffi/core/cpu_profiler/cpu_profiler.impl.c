@@ -0,0 +1,170 @@
+#include "cpu_profiler.impl.h"
+
+#include "ffi/core/log.h"
+#include "ffi/core/result.h"
+#include "ffi/util/mod.h"
+#include "ffi/os/thread.h"
+#include "ffi/os/time.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(CpuProfiler)
+
+#define CPU_ZONE_RING_MASK (CPU_ZONE_RING_CAPACITY - 1)
+
+static_assert(
+    IS_UINT32_POW_OF_2(CPU_ZONE_RING_CAPACITY, uint32_t),
+    "the cpu zone ring capacity must be a power of 2"
+);
+
+struct CpuProfiler cpu_profiler = {
+    .is_enabled = true
+};
+
+OS_THREAD_LOCAL struct CpuZoneThread cpu_zone_thread = { 0 };
+
+Result new_cpu_zone_ring() {
+    Result result = { 0 };
+
+    struct CpuZoneRing *ring = ALLOC(result, struct CpuZoneRing);
+
+    result.object = ring;
+
+    FN_FORCE_EXIT(result);
+}
+
+bool register_cpu_zone_thread(struct CpuZoneThread *thread) {
+    Result result = new_cpu_zone_ring();
+    if (result.error != SUCCESS) {
+        warn(LOG_TARGET, "the thread zones are not recorded: %s", AS(result.object, const char*));
+        return false;
+    }
+
+    uint32_t thread_idx = os_atomic_add_u32(&cpu_profiler.thread_count, 1);
+    if (thread_idx >= MAX_CPU_PROFILER_THREADS) {
+        warn(LOG_TARGET, "the thread zones are not recorded: more than %d threads", MAX_CPU_PROFILER_THREADS);
+
+        free(result.object);
+        return false;
+    }
+
+    thread->ring = result.object;
+    thread->thread_idx = thread_idx;
+
+    os_atomic_store_ptr(&cpu_profiler.rings[thread_idx], thread->ring);
+    return true;
+}
+
+// The ring keeps room for the ends of all the open zones
+bool push_cpu_zone_begin(struct CpuZoneThread *thread, const char *name) {
+    if (thread->is_unavailable)
+        return false;
+
+    if (thread->ring == NULL && !register_cpu_zone_thread(thread)) {
+        thread->is_unavailable = true;
+        return false;
+    }
+
+    struct CpuZoneRing *ring = thread->ring;
+    uint32_t tail = os_atomic_load_u32(&ring->tail);
+    uint32_t free_count = CPU_ZONE_RING_CAPACITY - (ring->head - tail);
+
+    if (free_count < thread->depth + 1)
+        return false;
+
+    CpuZoneEvent *event = &ring->events[ring->head & CPU_ZONE_RING_MASK];
+    event->name = name;
+    event->timestamp_ns = now_ns();
+    event->thread_idx = thread->thread_idx;
+
+    os_atomic_store_u32(&ring->head, ring->head + 1);
+    return true;
+}
+
+void push_cpu_zone_end(struct CpuZoneThread *thread) {
+    struct CpuZoneRing *ring = thread->ring;
+
+    CpuZoneEvent *event = &ring->events[ring->head & CPU_ZONE_RING_MASK];
+    event->name = NULL;
+    event->timestamp_ns = now_ns();
+    event->thread_idx = thread->thread_idx;
+
+    os_atomic_store_u32(&ring->head, ring->head + 1);
+}
+
+uint32_t begin_cpu_zone(const char *name) {
+    struct CpuZoneThread *thread = &cpu_zone_thread;
+    uint32_t zone = thread->depth;
+
+    thread->depth += 1;
+
+    if (thread->skip_depth != 0)
+        return zone;
+
+    if (!os_atomic_load_u32(&cpu_profiler.is_enabled)) {
+        thread->skip_depth = thread->depth;
+        return zone;
+    }
+
+    if (!push_cpu_zone_begin(thread, name)) {
+        thread->skip_depth = thread->depth;
+
+        if (!thread->is_unavailable)
+            os_atomic_add_u32(&cpu_profiler.dropped_zone_count, 1);
+    }
+
+    return zone;
+}
+
+void end_cpu_zone(uint32_t zone) {
+    struct CpuZoneThread *thread = &cpu_zone_thread;
+
+    while (thread->depth > zone) {
+        if (thread->skip_depth == 0)
+            push_cpu_zone_end(thread);
+        else if (thread->skip_depth == thread->depth)
+            thread->skip_depth = 0;
+
+        thread->depth -= 1;
+    }
+}
+
+void set_cpu_profiler_enabled(bool is_enabled) {
+    os_atomic_store_u32(&cpu_profiler.is_enabled, is_enabled);
+
+    debug(LOG_TARGET, "cpu profiler %s", is_enabled ? "enabled" : "disabled");
+}
+
+uint32_t drain_cpu_zone_events(CpuZoneEvent *events, uint32_t capacity) {
+    uint32_t thread_count = os_atomic_load_u32(&cpu_profiler.thread_count);
+    uint32_t drained_count = 0;
+
+    if (thread_count > MAX_CPU_PROFILER_THREADS)
+        thread_count = MAX_CPU_PROFILER_THREADS;
+
+    for (uint32_t i = 0; i < thread_count && drained_count < capacity; ++i) {
+        struct CpuZoneRing *ring = os_atomic_load_ptr(&cpu_profiler.rings[i]);
+
+        // The thread has not published its ring yet
+        if (ring == NULL)
+            continue;
+
+        uint32_t head = os_atomic_load_u32(&ring->head);
+        uint32_t tail = ring->tail;
+        uint32_t count = head - tail;
+
+        if (count > capacity - drained_count)
+            count = capacity - drained_count;
+
+        for (uint32_t j = 0; j < count; ++j)
+            events[drained_count + j] = ring->events[(tail + j) & CPU_ZONE_RING_MASK];
+
+        drained_count += count;
+
+        os_atomic_store_u32(&ring->tail, tail + count);
+    }
+
+    return drained_count;
+}
+
+uint32_t cpu_profiler_dropped_zone_count() {
+    return os_atomic_load_u32(&cpu_profiler.dropped_zone_count);
+}
@@ -0,0 +1,41 @@
+#ifndef ___APRIORI2_CORE_CPU_PROFILER_IMPL_H___
+#define ___APRIORI2_CORE_CPU_PROFILER_IMPL_H___
+
+#include "mod.h"
+#include "ffi/core/def.h"
+
+#define CPU_ZONE_RING_CAPACITY 16384
+#define MAX_CPU_PROFILER_THREADS 64
+
+// Single producer (the owner thread), single consumer (the drain)
+struct CpuZoneRing {
+    // Free-running counters, wrapped by the capacity mask
+    volatile uint32_t head;
+    volatile uint32_t tail;
+
+    CpuZoneEvent events[CPU_ZONE_RING_CAPACITY];
+};
+
+struct CpuZoneThread {
+    struct CpuZoneRing *ring;
+    uint32_t thread_idx;
+
+    // No more rings or out of memory: the thread records nothing
+    bool is_unavailable;
+
+    uint32_t depth;
+
+    // The depth of the outermost skipped zone (0 if none):
+    // the zones inside of it are skipped too, so the ring never holds an unpaired end
+    uint32_t skip_depth;
+};
+
+struct CpuProfiler {
+    volatile uint32_t is_enabled;
+    volatile uint32_t dropped_zone_count;
+
+    volatile uint32_t thread_count;
+    Handle volatile rings[MAX_CPU_PROFILER_THREADS];
+};
+
+#endif // ___APRIORI2_CORE_CPU_PROFILER_IMPL_H___
@@ -0,0 +1,6 @@
+#ifndef ___APRIORI2_CORE_CPU_PROFILER_EXPORT_H___
+#define ___APRIORI2_CORE_CPU_PROFILER_EXPORT_H___
+
+#include "mod.h"
+
+#endif // ___APRIORI2_CORE_CPU_PROFILER_EXPORT_H___
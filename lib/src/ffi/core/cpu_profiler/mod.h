@@ -0,0 +1,41 @@
+#ifndef ___APRIORI2_CORE_CPU_PROFILER_H___
+#define ___APRIORI2_CORE_CPU_PROFILER_H___
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Zones nest per thread. Ending a zone also ends the zones opened inside of it,
+// so a `goto exit` over an inner `PROFILE_ZONE_END` keeps the thread balanced.
+#define PROFILE_ZONE_BEGIN(name) \
+    uint32_t ___apriori_cpu_zone_##name = begin_cpu_zone(#name)
+
+#define PROFILE_ZONE_END(name) \
+    end_cpu_zone(___apriori_cpu_zone_##name)
+
+typedef struct CpuZoneEvent {
+    // The static zone name, NULL for the end of the zone
+    const char *name;
+
+    uint64_t timestamp_ns;
+
+    // Registration order of the thread in the profiler
+    uint32_t thread_idx;
+} CpuZoneEvent;
+
+// `name` must outlive the profiler. Returns the zone to end.
+uint32_t begin_cpu_zone(const char *name);
+
+void end_cpu_zone(uint32_t zone);
+
+// Enabled from the start, so the startup zones are recorded
+void set_cpu_profiler_enabled(bool is_enabled);
+
+// Moves the recorded events of all threads into `events`, returns the moved count.
+// The events of each thread are in the recording order.
+// Only one thread at a time may drain the events.
+uint32_t drain_cpu_zone_events(CpuZoneEvent *events, uint32_t capacity);
+
+// The zones skipped because a thread ring was full
+uint32_t cpu_profiler_dropped_zone_count();
+
+#endif // ___APRIORI2_CORE_CPU_PROFILER_H___
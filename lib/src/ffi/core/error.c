@@ -19,6 +19,16 @@ const char *error_to_string(Apriori2Error error) {
         RENDERER_QUEUE_FAMILIES_NOT_FOUND,
         ": both graphics and present queue families were not found on the physical device"
     );
+    APRIORI_CASE(MEMORY_TYPE_NOT_FOUND, ": suitable memory type was not found on the physical device");
+    APRIORI_CASE(FILE_IO, ": file input/output failure");
+    APRIORI_CASE(STAGING_RING_OVERFLOW, ": the upload does not fit into the staging ring");
+    APRIORI_CASE(OVERLAY_ATLAS_FULL, ": the image does not fit into the overlay atlas");
+    APRIORI_CASE(OVERLAY_IMAGE_NOT_FOUND, ": the overlay image was removed or evicted");
+    APRIORI_CASE(OVERLAY_REGION_INVALID, ": the overlay image region is empty or outside of the image");
+    APRIORI_CASE(BINDLESS_TABLE_FULL, ": no free texture slot in the bindless table");
+    APRIORI_CASE(DESCR_ALLOCATOR_FULL, ": the frame slot reached the max descriptor pool count");
+    APRIORI_CASE(THREAD_CREATION_FAILED, ": unable to create an OS thread");
+    APRIORI_CASE(BINARY_LOG_INVALID, ": the binary log dump is truncated or corrupted");
 
     VK_CASE(NOT_READY);
     VK_CASE(TIMEOUT);
@@ -17,7 +17,17 @@ typedef enum Apriori2Error {
     EXTENSIONS_NOT_FOUND,
     GRAPHICS_QUEUE_FAMILY_NOT_FOUND,
     PRESENT_QUEUE_FAMILY_NOT_FOUND,
-    RENDERER_QUEUE_FAMILIES_NOT_FOUND
+    RENDERER_QUEUE_FAMILIES_NOT_FOUND,
+    MEMORY_TYPE_NOT_FOUND,
+    FILE_IO,
+    STAGING_RING_OVERFLOW,
+    OVERLAY_ATLAS_FULL,
+    OVERLAY_IMAGE_NOT_FOUND,
+    OVERLAY_REGION_INVALID,
+    BINDLESS_TABLE_FULL,
+    DESCR_ALLOCATOR_FULL,
+    THREAD_CREATION_FAILED,
+    BINARY_LOG_INVALID
 } Apriori2Error;
 
 const char *error_to_string(Apriori2Error error);
@@ -3,38 +3,25 @@
 #include <assert.h>
 
 #include "log.h"
-
-#define FFI_LOG_CODE(...) \
-    va_list args; \
-    va_start(args, format); \
-    \
-    ffi_log(__VA_ARGS__); \
-    \
-    va_end(args);
+#include "async_log/async_log.impl.h"
 
 // This function is implemented in Rust
-void ffi_log(const char *level, const char *target, const char *format, void *args);
+void ffi_log(LogLevel level, const char *target, const char *format, void *args);
 
-void log(const char *level, const char *target, const char *format, ...) {
-    FFI_LOG_CODE(level, target, format, args)
-}
+void log_message(struct BinaryLogSite *site, LogLevel level, const char *target, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
 
-void trace(const char *target, const char *format, ...) {
-    FFI_LOG_CODE("TRACE", target, format, args)
-}
+    if (AS(level, uint32_t) <= binary_log_max_level) {
+        va_list binary_args;
 
-void debug(const char *target, const char *format, ...) {
-    FFI_LOG_CODE("DEBUG", target, format, args)
-}
+        va_copy(binary_args, args);
+        write_binary_log_args(site, level, target, format, binary_args);
+        va_end(binary_args);
+    }
 
-void info(const char *target, const char *format, ...) {
-    FFI_LOG_CODE("INFO", target, format, args)
-}
+    if (ffi_log_enabled(level) && !push_async_log_message(level, target, format, args))
+        ffi_log(level, target, format, args);
 
-void warn(const char *target, const char *format, ...) {
-    FFI_LOG_CODE("WARN", target, format, args)
+    va_end(args);
 }
-
-void error(const char *target, const char *format, ...) {
-    FFI_LOG_CODE("ERROR", target, format, args)
-}
\ No newline at end of file
@@ -1,19 +1,86 @@
 #ifndef ___APRIORI2_CORE_LOG_H___
 #define ___APRIORI2_CORE_LOG_H___
 
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
+
 #include "def.h"
 
 #define LOG_FFI_TARGET "FFI"
 #define LOG_SUB_TARGET(parent_target, child_target) parent_target "/" child_target
 #define LOG_STRUCT_TARGET(struct_name) LOG_SUB_TARGET(LOG_FFI_TARGET, #struct_name)
 
-void log(const char *level, const char *target, const char *format, ...);
+// The values match `log::Level`
+typedef enum LogLevel {
+    LOG_LEVEL_OFF = 0,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_TRACE
+} LogLevel;
+
+// This function is implemented in Rust: compares the level with the `log` max level
+bool ffi_log_enabled(LogLevel level);
+
+// Every log call site owns one: the format string is registered on the first call
+struct BinaryLogSite {
+    // 0 until registered
+    volatile uint32_t id;
+};
+
+// The max level written into the binary log, `LOG_LEVEL_OFF` by default
+extern volatile uint32_t binary_log_max_level;
+
+// Writes the message into every sink enabled for the level: the binary log and the text log.
+// `target` and `format` must be static strings (the async log and the binary log keep the pointers).
+void log_message(struct BinaryLogSite *site, LogLevel level, const char *target, const char *format, ...);
+
+// Copies the raw arguments into the thread buffer, the text is formatted by the decoder.
+// `target` and `format` must be static strings.
+void write_binary_log(struct BinaryLogSite *site, LogLevel level, const char *target, const char *format, ...);
+
+void write_binary_log_args(
+    struct BinaryLogSite *site,
+    LogLevel level,
+    const char *target,
+    const char *format,
+    va_list args
+);
+
+#define ___apriori_impl_LOG_BINARY(level, target, ...) do { \
+    if (AS((level), uint32_t) <= binary_log_max_level) { \
+        static struct BinaryLogSite ___apriori_log_site = { 0 }; \
+        write_binary_log(&___apriori_log_site, (level), (target), __VA_ARGS__); \
+    } \
+} while(0)
+
+// Nothing is formatted unless the level is enabled.
+// The arguments are evaluated once, whatever the number of enabled sinks.
+#define log(level, target, ...) do { \
+    static struct BinaryLogSite ___apriori_log_site = { 0 }; \
+    LogLevel ___apriori_log_level = (level); \
+    if ( \
+        AS(___apriori_log_level, uint32_t) <= binary_log_max_level \
+        || ffi_log_enabled(___apriori_log_level) \
+    ) \
+        log_message(&___apriori_log_site, ___apriori_log_level, (target), __VA_ARGS__); \
+} while(0)
+
+// The text output of trace and debug is compiled out of the release builds,
+// they still can be recorded by the binary log
+#ifdef ___release___
+#   define trace(target, ...) ___apriori_impl_LOG_BINARY(LOG_LEVEL_TRACE, target, __VA_ARGS__)
+#   define debug(target, ...) ___apriori_impl_LOG_BINARY(LOG_LEVEL_DEBUG, target, __VA_ARGS__)
+#else
+#   define trace(target, ...) log(LOG_LEVEL_TRACE, target, __VA_ARGS__)
+#   define debug(target, ...) log(LOG_LEVEL_DEBUG, target, __VA_ARGS__)
+#endif // ___release___
 
-void trace(const char *target, const char *format, ...);
-void debug(const char *target, const char *format, ...);
-void info(const char *target, const char *format, ...);
-void warn(const char *target, const char *format, ...);
-void error(const char *target, const char *format, ...);
+#define info(target, ...) log(LOG_LEVEL_INFO, target, __VA_ARGS__)
+#define warn(target, ...) log(LOG_LEVEL_WARN, target, __VA_ARGS__)
+#define error(target, ...) log(LOG_LEVEL_ERROR, target, __VA_ARGS__)
 
 #define LOG_GROUP_TYPE(group_name) ___apriori_impl_LogGroup_##group_name
 #define LOG_GROUP_CASE(group_name) LOG_GROUP_TYPE(group_name)*
@@ -31,4 +98,4 @@ DEFINE_LOG_GROUP(struct_op_block);
 
 #undef DEFINE_LOG_GROUP
 
-#endif // ___APRIORI2_CORE_LOG_H___
\ No newline at end of file
+#endif // ___APRIORI2_CORE_LOG_H___
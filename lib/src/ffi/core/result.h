@@ -6,6 +6,9 @@
 #include "error.h"
 #include "def.h"
 
+// The Vulkan result codes are a subset of `Apriori2Error`
+#define VK_RESULT(vk_result) AS((vk_result), Apriori2Error)
+
 // Sets error to result and attachs error description
 #define ___apriori_impl_NORMALIZE_RESULT(result, error_value) \
     ((result).error = (error_value), (result).object = (Handle)error_to_string((error_value)))
@@ -28,10 +31,11 @@
     } \
 } while(0)
 
+// `ptr` is evaluated exactly once (it is an allocation call in the `ALLOC*` macros)
 #define UNWRAP_NOT_NULL(result, error_value, ptr) \
-    (((ptr) == NULL) ? \
+    ((((result).object = (Handle)(ptr)) == NULL) ? \
         (___apriori_impl_NORMALIZE_RESULT(result, error_value), NULL) \
-        : ((result).error = SUCCESS, (result).object = (ptr)) \
+        : ((result).error = SUCCESS, (result).object) \
     ); EXPECT_SUCCESS(result)
 
 #define ALLOC_WITH(result, alloc_fn, ...) \
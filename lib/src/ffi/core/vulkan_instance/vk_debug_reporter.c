@@ -36,12 +36,12 @@ Result new_debug_reporter(VulkanInstance instance, PFN_vkDebugReportCallbackEXT
     reporter = ALLOC_UNINIT(result, DebugReporter);
 
     reporter->instance = instance;
-    result.error = vkCreateDebugReportCallbackEXT(
+    result.error = VK_RESULT(vkCreateDebugReportCallbackEXT(
         vk_handle(instance),
         &debug_report_ci,
         NULL,
         &reporter->callback
-    );
+    ));
 
     info(LOG_TARGET, "new debug reporter created successfully");
 
@@ -5,6 +5,7 @@
 #include <vulkan/vulkan.h>
 
 #include "ffi/core/log.h"
+#include "ffi/core/cpu_profiler/mod.h"
 
 #include "mod.h"
 #include "ffi/core/vulkan_instance/vulkan_instance.impl.h"
@@ -55,7 +56,7 @@
 #elif ___macos___
 #   define VULKAN_PLATFORM_EXTENSION MACRO_EXPAND(VK_EXT_metal_surface)
 #elif ___linux___
-#   error "linux is not supported yet"
+#   define VULKAN_PLATFORM_EXTENSION MACRO_EXPAND(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME)
 #elif ___unknown___
 #   error "this target OS is not supported yet"
 #endif // os
@@ -67,14 +68,14 @@ Result check_all_layers_available(const char **layers, uint32_t num_layers) {
 
     trace(LOG_TARGET, LOG_GROUP(struct, "checking requested validation layers"));
 
-    result.error = vkEnumerateInstanceLayerProperties(&property_count, NULL);
+    result.error = VK_RESULT(vkEnumerateInstanceLayerProperties(&property_count, NULL));
     EXPECT_SUCCESS(result);
 
     trace(LOG_TARGET, LOG_GROUP(struct, "available validation layers count: %d"), property_count);
 
     layer_props = ALLOC_ARRAY_UNINIT(result, VkLayerProperties, property_count);
 
-    result.error = vkEnumerateInstanceLayerProperties(&property_count, layer_props);
+    result.error = VK_RESULT(vkEnumerateInstanceLayerProperties(&property_count, layer_props));
     EXPECT_SUCCESS(result);
 
     for (uint32_t i = 0, j = 0; i < num_layers; ++i) {
@@ -104,14 +105,14 @@ Result check_all_extensions_available(const char **extensions, uint32_t num_exte
 
     trace(LOG_TARGET, LOG_GROUP(struct, "checking requested extensions"));
 
-    result.error = vkEnumerateInstanceExtensionProperties(NULL, &property_count, NULL);
+    result.error = VK_RESULT(vkEnumerateInstanceExtensionProperties(NULL, &property_count, NULL));
     EXPECT_SUCCESS(result);
 
     trace(LOG_TARGET, LOG_GROUP(struct, "available extension count: %d"), property_count);
 
     extension_props = ALLOC_ARRAY_UNINIT(result, VkLayerProperties, property_count);
 
-    result.error = vkEnumerateInstanceExtensionProperties(NULL, &property_count, extension_props);
+    result.error = VK_RESULT(vkEnumerateInstanceExtensionProperties(NULL, &property_count, extension_props));
     EXPECT_SUCCESS(result);
 
     for (uint32_t i = 0, j = 0; i < num_extensions; ++i) {
@@ -139,20 +140,20 @@ Result init_phy_devices(VulkanInstance instance) {
 
     trace(LOG_TARGET, LOG_GROUP(struct, "initializing physical devices..."));
 
-    result.error = vkEnumeratePhysicalDevices(
+    result.error = VK_RESULT(vkEnumeratePhysicalDevices(
         instance->vk_handle,
         &instance->phy_device_count,
         NULL
-    );
+    ));
     EXPECT_SUCCESS(result);
 
     instance->phy_devices = ALLOC_ARRAY(result, VkPhysicalDevice, instance->phy_device_count);
 
-    result.error = vkEnumeratePhysicalDevices(
+    result.error = VK_RESULT(vkEnumeratePhysicalDevices(
         instance->vk_handle,
         &instance->phy_device_count,
         instance->phy_devices
-    );
+    ));
     EXPECT_SUCCESS(result);
 
     trace(LOG_TARGET, LOG_GROUP(struct, "physical devices successfully initialized"));
@@ -163,6 +164,8 @@ Result init_phy_devices(VulkanInstance instance) {
 Result new_vk_instance() {
     Result result = { 0 };
 
+    PROFILE_ZONE_BEGIN(new_vk_instance);
+
     info(LOG_TARGET, "creating new vulkan instance...");
 
     VulkanInstance instance = ALLOC(result, struct VulkanInstanceFFI);
@@ -170,7 +173,10 @@ Result new_vk_instance() {
     static VkApplicationInfo app_info = {
         .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
         .pApplicationName = APRIORI2_APPLICATION_NAME,
-        .applicationVersion = APRIORI2_VK_VERSION
+        .applicationVersion = APRIORI2_VK_VERSION,
+
+        // The extended device features query (the bindless renderer mode)
+        .apiVersion = VK_API_VERSION_1_1
     };
 
     trace(
@@ -186,7 +192,7 @@ Result new_vk_instance() {
 
     const uint32_t layer_names_count = STATIC_ARRAY_SIZE(layer_names);
 #   else
-    const char *layer_names = NULL;
+    const char **layer_names = NULL;
     const uint32_t layer_names_count = 0;
 #   endif // ___debug___
 
@@ -222,8 +228,8 @@ Result new_vk_instance() {
     instance_ci.ppEnabledLayerNames = layer_names;
     instance_ci.ppEnabledExtensionNames = extension_names;
 
-    result.error = vkCreateInstance(&instance_ci, NULL, &instance->vk_handle);
-    if(result.error != VK_SUCCESS)
+    result.error = VK_RESULT(vkCreateInstance(&instance_ci, NULL, &instance->vk_handle));
+    if(result.error != SUCCESS)
         goto failure;
 
     result = init_phy_devices(instance);
@@ -241,7 +247,9 @@ Result new_vk_instance() {
     result.object = instance;
     info(LOG_TARGET, "new vulkan instance created successfully");
 
-    FN_EXIT(result);
+    FN_EXIT(result, {
+        PROFILE_ZONE_END(new_vk_instance);
+    });
 
     FN_FAILURE(result, {
         drop_vk_instance(instance);
@@ -1,16 +1,23 @@
 #ifndef ___APRIORI2_GRAPHICS_GPU_H___
 #define ___APRIORI2_GRAPHICS_GPU_H___
 
+// Annotations of the declarations shared between C and HLSL (no-ops in C)
 #ifdef ___gpu___
 #   define vk_location(loc) [[vk::location(loc)]]
+#   define vk_binding(binding, set) [[vk::binding(binding, set)]]
+#   define vk_constant_id(id) [[vk::constant_id(id)]]
 #   define semantics(sem) : sem
+#   define gpu_type(c_type, hlsl_type) hlsl_type
 #else
 #   include "ffi/math/mod.h"
 
 #   define SHADER_DEFAULT_ENTRY_POINT "main"
 
 #   define vk_location(_)
+#   define vk_binding(binding, set)
+#   define vk_constant_id(_)
 #   define semantics(_)
+#   define gpu_type(c_type, hlsl_type) c_type
 #endif // ___gpu___
 
 #endif // ___APRIORI2_GRAPHICS_GPU_H___
\ No newline at end of file
@@ -0,0 +1,505 @@
+#include <string.h>
+
+#include "allocator.h"
+
+#include "ffi/util/mod.h"
+#include "ffi/core/log.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(GpuAllocator)
+
+#define BYTES_TO_MIB(bytes) (AS((bytes), double) / AS(1 << 20, double))
+
+struct GpuMemoryFlags {
+    VkMemoryPropertyFlags required;
+    VkMemoryPropertyFlags preferred;
+    VkMemoryPropertyFlags avoided;
+};
+
+struct GpuMemoryFlags usage_memory_flags(GpuMemoryUsage usage) {
+    struct GpuMemoryFlags flags = { 0 };
+    VkMemoryPropertyFlags host_visible = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+        | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    switch (usage) {
+    case GPU_MEMORY_USAGE_DEVICE_LOCAL:
+        flags.required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        flags.avoided = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        break;
+    case GPU_MEMORY_USAGE_HOST_UPLOAD:
+        // The device local host visible memory is scarce: it is left for the dynamic usage
+        flags.required = host_visible;
+        flags.avoided = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        break;
+    case GPU_MEMORY_USAGE_HOST_READBACK:
+        flags.required = host_visible;
+        flags.preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        break;
+    case GPU_MEMORY_USAGE_DYNAMIC:
+        flags.required = host_visible;
+        flags.preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        break;
+    default:
+        assert(false && "unknown GPU memory usage");
+    }
+
+    return flags;
+}
+
+bool find_gpu_memory_type(
+    struct GpuAllocator *allocator,
+    uint32_t memory_type_bits,
+    GpuMemoryUsage usage,
+    uint32_t *memory_type_idx
+) {
+    ASSERT_NOT_NULL(allocator);
+    ASSERT_NOT_NULL(memory_type_idx);
+
+    struct GpuMemoryFlags flags = usage_memory_flags(usage);
+    int32_t best_score = -1;
+
+    // The memory types are ordered by the driver from the most performant,
+    // so the first one wins on a tie
+    for (uint32_t i = 0; i < allocator->memory_props.memoryTypeCount; ++i) {
+        VkMemoryPropertyFlags type_flags = allocator->memory_props.memoryTypes[i].propertyFlags;
+        int32_t score = 0;
+
+        if (!(memory_type_bits & POW_2(i, uint32_t)))
+            continue;
+
+        if ((type_flags & flags.required) != flags.required)
+            continue;
+
+        if (flags.preferred != 0 && (type_flags & flags.preferred) == flags.preferred)
+            score += 2;
+
+        if (!(type_flags & flags.avoided))
+            score += 1;
+
+        if (score > best_score) {
+            best_score = score;
+            *memory_type_idx = i;
+        }
+    }
+
+    return best_score >= 0;
+}
+
+// Linear and optimal resources can share a block
+// if the granularity is not coarser than the sub-allocation alignment
+GpuResourceKind gpu_pool_kind(struct GpuAllocator *allocator, GpuResourceKind kind) {
+    return allocator->buffer_image_granularity <= TLSF_MIN_ALIGNMENT
+        ? GPU_RESOURCE_LINEAR
+        : kind;
+}
+
+GpuHeapStats *memory_type_heap_stats(struct GpuAllocator *allocator, uint32_t memory_type_idx) {
+    uint32_t heap_idx = allocator->memory_props.memoryTypes[memory_type_idx].heapIndex;
+
+    return &allocator->stats.heaps[heap_idx];
+}
+
+void drop_gpu_memory_block(struct GpuAllocator *allocator, struct GpuMemoryBlock *block) {
+    if (block == NULL)
+        goto exit;
+
+    drop_tlsf(block->tlsf);
+
+    if (block->memory != VK_NULL_HANDLE) {
+        GpuHeapStats *heap_stats = memory_type_heap_stats(allocator, block->memory_type_idx);
+
+        if (block->mapped != NULL)
+            vkUnmapMemory(allocator->device, block->memory);
+
+        vkFreeMemory(allocator->device, block->memory, NULL);
+
+        heap_stats->block_count -= 1;
+        heap_stats->allocated_size -= block->size;
+        allocator->device_allocation_count -= 1;
+    }
+
+    free(block);
+
+exit:
+    trace(LOG_TARGET, "drop GPU memory block");
+}
+
+Result new_gpu_memory_block(
+    struct GpuAllocator *allocator,
+    uint32_t memory_type_idx,
+    VkDeviceSize size,
+    bool is_dedicated
+) {
+    Result result = { 0 };
+    GpuHeapStats *heap_stats = memory_type_heap_stats(allocator, memory_type_idx);
+    VkMemoryPropertyFlags type_flags = allocator->memory_props.memoryTypes[memory_type_idx].propertyFlags;
+    VkMemoryAllocateInfo memory_ai = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = size,
+        .memoryTypeIndex = memory_type_idx
+    };
+
+    debug(
+        LOG_TARGET,
+        "allocating new %s GPU memory block (memory type #%d, size: %.2f MiB)...",
+        is_dedicated ? "dedicated" : "shared",
+        memory_type_idx,
+        BYTES_TO_MIB(size)
+    );
+
+    struct GpuMemoryBlock *block = ALLOC(result, struct GpuMemoryBlock);
+
+    block->size = size;
+    block->memory_type_idx = memory_type_idx;
+
+    if (allocator->device_allocation_count >= allocator->max_device_allocation_count) {
+        result.error = VK_RESULT(VK_ERROR_TOO_MANY_OBJECTS);
+        EXPECT_SUCCESS(result);
+    }
+
+    result.error = VK_RESULT(vkAllocateMemory(allocator->device, &memory_ai, NULL, &block->memory));
+    EXPECT_SUCCESS(result);
+
+    heap_stats->block_count += 1;
+    heap_stats->allocated_size += size;
+    allocator->device_allocation_count += 1;
+
+    if (type_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        result.error = VK_RESULT(vkMapMemory(allocator->device, block->memory, 0, VK_WHOLE_SIZE, 0, &block->mapped));
+        EXPECT_SUCCESS(result);
+    }
+
+    if (!is_dedicated) {
+        result = new_tlsf(size, GPU_MEMORY_MAX_BLOCK_ALLOCATIONS);
+        RESULT_UNWRAP(block->tlsf, result);
+    }
+
+    result.object = block;
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_gpu_memory_block(allocator, block);
+    });
+}
+
+Result new_gpu_allocator(VkPhysicalDevice phy_device, VkDevice device) {
+    ASSERT_NOT_NULL(phy_device);
+    ASSERT_NOT_NULL(device);
+
+    Result result = { 0 };
+    VkPhysicalDeviceProperties props = { 0 };
+
+    info(LOG_TARGET, "creating new GPU allocator...");
+
+    struct GpuAllocator *allocator = ALLOC(result, struct GpuAllocator);
+
+    vkGetPhysicalDeviceProperties(phy_device, &props);
+    vkGetPhysicalDeviceMemoryProperties(phy_device, &allocator->memory_props);
+
+    allocator->device = device;
+    allocator->buffer_image_granularity = props.limits.bufferImageGranularity;
+    allocator->max_device_allocation_count = props.limits.maxMemoryAllocationCount;
+    allocator->stats.heap_count = allocator->memory_props.memoryHeapCount;
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "buffer image granularity: %d, max memory allocation count: %d"),
+        AS(allocator->buffer_image_granularity, uint32_t),
+        allocator->max_device_allocation_count
+    );
+
+    for (uint32_t i = 0; i < allocator->memory_props.memoryHeapCount; ++i) {
+        VkMemoryHeap *heap = &allocator->memory_props.memoryHeaps[i];
+        GpuHeapStats *heap_stats = &allocator->stats.heaps[i];
+
+        heap_stats->heap_size = heap->size;
+        heap_stats->is_device_local = (heap->flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+
+        // Small heaps (e.g. the device local host visible 256 MiB window)
+        // must not be consumed by a few blocks
+        allocator->block_sizes[i] = heap->size <= GPU_MEMORY_SMALL_HEAP_SIZE
+            ? (heap->size / 8) & ~(TLSF_MIN_ALIGNMENT - 1)
+            : GPU_MEMORY_BLOCK_SIZE;
+
+        trace(
+            LOG_TARGET,
+            LOG_GROUP(struct, "heap #%d: %.2f MiB%s, block size: %.2f MiB"),
+            i,
+            BYTES_TO_MIB(heap->size),
+            heap_stats->is_device_local ? " (device local)" : "",
+            BYTES_TO_MIB(allocator->block_sizes[i])
+        );
+    }
+
+    result.object = allocator;
+    info(LOG_TARGET, "new GPU allocator created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_gpu_allocator(allocator);
+    });
+}
+
+Result gpu_alloc(
+    struct GpuAllocator *allocator,
+    VkMemoryRequirements *requirements,
+    GpuMemoryUsage usage,
+    GpuResourceKind kind,
+    struct GpuAllocation *allocation
+) {
+    ASSERT_NOT_NULL(allocator);
+    ASSERT_NOT_NULL(requirements);
+    ASSERT_NOT_NULL(allocation);
+
+    Result result = { 0 };
+    uint32_t memory_type_idx = 0;
+    uint32_t heap_idx = 0;
+    struct GpuMemoryPool *pool = NULL;
+    struct GpuMemoryBlock *block = NULL;
+    struct TlsfBlock *range = NULL;
+    GpuHeapStats *heap_stats = NULL;
+
+    memset(allocation, 0, sizeof(struct GpuAllocation));
+
+    if (!find_gpu_memory_type(allocator, requirements->memoryTypeBits, usage, &memory_type_idx)) {
+        result.error = MEMORY_TYPE_NOT_FOUND;
+        EXPECT_SUCCESS(result);
+    }
+
+    heap_idx = allocator->memory_props.memoryTypes[memory_type_idx].heapIndex;
+
+    if (requirements->size > allocator->block_sizes[heap_idx] / GPU_MEMORY_DEDICATED_THRESHOLD_DIVISOR) {
+        result = new_gpu_memory_block(allocator, memory_type_idx, requirements->size, true);
+        RESULT_UNWRAP(block, result);
+
+        allocation->offset = 0;
+        allocation->size = requirements->size;
+    } else {
+        pool = &allocator->pools[memory_type_idx][gpu_pool_kind(allocator, kind)];
+
+        for (block = pool->blocks; block != NULL; block = block->next) {
+            range = tlsf_alloc(block->tlsf, requirements->size, requirements->alignment);
+            if (range != NULL)
+                break;
+        }
+
+        if (range == NULL) {
+            result = new_gpu_memory_block(allocator, memory_type_idx, allocator->block_sizes[heap_idx], false);
+            RESULT_UNWRAP(block, result);
+
+            block->next = pool->blocks;
+            pool->blocks = block;
+
+            range = tlsf_alloc(block->tlsf, requirements->size, requirements->alignment);
+            assert(range != NULL && "a new GPU memory block can't fit the allocation");
+        }
+
+        allocation->offset = range->offset;
+        allocation->size = range->size;
+    }
+
+    allocation->block = block;
+    allocation->range = range;
+    allocation->memory = block->memory;
+    allocation->mapped = block->mapped != NULL
+        ? AS(block->mapped, Byte*) + allocation->offset
+        : NULL;
+
+    heap_stats = &allocator->stats.heaps[heap_idx];
+    heap_stats->allocation_count += 1;
+    heap_stats->used_size += allocation->size;
+
+    result.object = allocation;
+
+    FN_FORCE_EXIT(result);
+}
+
+void gpu_free(struct GpuAllocator *allocator, struct GpuAllocation *allocation) {
+    ASSERT_NOT_NULL(allocator);
+    ASSERT_NOT_NULL(allocation);
+
+    struct GpuMemoryBlock *block = allocation->block;
+
+    if (block == NULL)
+        return;
+
+    GpuHeapStats *heap_stats = memory_type_heap_stats(allocator, block->memory_type_idx);
+    heap_stats->allocation_count -= 1;
+    heap_stats->used_size -= allocation->size;
+
+    // Empty shared blocks are kept for the next allocations
+    if (block->tlsf == NULL)
+        drop_gpu_memory_block(allocator, block);
+    else
+        tlsf_free(block->tlsf, allocation->range);
+
+    memset(allocation, 0, sizeof(struct GpuAllocation));
+}
+
+Result gpu_allocator_reserve(
+    struct GpuAllocator *allocator,
+    uint32_t memory_type_bits,
+    GpuMemoryUsage usage,
+    GpuResourceKind kind
+) {
+    ASSERT_NOT_NULL(allocator);
+
+    Result result = { 0 };
+    uint32_t memory_type_idx = 0;
+    uint32_t heap_idx = 0;
+    struct GpuMemoryPool *pool = NULL;
+    struct GpuMemoryBlock *block = NULL;
+
+    if (!find_gpu_memory_type(allocator, memory_type_bits, usage, &memory_type_idx)) {
+        result.error = MEMORY_TYPE_NOT_FOUND;
+        EXPECT_SUCCESS(result);
+    }
+
+    heap_idx = allocator->memory_props.memoryTypes[memory_type_idx].heapIndex;
+    pool = &allocator->pools[memory_type_idx][gpu_pool_kind(allocator, kind)];
+
+    if (pool->blocks != NULL)
+        goto exit;
+
+    result = new_gpu_memory_block(allocator, memory_type_idx, allocator->block_sizes[heap_idx], false);
+    RESULT_UNWRAP(block, result);
+
+    pool->blocks = block;
+
+    FN_FORCE_EXIT(result);
+}
+
+Result gpu_alloc_buffer(
+    struct GpuAllocator *allocator,
+    VkBufferCreateInfo *buffer_ci,
+    GpuMemoryUsage usage,
+    VkBuffer *buffer,
+    struct GpuAllocation *allocation
+) {
+    ASSERT_NOT_NULL(allocator);
+    ASSERT_NOT_NULL(buffer_ci);
+    ASSERT_NOT_NULL(buffer);
+    ASSERT_NOT_NULL(allocation);
+
+    Result result = { 0 };
+    VkMemoryRequirements requirements = { 0 };
+
+    *buffer = VK_NULL_HANDLE;
+    memset(allocation, 0, sizeof(struct GpuAllocation));
+
+    result.error = VK_RESULT(vkCreateBuffer(allocator->device, buffer_ci, NULL, buffer));
+    EXPECT_SUCCESS(result);
+
+    vkGetBufferMemoryRequirements(allocator->device, *buffer, &requirements);
+
+    result = gpu_alloc(allocator, &requirements, usage, GPU_RESOURCE_LINEAR, allocation);
+    EXPECT_SUCCESS(result);
+
+    result.error = VK_RESULT(vkBindBufferMemory(allocator->device, *buffer, allocation->memory, allocation->offset));
+    EXPECT_SUCCESS(result);
+
+    result.object = allocation;
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        gpu_free_buffer(allocator, *buffer, allocation);
+        *buffer = VK_NULL_HANDLE;
+    });
+}
+
+void gpu_free_buffer(struct GpuAllocator *allocator, VkBuffer buffer, struct GpuAllocation *allocation) {
+    ASSERT_NOT_NULL(allocator);
+
+    vkDestroyBuffer(allocator->device, buffer, NULL);
+    gpu_free(allocator, allocation);
+}
+
+Result gpu_alloc_image(
+    struct GpuAllocator *allocator,
+    VkImageCreateInfo *image_ci,
+    GpuMemoryUsage usage,
+    VkImage *image,
+    struct GpuAllocation *allocation
+) {
+    ASSERT_NOT_NULL(allocator);
+    ASSERT_NOT_NULL(image_ci);
+    ASSERT_NOT_NULL(image);
+    ASSERT_NOT_NULL(allocation);
+
+    Result result = { 0 };
+    VkMemoryRequirements requirements = { 0 };
+    GpuResourceKind kind = image_ci->tiling == VK_IMAGE_TILING_LINEAR
+        ? GPU_RESOURCE_LINEAR
+        : GPU_RESOURCE_OPTIMAL;
+
+    *image = VK_NULL_HANDLE;
+    memset(allocation, 0, sizeof(struct GpuAllocation));
+
+    result.error = VK_RESULT(vkCreateImage(allocator->device, image_ci, NULL, image));
+    EXPECT_SUCCESS(result);
+
+    vkGetImageMemoryRequirements(allocator->device, *image, &requirements);
+
+    result = gpu_alloc(allocator, &requirements, usage, kind, allocation);
+    EXPECT_SUCCESS(result);
+
+    result.error = VK_RESULT(vkBindImageMemory(allocator->device, *image, allocation->memory, allocation->offset));
+    EXPECT_SUCCESS(result);
+
+    result.object = allocation;
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        gpu_free_image(allocator, *image, allocation);
+        *image = VK_NULL_HANDLE;
+    });
+}
+
+void gpu_free_image(struct GpuAllocator *allocator, VkImage image, struct GpuAllocation *allocation) {
+    ASSERT_NOT_NULL(allocator);
+
+    vkDestroyImage(allocator->device, image, NULL);
+    gpu_free(allocator, allocation);
+}
+
+GpuMemoryStats gpu_memory_stats(struct GpuAllocator *allocator) {
+    ASSERT_NOT_NULL(allocator);
+
+    return allocator->stats;
+}
+
+void drop_gpu_allocator(struct GpuAllocator *allocator) {
+    if (allocator == NULL)
+        goto exit;
+
+    for (uint32_t i = 0; i < allocator->stats.heap_count; ++i) {
+        if (allocator->stats.heaps[i].allocation_count != 0) {
+            warn(
+                LOG_TARGET,
+                LOG_GROUP(struct, "heap #%d: %d allocations are still alive"),
+                i, allocator->stats.heaps[i].allocation_count
+            );
+        }
+    }
+
+    for (uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; ++i) {
+        for (uint32_t j = 0; j < GPU_RESOURCE_KIND_COUNT; ++j) {
+            struct GpuMemoryBlock *block = allocator->pools[i][j].blocks;
+
+            while (block != NULL) {
+                struct GpuMemoryBlock *next = block->next;
+
+                drop_gpu_memory_block(allocator, block);
+                block = next;
+            }
+        }
+    }
+
+    free(allocator);
+
+exit:
+    debug(LOG_TARGET, "drop GPU allocator");
+}
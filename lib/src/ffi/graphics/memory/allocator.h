@@ -0,0 +1,146 @@
+#ifndef ___APRIORI2_GRAPHICS_MEMORY_ALLOCATOR_H___
+#define ___APRIORI2_GRAPHICS_MEMORY_ALLOCATOR_H___
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+
+#include "ffi/core/result.h"
+#include "tlsf.h"
+#include "stats.h"
+
+// Device memory is allocated in large blocks per memory type
+// and sub-allocated with TLSF.
+// Blocks are kept when they become empty,
+// so the steady state (e.g. per-frame buffers) never calls the driver.
+
+#define GPU_MEMORY_BLOCK_SIZE (64ULL << 20)
+
+// Heaps up to this size use 1/8 of the heap as the block size
+#define GPU_MEMORY_SMALL_HEAP_SIZE (1ULL << 30)
+
+// Allocations bigger than a half of the block get a dedicated device memory object
+#define GPU_MEMORY_DEDICATED_THRESHOLD_DIVISOR 2
+
+#define GPU_MEMORY_MAX_BLOCK_ALLOCATIONS 4096
+
+typedef enum GpuMemoryUsage {
+    // GPU only resources (render targets, static meshes, textures)
+    GPU_MEMORY_USAGE_DEVICE_LOCAL,
+
+    // CPU writes, GPU reads once (staging buffers)
+    GPU_MEMORY_USAGE_HOST_UPLOAD,
+
+    // GPU writes, CPU reads (queries, screenshots)
+    GPU_MEMORY_USAGE_HOST_READBACK,
+
+    // CPU writes each frame, GPU reads (uniforms, transient vertices).
+    // Device local host visible memory is preferred if there is one.
+    GPU_MEMORY_USAGE_DYNAMIC
+} GpuMemoryUsage;
+
+// Linear and optimal resources are never placed into the same block:
+// it is how `bufferImageGranularity` is honored without the per-neighbour padding.
+typedef enum GpuResourceKind {
+    GPU_RESOURCE_LINEAR,
+    GPU_RESOURCE_OPTIMAL,
+    GPU_RESOURCE_KIND_COUNT
+} GpuResourceKind;
+
+struct GpuMemoryBlock {
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    uint32_t memory_type_idx;
+
+    // Persistently mapped for the host visible memory types (NULL otherwise)
+    void *mapped;
+
+    // NULL for a dedicated block
+    struct Tlsf *tlsf;
+
+    struct GpuMemoryBlock *next;
+};
+
+struct GpuMemoryPool {
+    struct GpuMemoryBlock *blocks;
+};
+
+struct GpuAllocation {
+    struct GpuMemoryBlock *block;
+    struct TlsfBlock *range;
+
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+
+    // Points to `offset` inside of the block mapping (NULL if not host visible)
+    void *mapped;
+};
+
+struct GpuAllocator {
+    VkDevice device;
+    VkPhysicalDeviceMemoryProperties memory_props;
+    VkDeviceSize buffer_image_granularity;
+
+    uint32_t max_device_allocation_count;
+    uint32_t device_allocation_count;
+
+    VkDeviceSize block_sizes[VK_MAX_MEMORY_HEAPS];
+    struct GpuMemoryPool pools[VK_MAX_MEMORY_TYPES][GPU_RESOURCE_KIND_COUNT];
+
+    GpuMemoryStats stats;
+};
+
+Result new_gpu_allocator(VkPhysicalDevice phy_device, VkDevice device);
+
+bool find_gpu_memory_type(
+    struct GpuAllocator *allocator,
+    uint32_t memory_type_bits,
+    GpuMemoryUsage usage,
+    uint32_t *memory_type_idx
+);
+
+Result gpu_alloc(
+    struct GpuAllocator *allocator,
+    VkMemoryRequirements *requirements,
+    GpuMemoryUsage usage,
+    GpuResourceKind kind,
+    struct GpuAllocation *allocation
+);
+
+void gpu_free(struct GpuAllocator *allocator, struct GpuAllocation *allocation);
+
+// Allocates a block up front, so the first allocations don't call the driver
+Result gpu_allocator_reserve(
+    struct GpuAllocator *allocator,
+    uint32_t memory_type_bits,
+    GpuMemoryUsage usage,
+    GpuResourceKind kind
+);
+
+// Creates the buffer and binds it to a new allocation
+Result gpu_alloc_buffer(
+    struct GpuAllocator *allocator,
+    VkBufferCreateInfo *buffer_ci,
+    GpuMemoryUsage usage,
+    VkBuffer *buffer,
+    struct GpuAllocation *allocation
+);
+
+void gpu_free_buffer(struct GpuAllocator *allocator, VkBuffer buffer, struct GpuAllocation *allocation);
+
+// Creates the image and binds it to a new allocation
+Result gpu_alloc_image(
+    struct GpuAllocator *allocator,
+    VkImageCreateInfo *image_ci,
+    GpuMemoryUsage usage,
+    VkImage *image,
+    struct GpuAllocation *allocation
+);
+
+void gpu_free_image(struct GpuAllocator *allocator, VkImage image, struct GpuAllocation *allocation);
+
+GpuMemoryStats gpu_memory_stats(struct GpuAllocator *allocator);
+
+void drop_gpu_allocator(struct GpuAllocator *allocator);
+
+#endif // ___APRIORI2_GRAPHICS_MEMORY_ALLOCATOR_H___
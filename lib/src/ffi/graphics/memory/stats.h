@@ -0,0 +1,28 @@
+#ifndef ___APRIORI2_GRAPHICS_MEMORY_STATS_H___
+#define ___APRIORI2_GRAPHICS_MEMORY_STATS_H___
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Equals to VK_MAX_MEMORY_HEAPS
+#define GPU_MAX_MEMORY_HEAPS 16
+
+typedef struct GpuHeapStats {
+    uint64_t heap_size;
+    bool is_device_local;
+
+    // Device memory objects allocated from the heap
+    uint32_t block_count;
+    uint64_t allocated_size;
+
+    // Sub-allocations inside of the blocks
+    uint32_t allocation_count;
+    uint64_t used_size;
+} GpuHeapStats;
+
+typedef struct GpuMemoryStats {
+    uint32_t heap_count;
+    GpuHeapStats heaps[GPU_MAX_MEMORY_HEAPS];
+} GpuMemoryStats;
+
+#endif // ___APRIORI2_GRAPHICS_MEMORY_STATS_H___
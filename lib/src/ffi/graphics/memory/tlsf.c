@@ -0,0 +1,311 @@
+#include <string.h>
+
+#include "tlsf.h"
+
+#include "ffi/util/mod.h"
+#include "ffi/core/log.h"
+#include "ffi/math/mod.h"
+
+#ifdef ___windows___
+#   include <intrin.h>
+#endif // ___windows___
+
+#define LOG_TARGET LOG_STRUCT_TARGET(Tlsf)
+
+// Each allocation splits at most one free block into three
+#define TLSF_NODES_PER_ALLOCATION 2
+
+uint32_t tlsf_msb_64(uint64_t value) {
+    assert(value != 0 && "msb of zero is undefined");
+
+#   ifdef ___windows___
+    unsigned long idx = 0;
+    _BitScanReverse64(&idx, value);
+    return idx;
+#   else
+    return 63 - __builtin_clzll(value);
+#   endif // ___windows___
+}
+
+uint32_t tlsf_lsb_32(uint32_t value) {
+    assert(value != 0 && "lsb of zero is undefined");
+
+#   ifdef ___windows___
+    unsigned long idx = 0;
+    _BitScanForward(&idx, value);
+    return idx;
+#   else
+    return __builtin_ctz(value);
+#   endif // ___windows___
+}
+
+uint64_t tlsf_align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void tlsf_mapping(uint64_t size, uint32_t *fl, uint32_t *sl) {
+    if (size < TLSF_SMALL_BLOCK_SIZE) {
+        *fl = 0;
+        *sl = AS(size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_COUNT), uint32_t);
+    } else {
+        uint32_t msb = tlsf_msb_64(size);
+
+        *sl = AS(size >> (msb - TLSF_SL_LOG2), uint32_t) ^ TLSF_SL_COUNT;
+        *fl = msb - (TLSF_FL_INDEX_SHIFT - 1);
+    }
+}
+
+// Rounds the size up to the next list,
+// so any block from that list fits (good-fit instead of the first-fit search)
+void tlsf_mapping_search(uint64_t size, uint32_t *fl, uint32_t *sl) {
+    if (size >= TLSF_SMALL_BLOCK_SIZE)
+        size += (1ULL << (tlsf_msb_64(size) - TLSF_SL_LOG2)) - 1;
+
+    tlsf_mapping(size, fl, sl);
+}
+
+struct TlsfBlock *tlsf_take_node(struct Tlsf *tlsf) {
+    struct TlsfBlock *node = tlsf->unused_nodes;
+
+    assert(node != NULL && "TLSF node pool is exhausted");
+
+    tlsf->unused_nodes = node->next_free;
+    tlsf->node_count -= 1;
+
+    memset(node, 0, sizeof(struct TlsfBlock));
+
+    return node;
+}
+
+void tlsf_release_node(struct Tlsf *tlsf, struct TlsfBlock *node) {
+    node->next_free = tlsf->unused_nodes;
+    tlsf->unused_nodes = node;
+    tlsf->node_count += 1;
+}
+
+void tlsf_insert_free(struct Tlsf *tlsf, struct TlsfBlock *block) {
+    uint32_t fl = 0, sl = 0;
+    tlsf_mapping(block->size, &fl, &sl);
+
+    struct TlsfBlock *head = tlsf->free_lists[fl][sl];
+
+    block->is_free = true;
+    block->prev_free = NULL;
+    block->next_free = head;
+
+    if (head != NULL)
+        head->prev_free = block;
+
+    tlsf->free_lists[fl][sl] = block;
+    tlsf->fl_bitmap |= POW_2(fl, uint32_t);
+    tlsf->sl_bitmaps[fl] |= POW_2(sl, uint32_t);
+}
+
+void tlsf_remove_free(struct Tlsf *tlsf, struct TlsfBlock *block) {
+    uint32_t fl = 0, sl = 0;
+    tlsf_mapping(block->size, &fl, &sl);
+
+    if (block->prev_free != NULL)
+        block->prev_free->next_free = block->next_free;
+
+    if (block->next_free != NULL)
+        block->next_free->prev_free = block->prev_free;
+
+    if (tlsf->free_lists[fl][sl] == block) {
+        tlsf->free_lists[fl][sl] = block->next_free;
+
+        if (block->next_free == NULL) {
+            tlsf->sl_bitmaps[fl] &= ~POW_2(sl, uint32_t);
+
+            if (tlsf->sl_bitmaps[fl] == 0)
+                tlsf->fl_bitmap &= ~POW_2(fl, uint32_t);
+        }
+    }
+
+    block->is_free = false;
+    block->prev_free = NULL;
+    block->next_free = NULL;
+}
+
+struct TlsfBlock *tlsf_find_free(struct Tlsf *tlsf, uint64_t size) {
+    uint32_t fl = 0, sl = 0;
+    uint32_t sl_map = 0, fl_map = 0;
+
+    tlsf_mapping_search(size, &fl, &sl);
+
+    if (fl >= TLSF_FL_COUNT)
+        return NULL;
+
+    sl_map = tlsf->sl_bitmaps[fl] & (~0U << sl);
+    if (sl_map == 0) {
+        fl_map = (fl + 1 < 32) ? (tlsf->fl_bitmap & (~0U << (fl + 1))) : 0;
+        if (fl_map == 0)
+            return NULL;
+
+        fl = tlsf_lsb_32(fl_map);
+        sl_map = tlsf->sl_bitmaps[fl];
+    }
+
+    sl = tlsf_lsb_32(sl_map);
+
+    return tlsf->free_lists[fl][sl];
+}
+
+// Cuts the tail of the block off into a new free block
+void tlsf_split(struct Tlsf *tlsf, struct TlsfBlock *block, uint64_t size) {
+    struct TlsfBlock *remainder = tlsf_take_node(tlsf);
+
+    remainder->offset = block->offset + size;
+    remainder->size = block->size - size;
+    remainder->prev_phys = block;
+    remainder->next_phys = block->next_phys;
+
+    if (block->next_phys != NULL)
+        block->next_phys->prev_phys = remainder;
+
+    block->next_phys = remainder;
+    block->size = size;
+
+    tlsf_insert_free(tlsf, remainder);
+}
+
+// Cuts the head of the block off into a new free block
+void tlsf_split_front(struct Tlsf *tlsf, struct TlsfBlock *block, uint64_t front_size) {
+    struct TlsfBlock *front = tlsf_take_node(tlsf);
+
+    front->offset = block->offset;
+    front->size = front_size;
+    front->prev_phys = block->prev_phys;
+    front->next_phys = block;
+
+    if (block->prev_phys != NULL)
+        block->prev_phys->next_phys = front;
+
+    block->prev_phys = front;
+    block->offset += front_size;
+    block->size -= front_size;
+
+    tlsf_insert_free(tlsf, front);
+}
+
+Result new_tlsf(uint64_t size, uint32_t max_allocations) {
+    assert(size >= TLSF_MIN_ALIGNMENT && size < TLSF_MAX_SIZE && "TLSF size is out of range");
+    assert(max_allocations > 0 && "TLSF max allocations must be greater than 0");
+
+    Result result = { 0 };
+    uint32_t node_capacity = max_allocations * TLSF_NODES_PER_ALLOCATION + 1;
+
+    struct Tlsf *tlsf = ALLOC(result, struct Tlsf);
+
+    tlsf->size = size - size % TLSF_MIN_ALIGNMENT;
+    tlsf->nodes = ALLOC_ARRAY(result, struct TlsfBlock, node_capacity);
+
+    for (uint32_t i = 0; i < node_capacity; ++i)
+        tlsf_release_node(tlsf, &tlsf->nodes[i]);
+
+    struct TlsfBlock *whole = tlsf_take_node(tlsf);
+    whole->offset = 0;
+    whole->size = tlsf->size;
+
+    tlsf_insert_free(tlsf, whole);
+
+    result.object = tlsf;
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_tlsf(tlsf);
+    });
+}
+
+struct TlsfBlock *tlsf_alloc(struct Tlsf *tlsf, uint64_t size, uint64_t alignment) {
+    ASSERT_NOT_NULL(tlsf);
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "alignment must be a power of 2");
+
+    struct TlsfBlock *block = NULL;
+    uint64_t aligned_offset = 0;
+
+    if (tlsf->node_count < TLSF_NODES_PER_ALLOCATION)
+        return NULL;
+
+    alignment = MAX(alignment, TLSF_MIN_ALIGNMENT);
+    size = tlsf_align_up(MAX(size, 1), TLSF_MIN_ALIGNMENT);
+
+    // All block offsets are TLSF_MIN_ALIGNMENT aligned,
+    // so the alignment padding is less than `alignment` for sure
+    block = tlsf_find_free(tlsf, size + alignment - TLSF_MIN_ALIGNMENT);
+    if (block == NULL)
+        return NULL;
+
+    tlsf_remove_free(tlsf, block);
+
+    // The previous block is in use (free neighbours are always merged):
+    // the padding becomes a separate free block
+    aligned_offset = tlsf_align_up(block->offset, alignment);
+    if (aligned_offset != block->offset)
+        tlsf_split_front(tlsf, block, aligned_offset - block->offset);
+
+    if (block->size - size >= TLSF_MIN_ALIGNMENT)
+        tlsf_split(tlsf, block, size);
+
+    tlsf->used_size += block->size;
+    tlsf->allocation_count += 1;
+
+    return block;
+}
+
+void tlsf_free(struct Tlsf *tlsf, struct TlsfBlock *block) {
+    ASSERT_NOT_NULL(tlsf);
+    ASSERT_NOT_NULL(block);
+    assert(!block->is_free && "TLSF double free");
+
+    struct TlsfBlock *prev = block->prev_phys;
+    struct TlsfBlock *next = block->next_phys;
+
+    tlsf->used_size -= block->size;
+    tlsf->allocation_count -= 1;
+
+    if (prev != NULL && prev->is_free) {
+        tlsf_remove_free(tlsf, prev);
+
+        prev->size += block->size;
+        prev->next_phys = next;
+
+        if (next != NULL)
+            next->prev_phys = prev;
+
+        tlsf_release_node(tlsf, block);
+        block = prev;
+    }
+
+    if (next != NULL && next->is_free) {
+        tlsf_remove_free(tlsf, next);
+
+        block->size += next->size;
+        block->next_phys = next->next_phys;
+
+        if (next->next_phys != NULL)
+            next->next_phys->prev_phys = block;
+
+        tlsf_release_node(tlsf, next);
+    }
+
+    tlsf_insert_free(tlsf, block);
+}
+
+bool is_tlsf_empty(struct Tlsf *tlsf) {
+    ASSERT_NOT_NULL(tlsf);
+
+    return tlsf->allocation_count == 0;
+}
+
+void drop_tlsf(struct Tlsf *tlsf) {
+    if (tlsf == NULL)
+        goto exit;
+
+    free(tlsf->nodes);
+    free(tlsf);
+
+exit:
+    trace(LOG_TARGET, "drop TLSF");
+}
@@ -0,0 +1,71 @@
+#ifndef ___APRIORI2_GRAPHICS_MEMORY_TLSF_H___
+#define ___APRIORI2_GRAPHICS_MEMORY_TLSF_H___
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ffi/core/result.h"
+
+// Two-Level Segregated Fit sub-allocator of an offset range.
+// The block metadata is kept apart from the managed range:
+// the range is GPU memory, it can't hold the block headers.
+//
+// Both allocation and free are O(1).
+
+#define TLSF_ALIGN_LOG2 4
+#define TLSF_MIN_ALIGNMENT (1ULL << TLSF_ALIGN_LOG2)
+
+#define TLSF_SL_LOG2 5
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+
+#define TLSF_FL_INDEX_SHIFT (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_INDEX_MAX 40
+#define TLSF_FL_COUNT (TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1)
+
+#define TLSF_SMALL_BLOCK_SIZE (1ULL << TLSF_FL_INDEX_SHIFT)
+
+#define TLSF_MAX_SIZE (1ULL << TLSF_FL_INDEX_MAX)
+
+struct TlsfBlock {
+    uint64_t offset;
+    uint64_t size;
+    bool is_free;
+
+    // Neighbours in the managed range
+    struct TlsfBlock *prev_phys;
+    struct TlsfBlock *next_phys;
+
+    // Neighbours in the free list (`next_free` also links the unused nodes)
+    struct TlsfBlock *prev_free;
+    struct TlsfBlock *next_free;
+};
+
+struct Tlsf {
+    uint64_t size;
+    uint64_t used_size;
+    uint32_t allocation_count;
+
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmaps[TLSF_FL_COUNT];
+    struct TlsfBlock *free_lists[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+    // Preallocated block nodes: the allocation never calls malloc
+    struct TlsfBlock *nodes;
+    struct TlsfBlock *unused_nodes;
+    uint32_t node_count;
+};
+
+// `max_allocations` bounds the number of live allocations
+Result new_tlsf(uint64_t size, uint32_t max_allocations);
+
+// Returns NULL if there is no suitable free block.
+// `alignment` must be a power of 2.
+struct TlsfBlock *tlsf_alloc(struct Tlsf *tlsf, uint64_t size, uint64_t alignment);
+
+void tlsf_free(struct Tlsf *tlsf, struct TlsfBlock *block);
+
+bool is_tlsf_empty(struct Tlsf *tlsf);
+
+void drop_tlsf(struct Tlsf *tlsf);
+
+#endif // ___APRIORI2_GRAPHICS_MEMORY_TLSF_H___
@@ -0,0 +1,118 @@
+#include "swapchain.h"
+
+#include "ffi/util/mod.h"
+#include "ffi/core/log.h"
+
+#define LOG_TARGET LOG_SUB_TARGET( \
+    LOG_STRUCT_TARGET(Swapchain), LOG_STRUCT_TARGET(Offscreen) \
+)
+
+Result new_offscreen_swapchain(struct SwapchainCreateParams *params) {
+    ASSERT_NOT_NULL(params);
+    ASSERT_NOT_NULL(params->phy_device);
+    ASSERT_NOT_NULL(params->device);
+    ASSERT_NOT_NULL(params->allocator);
+
+    Result result = { 0 };
+    VkImageCreateInfo image_ci = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+    VkImageViewCreateInfo image_view_ci = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D
+    };
+    VkComponentMapping iv_components = {
+        .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+        .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+        .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+        .a = VK_COMPONENT_SWIZZLE_IDENTITY,
+    };
+    VkImageSubresourceRange iv_subresource_range = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseArrayLayer = 0,
+        .baseMipLevel = 0,
+        .layerCount = 1,
+        .levelCount = 1
+    };
+
+    info(LOG_TARGET, "creating new offscreen swapchain...");
+
+    struct Swapchain *swapchain = ALLOC(result, struct Swapchain);
+
+    swapchain->device = params->device;
+    swapchain->allocator = params->allocator;
+    swapchain->image_count = OFFSCREEN_SWAPCHAIN_IMAGE_COUNT;
+    swapchain->image_format = params->surface_format.format;
+    swapchain->image_extent = params->image_extent;
+    swapchain->present_policy = params->present_policy;
+    swapchain->present_mode = PRESENT_MODE_NONE;
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "image count: %d, image extent: %dx%d"),
+        swapchain->image_count,
+        params->image_extent.width,
+        params->image_extent.height
+    );
+
+    swapchain->offscreen_allocations = ALLOC_ARRAY(result, struct GpuAllocation, swapchain->image_count);
+    swapchain->images = ALLOC_ARRAY(result, VkImage, swapchain->image_count);
+    swapchain->views = ALLOC_ARRAY(result, VkImageView, swapchain->image_count);
+
+    image_ci.format = params->surface_format.format;
+    image_ci.extent.width = params->image_extent.width;
+    image_ci.extent.height = params->image_extent.height;
+    image_ci.extent.depth = 1;
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "creating new offscreen images..."));
+
+    for (uint32_t i = 0; i < swapchain->image_count; ++i) {
+        result = gpu_alloc_image(
+            params->allocator,
+            &image_ci,
+            GPU_MEMORY_USAGE_DEVICE_LOCAL,
+            &swapchain->images[i],
+            &swapchain->offscreen_allocations[i]
+        );
+        EXPECT_SUCCESS(result);
+    }
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "new offscreen images created successfully"));
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "creating new offscreen image views..."));
+
+    image_view_ci.format = params->surface_format.format;
+    image_view_ci.components = iv_components;
+    image_view_ci.subresourceRange = iv_subresource_range;
+
+    for (uint32_t i = 0; i < swapchain->image_count; ++i) {
+        image_view_ci.image = swapchain->images[i];
+
+        result.error = VK_RESULT(vkCreateImageView(
+            params->device,
+            &image_view_ci,
+            NULL,
+            &swapchain->views[i]
+        ));
+        EXPECT_SUCCESS(result);
+    }
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "new offscreen image views created successfully"));
+
+    result.object = swapchain;
+    info(LOG_TARGET, "new offscreen swapchain created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_swapchain(swapchain);
+    });
+}
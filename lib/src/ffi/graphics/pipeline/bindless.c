@@ -0,0 +1,269 @@
+#include <string.h>
+
+#include "bindless.h"
+
+#include "ffi/core/log.h"
+#include "ffi/util/mod.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(BindlessTable)
+
+#define BINDLESS_TEXTURE_BINDING_FLAGS \
+    (VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT \
+    | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT \
+    | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT)
+
+Result check_bindless_support(
+    VkPhysicalDevice phy_device,
+    const VkPhysicalDeviceProperties *props,
+    bool *is_supported
+) {
+    ASSERT_NOT_NULL(phy_device);
+    ASSERT_NOT_NULL(props);
+    ASSERT_NOT_NULL(is_supported);
+
+    Result result = { 0 };
+    VkExtensionProperties *extension_props = NULL;
+    uint32_t property_count = 0;
+    bool is_extension_found = false;
+    VkPhysicalDeviceDescriptorIndexingFeatures indexing_features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES
+    };
+    VkPhysicalDeviceFeatures2 features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2
+    };
+    features.pNext = &indexing_features;
+
+    *is_supported = false;
+
+    // The extended features query is core in Vulkan 1.1
+    if (props->apiVersion < VK_API_VERSION_1_1) {
+        trace(LOG_TARGET, LOG_GROUP(struct, "Vulkan 1.1 is not supported"));
+        goto exit;
+    }
+
+    result.error = VK_RESULT(vkEnumerateDeviceExtensionProperties(phy_device, NULL, &property_count, NULL));
+    EXPECT_SUCCESS(result);
+
+    extension_props = ALLOC_ARRAY_UNINIT(result, VkExtensionProperties, property_count);
+
+    result.error = VK_RESULT(vkEnumerateDeviceExtensionProperties(phy_device, NULL, &property_count, extension_props));
+    EXPECT_SUCCESS(result);
+
+    for (uint32_t i = 0; i < property_count && !is_extension_found; ++i)
+        is_extension_found = !strcmp(extension_props[i].extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+
+    if (!is_extension_found) {
+        trace(LOG_TARGET, LOG_GROUP(struct, "descriptor indexing is not supported"));
+        goto exit;
+    }
+
+    vkGetPhysicalDeviceFeatures2(phy_device, &features);
+
+    *is_supported = features.features.shaderSampledImageArrayDynamicIndexing
+        && indexing_features.descriptorBindingSampledImageUpdateAfterBind
+        && indexing_features.descriptorBindingUpdateUnusedWhilePending
+        && indexing_features.descriptorBindingPartiallyBound;
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "bindless features: %s"),
+        *is_supported ? "OK" : "missing"
+    );
+
+    FN_FORCE_EXIT(result, {
+        free(extension_props);
+    });
+}
+
+VkPhysicalDeviceDescriptorIndexingFeatures bindless_device_features() {
+    VkPhysicalDeviceDescriptorIndexingFeatures features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+        .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+        .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+        .descriptorBindingPartiallyBound = VK_TRUE
+    };
+
+    return features;
+}
+
+Result new_bindless_table(VkDevice device) {
+    ASSERT_NOT_NULL(device);
+
+    Result result = { 0 };
+    // Texel coordinates (the overlay), see `BINDLESS_SAMPLER_TEXEL`
+    VkSamplerCreateInfo sampler_cis[BINDLESS_SAMPLER_COUNT] = {
+        {
+            .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+            .magFilter = VK_FILTER_LINEAR,
+            .minFilter = VK_FILTER_LINEAR,
+            .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+            .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
+            .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
+            .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
+            .borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK,
+            .unnormalizedCoordinates = VK_TRUE
+        }
+    };
+    VkDescriptorSetLayoutBinding bindings[] = {
+        {
+            .binding = BINDLESS_TEXTURES_BINDING,
+            .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            .descriptorCount = BINDLESS_MAX_TEXTURES,
+            .stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS
+        },
+        {
+            .binding = BINDLESS_SAMPLERS_BINDING,
+            .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+            .descriptorCount = BINDLESS_SAMPLER_COUNT,
+            .stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS
+        }
+    };
+    VkDescriptorBindingFlags binding_flags[] = {
+        BINDLESS_TEXTURE_BINDING_FLAGS,
+        0
+    };
+    VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_ci = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = STATIC_ARRAY_SIZE(binding_flags)
+    };
+    VkDescriptorSetLayoutCreateInfo layout_ci = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        .bindingCount = STATIC_ARRAY_SIZE(bindings)
+    };
+    // The immutable samplers are counted by the pool as well
+    VkDescriptorPoolSize pool_sizes[] = {
+        {
+            .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            .descriptorCount = BINDLESS_MAX_TEXTURES
+        },
+        {
+            .type = VK_DESCRIPTOR_TYPE_SAMPLER,
+            .descriptorCount = BINDLESS_SAMPLER_COUNT
+        }
+    };
+    VkDescriptorPoolCreateInfo pool_ci = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets = 1,
+        .poolSizeCount = STATIC_ARRAY_SIZE(pool_sizes)
+    };
+    VkDescriptorSetAllocateInfo set_ai = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorSetCount = 1
+    };
+
+    info(LOG_TARGET, "creating new bindless table...");
+
+    struct BindlessTable *table = ALLOC(result, struct BindlessTable);
+
+    table->device = device;
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "max textures: %d"), BINDLESS_MAX_TEXTURES);
+
+    for (uint32_t i = 0; i < BINDLESS_SAMPLER_COUNT; ++i) {
+        result.error = VK_RESULT(vkCreateSampler(device, &sampler_cis[i], NULL, &table->samplers[i]));
+        EXPECT_SUCCESS(result);
+    }
+
+    bindings[1].pImmutableSamplers = table->samplers;
+    binding_flags_ci.pBindingFlags = binding_flags;
+    layout_ci.pNext = &binding_flags_ci;
+    layout_ci.pBindings = bindings;
+
+    result.error = VK_RESULT(vkCreateDescriptorSetLayout(device, &layout_ci, NULL, &table->layout));
+    EXPECT_SUCCESS(result);
+
+    pool_ci.pPoolSizes = pool_sizes;
+
+    result.error = VK_RESULT(vkCreateDescriptorPool(device, &pool_ci, NULL, &table->pool));
+    EXPECT_SUCCESS(result);
+
+    set_ai.descriptorPool = table->pool;
+    set_ai.pSetLayouts = &table->layout;
+
+    result.error = VK_RESULT(vkAllocateDescriptorSets(device, &set_ai, &table->set));
+    EXPECT_SUCCESS(result);
+
+    table->free_indices = ALLOC_ARRAY_UNINIT(result, uint32_t, BINDLESS_MAX_TEXTURES);
+
+    // The lowest slots are popped first
+    for (uint32_t i = 0; i < BINDLESS_MAX_TEXTURES; ++i)
+        table->free_indices[i] = BINDLESS_MAX_TEXTURES - 1 - i;
+
+    table->free_count = BINDLESS_MAX_TEXTURES;
+
+    result.object = table;
+    info(LOG_TARGET, "new bindless table created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_bindless_table(table);
+    });
+}
+
+Result bindless_add_texture(
+    struct BindlessTable *table,
+    VkImageView view,
+    VkImageLayout layout,
+    uint32_t *texture_idx
+) {
+    ASSERT_NOT_NULL(table);
+    ASSERT_NOT_NULL(view);
+    ASSERT_NOT_NULL(texture_idx);
+
+    Result result = { 0 };
+    VkDescriptorImageInfo image_info = {
+        .imageLayout = layout
+    };
+    VkWriteDescriptorSet write = {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstBinding = BINDLESS_TEXTURES_BINDING,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
+    };
+
+    if (table->free_count == 0) {
+        result.error = BINDLESS_TABLE_FULL;
+        EXPECT_SUCCESS(result);
+    }
+
+    *texture_idx = table->free_indices[--table->free_count];
+
+    image_info.imageView = view;
+    write.dstSet = table->set;
+    write.dstArrayElement = *texture_idx;
+    write.pImageInfo = &image_info;
+
+    vkUpdateDescriptorSets(table->device, 1, &write, 0, NULL);
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "texture #%d added"), *texture_idx);
+
+    FN_FORCE_EXIT(result);
+}
+
+void bindless_remove_texture(struct BindlessTable *table, uint32_t texture_idx) {
+    ASSERT_NOT_NULL(table);
+    assert(texture_idx < BINDLESS_MAX_TEXTURES && "bindless texture index is out of range");
+
+    // The stale descriptor stays: the partially bound slots are never accessed
+    table->free_indices[table->free_count++] = texture_idx;
+}
+
+void drop_bindless_table(struct BindlessTable *table) {
+    if (table == NULL)
+        goto exit;
+
+    vkDestroyDescriptorPool(table->device, table->pool, NULL);
+    vkDestroyDescriptorSetLayout(table->device, table->layout, NULL);
+
+    for (uint32_t i = 0; i < BINDLESS_SAMPLER_COUNT; ++i)
+        vkDestroySampler(table->device, table->samplers[i], NULL);
+
+    free(table->free_indices);
+    free(table);
+
+exit:
+    debug(LOG_TARGET, "drop bindless table");
+}
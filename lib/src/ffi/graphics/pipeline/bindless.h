@@ -0,0 +1,58 @@
+#ifndef ___APRIORI2_GRAPHICS_PIPELINE_BINDLESS_H___
+#define ___APRIORI2_GRAPHICS_PIPELINE_BINDLESS_H___
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ffi/core/result.h"
+#include "bindless_info.h"
+
+#define BINDLESS_NULL_TEXTURE_IDX UINT32_MAX
+
+// A single update-after-bind, partially bound array of sampled images.
+// It is bound once per frame, the draws select the textures by index.
+//
+// Requires `VK_EXT_descriptor_indexing` (core in Vulkan 1.2),
+// the renderer falls back to the per-resource descriptor sets without it.
+
+struct BindlessTable {
+    VkDevice device;
+
+    VkSampler samplers[BINDLESS_SAMPLER_COUNT];
+    VkDescriptorSetLayout layout;
+    VkDescriptorPool pool;
+    VkDescriptorSet set;
+
+    // Free texture slots (a stack)
+    uint32_t *free_indices;
+    uint32_t free_count;
+};
+
+// Checks the extension and the device features the bindless table relies on
+Result check_bindless_support(
+    VkPhysicalDevice phy_device,
+    const VkPhysicalDeviceProperties *props,
+    bool *is_supported
+);
+
+// The features to chain into the device create info (the extension is enabled separately)
+VkPhysicalDeviceDescriptorIndexingFeatures bindless_device_features();
+
+Result new_bindless_table(VkDevice device);
+
+// The slot is usable by the draws recorded after the call:
+// the set is updated after bind, the frames in flight are not affected
+Result bindless_add_texture(
+    struct BindlessTable *table,
+    VkImageView view,
+    VkImageLayout layout,
+    uint32_t *texture_idx
+);
+
+// The slot must not be used by the frames in flight anymore
+void bindless_remove_texture(struct BindlessTable *table, uint32_t texture_idx);
+
+void drop_bindless_table(struct BindlessTable *table);
+
+#endif // ___APRIORI2_GRAPHICS_PIPELINE_BINDLESS_H___
@@ -0,0 +1,16 @@
+#ifndef ___APRIORI2_GRAPHICS_PIPELINE_BINDLESS_INFO_H___
+#define ___APRIORI2_GRAPHICS_PIPELINE_BINDLESS_INFO_H___
+
+// The bindless descriptor set shared by the pipelines:
+// the textures are selected by index (e.g. from push constants)
+#define BINDLESS_TEXTURES_BINDING 0
+#define BINDLESS_SAMPLERS_BINDING 1
+
+// Well below the update-after-bind limits guaranteed with the descriptor indexing
+#define BINDLESS_MAX_TEXTURES 4096
+
+// Immutable samplers of the bindless set
+#define BINDLESS_SAMPLER_TEXEL 0
+#define BINDLESS_SAMPLER_COUNT 1
+
+#endif // ___APRIORI2_GRAPHICS_PIPELINE_BINDLESS_INFO_H___
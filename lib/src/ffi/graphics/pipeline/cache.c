@@ -0,0 +1,213 @@
+#include <string.h>
+
+#include "cache.h"
+
+#include "ffi/util/mod.h"
+#include "ffi/core/log.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(PipelineCache)
+
+bool is_pipeline_cache_data_valid(
+    const struct PipelineCacheFileHeader *expected_header,
+    DynArray file_content
+) {
+    ASSERT_NOT_NULL(expected_header);
+    ASSERT_NOT_NULL(file_content);
+
+    const struct PipelineCacheFileHeader *file_header = file_content->data;
+    const VkPipelineCacheHeaderVersionOne *vk_header = NULL;
+
+    if (file_content->count < sizeof(struct PipelineCacheFileHeader)) {
+        warn(LOG_TARGET, LOG_GROUP(struct, "cache file is truncated"));
+        return false;
+    }
+
+    if (
+        file_header->magic != expected_header->magic
+        || file_header->version != expected_header->version
+    ) {
+        warn(LOG_TARGET, LOG_GROUP(struct, "cache file has unknown format"));
+        return false;
+    }
+
+    if (
+        file_header->vendor_id != expected_header->vendor_id
+        || file_header->device_id != expected_header->device_id
+        || file_header->driver_version != expected_header->driver_version
+        || memcmp(file_header->uuid, expected_header->uuid, VK_UUID_SIZE) != 0
+    ) {
+        warn(LOG_TARGET, LOG_GROUP(struct, "cache file belongs to another device or driver"));
+        return false;
+    }
+
+    if (
+        file_header->data_size < sizeof(VkPipelineCacheHeaderVersionOne)
+        || file_header->data_size != file_content->count - sizeof(struct PipelineCacheFileHeader)
+    ) {
+        warn(LOG_TARGET, LOG_GROUP(struct, "cache file data size mismatch"));
+        return false;
+    }
+
+    vk_header = (const VkPipelineCacheHeaderVersionOne *)(file_header + 1);
+
+    if (
+        vk_header->headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        || vk_header->vendorID != expected_header->vendor_id
+        || vk_header->deviceID != expected_header->device_id
+        || memcmp(vk_header->pipelineCacheUUID, expected_header->uuid, VK_UUID_SIZE) != 0
+    ) {
+        warn(LOG_TARGET, LOG_GROUP(struct, "cache data header mismatch"));
+        return false;
+    }
+
+    return true;
+}
+
+Result new_pipeline_cache(
+    VkDevice device,
+    const VkPhysicalDeviceProperties *phy_device_props,
+    const char *file_path
+) {
+    ASSERT_NOT_NULL(device);
+    ASSERT_NOT_NULL(phy_device_props);
+
+    Result result = { 0 };
+    struct PipelineCache *cache = NULL;
+    DynArray file_content = NULL;
+    VkPipelineCacheCreateInfo cache_ci = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO
+    };
+
+    info(LOG_TARGET, "creating new pipeline cache...");
+
+    cache = ALLOC(result, struct PipelineCache);
+
+    cache->device = device;
+    cache->file_header.magic = PIPELINE_CACHE_FILE_MAGIC;
+    cache->file_header.version = PIPELINE_CACHE_FILE_VERSION;
+    cache->file_header.vendor_id = phy_device_props->vendorID;
+    cache->file_header.device_id = phy_device_props->deviceID;
+    cache->file_header.driver_version = phy_device_props->driverVersion;
+    memcpy(cache->file_header.uuid, phy_device_props->pipelineCacheUUID, VK_UUID_SIZE);
+
+    if (file_path != NULL) {
+        size_t file_path_size = strlen(file_path) + 1;
+
+        cache->file_path = ALLOC_ARRAY(result, char, file_path_size);
+        memcpy(cache->file_path, file_path, file_path_size);
+
+        trace(LOG_TARGET, LOG_GROUP(struct, "loading cache file \"%s\"..."), file_path);
+
+        result = read_binary_file(file_path);
+        if (result.error == SUCCESS) {
+            file_content = result.object;
+
+            if (is_pipeline_cache_data_valid(&cache->file_header, file_content)) {
+                cache_ci.initialDataSize = file_content->count - sizeof(struct PipelineCacheFileHeader);
+                cache_ci.pInitialData = AS(file_content->data, Bytes) + sizeof(struct PipelineCacheFileHeader);
+
+                cache->stats.is_warm = true;
+                cache->stats.loaded_data_size = cache_ci.initialDataSize;
+            }
+        } else {
+            trace(LOG_TARGET, LOG_GROUP(struct, "cache file is not available"));
+        }
+
+        result.error = SUCCESS;
+    }
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "cache state: %s (initial data size: %zu)"),
+        cache->stats.is_warm ? "warm" : "cold",
+        cache_ci.initialDataSize
+    );
+
+    result.error = VK_RESULT(vkCreatePipelineCache(
+        device,
+        &cache_ci,
+        NULL,
+        &cache->vk_handle
+    ));
+    EXPECT_SUCCESS(result);
+
+    result.object = cache;
+    info(LOG_TARGET, "new pipeline cache created successfully");
+
+    FN_EXIT(result, {
+        free(file_content);
+    });
+
+    FN_FAILURE(result, {
+        drop_pipeline_cache(cache);
+    });
+}
+
+Result store_pipeline_cache(struct PipelineCache *cache) {
+    ASSERT_NOT_NULL(cache);
+
+    Result result = { 0 };
+    size_t data_size = 0;
+    Bytes file_content = NULL;
+
+    if (cache->file_path == NULL)
+        goto exit;
+
+    info(LOG_TARGET, "storing pipeline cache...");
+
+    result.error = VK_RESULT(vkGetPipelineCacheData(
+        cache->device,
+        cache->vk_handle,
+        &data_size,
+        NULL
+    ));
+    EXPECT_SUCCESS(result);
+
+    file_content = ALLOC_ARRAY_UNINIT(
+        result,
+        Byte,
+        sizeof(struct PipelineCacheFileHeader) + data_size
+    );
+
+    result.error = VK_RESULT(vkGetPipelineCacheData(
+        cache->device,
+        cache->vk_handle,
+        &data_size,
+        file_content + sizeof(struct PipelineCacheFileHeader)
+    ));
+    EXPECT_SUCCESS(result);
+
+    cache->file_header.data_size = data_size;
+    memcpy(file_content, &cache->file_header, sizeof(struct PipelineCacheFileHeader));
+
+    // A crash in the middle of the store keeps the previous cache file
+    result = replace_binary_file(
+        cache->file_path,
+        file_content,
+        sizeof(struct PipelineCacheFileHeader) + data_size
+    );
+    EXPECT_SUCCESS(result);
+
+    info(
+        LOG_TARGET,
+        "pipeline cache stored successfully to \"%s\" (data size: %zu)",
+        cache->file_path, data_size
+    );
+
+    FN_FORCE_EXIT(result, {
+        free(file_content);
+    });
+}
+
+void drop_pipeline_cache(struct PipelineCache *cache) {
+    if (cache == NULL)
+        goto exit;
+
+    vkDestroyPipelineCache(cache->device, cache->vk_handle, NULL);
+
+    free(cache->file_path);
+    free(cache);
+
+exit:
+    debug(LOG_TARGET, "drop pipeline cache");
+}
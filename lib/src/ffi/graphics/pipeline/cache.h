@@ -0,0 +1,47 @@
+#ifndef ___APRIORI2_GRAPHICS_PIPELINE_CACHE_H___
+#define ___APRIORI2_GRAPHICS_PIPELINE_CACHE_H___
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+
+#include "ffi/core/result.h"
+#include "stats.h"
+
+// "APC2" -- Apriori Pipeline Cache
+#define PIPELINE_CACHE_FILE_MAGIC 0x32435041
+#define PIPELINE_CACHE_FILE_VERSION 1
+
+// Precedes the Vulkan pipeline cache data in the cache file.
+// Vulkan's own cache header has no driver version,
+// so the whole device identity is stored here.
+struct PipelineCacheFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint8_t uuid[VK_UUID_SIZE];
+    uint64_t data_size;
+};
+
+struct PipelineCache {
+    VkDevice device;
+    VkPipelineCache vk_handle;
+    struct PipelineCacheFileHeader file_header;
+    char *file_path;
+
+    PipelineCacheStats stats;
+};
+
+// `file_path` can be NULL, the cache is not persistent in that case
+Result new_pipeline_cache(
+    VkDevice device,
+    const VkPhysicalDeviceProperties *phy_device_props,
+    const char *file_path
+);
+
+Result store_pipeline_cache(struct PipelineCache *cache);
+
+void drop_pipeline_cache(struct PipelineCache *cache);
+
+#endif // ___APRIORI2_GRAPHICS_PIPELINE_CACHE_H___
@@ -0,0 +1,778 @@
+#include <string.h>
+#include <stdint.h>
+
+#include "atlas.h"
+#include "pipeline_overlay.impl.h"
+
+#include "ffi/core/log.h"
+#include "ffi/util/mod.h"
+#include "ffi/math/mod.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(OverlayAtlas)
+
+#define OVL_ATLAS_IMAGE_IDX_MASK (POW_2(OVL_ATLAS_IMAGE_IDX_BITS, uint32_t) - 1)
+
+static_assert(OVL_ATLAS_MAX_IMAGES <= OVL_ATLAS_IMAGE_IDX_MASK, "overlay image index must fit into the id");
+
+bool is_concurrent_overlay_atlas(struct OverlayAtlas *atlas) {
+    return atlas->families->graphics_idx != atlas->families->transfer_idx;
+}
+
+// Copies the `width` x `height` texels surrounded by their edge texels
+// replicated `left`, `top`, `right` and `bottom` times
+void extrude_overlay_texels(
+    Byte *dst,
+    const Byte *src,
+    uint32_t width,
+    uint32_t height,
+    uint32_t left,
+    uint32_t top,
+    uint32_t right,
+    uint32_t bottom
+) {
+    uint32_t dst_width = left + width + right;
+    uint32_t dst_height = top + height + bottom;
+
+    for (uint32_t y = 0; y < dst_height; ++y) {
+        uint32_t src_y = AS(CLAMP(AS(y, int64_t) - top, 0, height - 1), uint32_t);
+
+        for (uint32_t x = 0; x < dst_width; ++x) {
+            uint32_t src_x = AS(CLAMP(AS(x, int64_t) - left, 0, width - 1), uint32_t);
+
+            memcpy(
+                &dst[(y * dst_width + x) * OVL_ATLAS_TEXEL_SIZE],
+                &src[(src_y * width + src_x) * OVL_ATLAS_TEXEL_SIZE],
+                OVL_ATLAS_TEXEL_SIZE
+            );
+        }
+    }
+}
+
+// An image drawn by one of the last `frame_count` frames can still be sampled by the GPU
+bool is_overlay_image_read_in_flight(struct OverlayAtlas *atlas, struct OverlayAtlasImage *image) {
+    return image->is_drawn && atlas->frame_idx - image->last_drawn_frame <= atlas->frame_count;
+}
+
+// Uploads the texels of the region of the image,
+// the region edges lying on the image edges are extruded into the padding
+Result upload_overlay_atlas_region(
+    struct OverlayAtlas *atlas,
+    struct OverlayAtlasImage *image,
+    const VkRect2D *region,
+    const void *pixels
+) {
+    Result result = { 0 };
+    struct OverlayAtlasPage *page = &atlas->pages[image->page_idx];
+    uint32_t left = region->offset.x == 0 ? OVL_ATLAS_PADDING : 0;
+    uint32_t top = region->offset.y == 0 ? OVL_ATLAS_PADDING : 0;
+    uint32_t right = region->offset.x + region->extent.width == image->width ? OVL_ATLAS_PADDING : 0;
+    uint32_t bottom = region->offset.y + region->extent.height == image->height ? OVL_ATLAS_PADDING : 0;
+    uint32_t width = left + region->extent.width + right;
+    uint32_t height = top + region->extent.height + bottom;
+    VkDeviceSize size = AS(width, VkDeviceSize) * height * OVL_ATLAS_TEXEL_SIZE;
+    VkBufferImageCopy copy_region = {
+        .imageSubresource = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        }
+    };
+    struct StagingDst dst = {
+        .stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        .access = VK_ACCESS_SHADER_READ_BIT
+    };
+
+    dst.sharing_mode = is_concurrent_overlay_atlas(atlas)
+        ? VK_SHARING_MODE_CONCURRENT
+        : VK_SHARING_MODE_EXCLUSIVE;
+    dst.is_read_in_flight = is_overlay_image_read_in_flight(atlas, image);
+
+    copy_region.imageOffset.x = AS(image->x + region->offset.x - left, int32_t);
+    copy_region.imageOffset.y = AS(image->y + region->offset.y - top, int32_t);
+    copy_region.imageExtent.width = width;
+    copy_region.imageExtent.height = height;
+    copy_region.imageExtent.depth = 1;
+
+    Byte *texels = ALLOC_ARRAY_UNINIT(result, Byte, size);
+
+    extrude_overlay_texels(
+        texels,
+        pixels,
+        region->extent.width,
+        region->extent.height,
+        left, top, right, bottom
+    );
+
+    result = staging_upload_image(
+        atlas->staging,
+        texels,
+        size,
+        page->image,
+        &copy_region,
+        page->upload_layout,
+        VK_IMAGE_LAYOUT_GENERAL,
+        &dst
+    );
+    EXPECT_SUCCESS(result);
+
+    // The pending copy must not be overwritten by the reuse of the page space
+    page->last_used_frame = atlas->frame_idx;
+    atlas->pending_uploaded_texel_count += AS(width, uint64_t) * height;
+
+    FN_FORCE_EXIT(result, {
+        free(texels);
+    });
+}
+
+// Finds the lowest position (then the tightest node) the rect fits at
+bool find_skyline_position(
+    struct OverlayAtlasPage *page,
+    uint32_t width,
+    uint32_t height,
+    uint32_t *node_idx,
+    uint32_t *y
+) {
+    bool is_found = false;
+    uint32_t best_bottom = UINT32_MAX;
+    uint32_t best_width = UINT32_MAX;
+
+    for (uint32_t i = 0; i < page->node_count; ++i) {
+        struct OverlaySkylineNode *node = &page->skyline[i];
+        uint32_t top = 0;
+        uint32_t covered_width = 0;
+
+        if (node->x + width > OVL_ATLAS_PAGE_SIZE)
+            break;
+
+        for (uint32_t j = i; covered_width < width; ++j) {
+            top = MAX(top, page->skyline[j].y);
+            covered_width += page->skyline[j].width;
+        }
+
+        if (top + height > OVL_ATLAS_PAGE_SIZE)
+            continue;
+
+        if (
+            top + height < best_bottom
+            || (top + height == best_bottom && node->width < best_width)
+        ) {
+            is_found = true;
+            best_bottom = top + height;
+            best_width = node->width;
+            *node_idx = i;
+            *y = top;
+        }
+    }
+
+    return is_found;
+}
+
+void insert_skyline_node(
+    struct OverlayAtlasPage *page,
+    uint32_t node_idx,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height
+) {
+    struct OverlaySkylineNode new_node = {
+        .x = page->skyline[node_idx].x,
+        .y = y + height,
+        .width = width
+    };
+    uint32_t new_end = new_node.x + new_node.width;
+    uint32_t shadowed_end = node_idx;
+
+    // Drops the nodes covered by the new one and cuts the partially covered one
+    while (shadowed_end < page->node_count) {
+        struct OverlaySkylineNode *node = &page->skyline[shadowed_end];
+
+        if (node->x + node->width <= new_end) {
+            shadowed_end += 1;
+            continue;
+        }
+
+        if (node->x < new_end) {
+            node->width -= new_end - node->x;
+            node->x = new_end;
+        }
+
+        break;
+    }
+
+    memmove(
+        &page->skyline[node_idx + 1],
+        &page->skyline[shadowed_end],
+        (page->node_count - shadowed_end) * sizeof(struct OverlaySkylineNode)
+    );
+    page->node_count = page->node_count - (shadowed_end - node_idx) + 1;
+    page->skyline[node_idx] = new_node;
+
+    // Merges the neighbours of the same height
+    for (uint32_t i = 0; i + 1 < page->node_count;) {
+        if (page->skyline[i].y != page->skyline[i + 1].y) {
+            ++i;
+            continue;
+        }
+
+        page->skyline[i].width += page->skyline[i + 1].width;
+
+        memmove(
+            &page->skyline[i + 1],
+            &page->skyline[i + 2],
+            (page->node_count - i - 2) * sizeof(struct OverlaySkylineNode)
+        );
+        page->node_count -= 1;
+    }
+}
+
+// `width` and `height` include the padding
+bool pack_overlay_atlas_rect(
+    struct OverlayAtlasPage *page,
+    uint32_t width,
+    uint32_t height,
+    uint32_t *x,
+    uint32_t *y
+) {
+    uint32_t node_idx = 0;
+
+    if (!find_skyline_position(page, width, height, &node_idx, y))
+        return false;
+
+    *x = page->skyline[node_idx].x;
+    insert_skyline_node(page, node_idx, *y, width, height);
+
+    page->used_texel_count += AS(width, uint64_t) * height;
+
+    return true;
+}
+
+// The white block stays in place: it is the first rect packed into the empty page
+void reset_overlay_atlas_skyline(struct OverlayAtlasPage *page) {
+    uint32_t white_x = 0;
+    uint32_t white_y = 0;
+
+    page->skyline[0] = (struct OverlaySkylineNode) {
+        .x = 0,
+        .y = 0,
+        .width = OVL_ATLAS_PAGE_SIZE
+    };
+    page->node_count = 1;
+
+    pack_overlay_atlas_rect(
+        page,
+        OVL_ATLAS_WHITE_SIZE + 2 * OVL_ATLAS_PADDING,
+        OVL_ATLAS_WHITE_SIZE + 2 * OVL_ATLAS_PADDING,
+        &white_x,
+        &white_y
+    );
+
+    page->used_texel_count = 0;
+}
+
+void drop_overlay_atlas_page(struct OverlayAtlas *atlas, struct OverlayAtlasPage *page) {
+    if (page->texture_idx != BINDLESS_NULL_TEXTURE_IDX)
+        bindless_remove_texture(atlas->bindless, page->texture_idx);
+
+    vkDestroyImageView(atlas->device, page->view, NULL);
+    gpu_free_image(atlas->allocator, page->image, &page->allocation);
+    free(page->skyline);
+
+    memset(page, 0, sizeof(struct OverlayAtlasPage));
+}
+
+Result new_overlay_atlas_page(struct OverlayAtlas *atlas) {
+    Result result = { 0 };
+    uint32_t page_idx = atlas->page_count;
+    struct OverlayAtlasPage *page = &atlas->pages[page_idx];
+    uint32_t families[] = { atlas->families->graphics_idx, atlas->families->transfer_idx };
+    Byte white_texels[OVL_ATLAS_WHITE_SIZE * OVL_ATLAS_WHITE_SIZE * OVL_ATLAS_TEXEL_SIZE];
+    struct OverlayAtlasImage white_block = {
+        .page_idx = page_idx,
+        .x = OVL_ATLAS_PADDING,
+        .y = OVL_ATLAS_PADDING,
+        .width = OVL_ATLAS_WHITE_SIZE,
+        .height = OVL_ATLAS_WHITE_SIZE
+    };
+    VkRect2D white_region = {
+        .extent = { .width = OVL_ATLAS_WHITE_SIZE, .height = OVL_ATLAS_WHITE_SIZE }
+    };
+    VkImageCreateInfo image_ci = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = OVL_ATLAS_FORMAT,
+        .extent = { .width = OVL_ATLAS_PAGE_SIZE, .height = OVL_ATLAS_PAGE_SIZE, .depth = 1 },
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+    VkImageViewCreateInfo image_view_ci = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = OVL_ATLAS_FORMAT,
+        .components = {
+            .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .a = VK_COMPONENT_SWIZZLE_IDENTITY
+        },
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = 1,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        }
+    };
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "creating new atlas page #%d..."), page_idx);
+
+    page->texture_idx = BINDLESS_NULL_TEXTURE_IDX;
+
+    // The partially updated pages must keep their content between the families
+    if (is_concurrent_overlay_atlas(atlas)) {
+        image_ci.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        image_ci.queueFamilyIndexCount = STATIC_ARRAY_SIZE(families);
+        image_ci.pQueueFamilyIndices = families;
+    }
+
+    result = gpu_alloc_image(
+        atlas->allocator,
+        &image_ci,
+        GPU_MEMORY_USAGE_DEVICE_LOCAL,
+        &page->image,
+        &page->allocation
+    );
+    EXPECT_SUCCESS(result);
+
+    image_view_ci.image = page->image;
+
+    result.error = VK_RESULT(vkCreateImageView(atlas->device, &image_view_ci, NULL, &page->view));
+    EXPECT_SUCCESS(result);
+
+    if (atlas->bindless != NULL) {
+        result = bindless_add_texture(atlas->bindless, page->view, VK_IMAGE_LAYOUT_GENERAL, &page->texture_idx);
+        EXPECT_SUCCESS(result);
+    }
+
+    page->skyline = ALLOC_ARRAY_UNINIT(result, struct OverlaySkylineNode, OVL_ATLAS_PAGE_SIZE);
+    page->upload_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    page->last_used_frame = atlas->frame_idx;
+
+    reset_overlay_atlas_skyline(page);
+
+    memset(white_texels, UINT8_MAX, sizeof(white_texels));
+
+    result = upload_overlay_atlas_region(atlas, &white_block, &white_region, white_texels);
+    EXPECT_SUCCESS(result);
+
+    atlas->page_count += 1;
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "new atlas page #%d created successfully"), page_idx);
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_overlay_atlas_page(atlas, page);
+    });
+}
+
+Result new_overlay_atlas(
+    VkDevice device,
+    struct GpuAllocator *allocator,
+    struct StagingRing *staging,
+    struct DescrAllocator *descr_allocator,
+    struct RendererQueueFamilies *families,
+    struct PipelineOVL *pipeline,
+    uint32_t frame_count
+) {
+    ASSERT_NOT_NULL(device);
+    ASSERT_NOT_NULL(allocator);
+    ASSERT_NOT_NULL(staging);
+    ASSERT_NOT_NULL(descr_allocator);
+    ASSERT_NOT_NULL(families);
+    ASSERT_NOT_NULL(pipeline);
+
+    Result result = { 0 };
+
+    info(LOG_TARGET, "creating new overlay atlas...");
+
+    struct OverlayAtlas *atlas = ALLOC(result, struct OverlayAtlas);
+
+    atlas->device = device;
+    atlas->allocator = allocator;
+    atlas->staging = staging;
+    atlas->descr_allocator = descr_allocator;
+    atlas->families = families;
+    atlas->bindless = pipeline->bindless;
+    atlas->descr_set_layout = pipeline->descr_set_layout;
+    atlas->frame_count = frame_count;
+    atlas->stats.page_size = OVL_ATLAS_PAGE_SIZE;
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "page size: %d, max pages: %d, sharing: %s"),
+        OVL_ATLAS_PAGE_SIZE, OVL_ATLAS_MAX_PAGES,
+        is_concurrent_overlay_atlas(atlas) ? "concurrent" : "exclusive"
+    );
+
+    atlas->images = ALLOC_ARRAY(result, struct OverlayAtlasImage, OVL_ATLAS_MAX_IMAGES);
+
+    result = new_overlay_atlas_page(atlas);
+    EXPECT_SUCCESS(result);
+
+    atlas->stats.page_count = atlas->page_count;
+
+    result.object = atlas;
+    info(LOG_TARGET, "new overlay atlas created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_overlay_atlas(atlas);
+    });
+}
+
+struct OverlayAtlasImage *find_overlay_image(struct OverlayAtlas *atlas, uint32_t image_id) {
+    uint32_t image_idx = (image_id & OVL_ATLAS_IMAGE_IDX_MASK) - 1;
+    uint32_t generation = image_id >> OVL_ATLAS_IMAGE_IDX_BITS;
+
+    if (image_id == OVL_ATLAS_NULL_IMAGE_ID || image_idx >= OVL_ATLAS_MAX_IMAGES)
+        return NULL;
+
+    struct OverlayAtlasImage *image = &atlas->images[image_idx];
+
+    if (!image->is_resident || image->generation != generation)
+        return NULL;
+
+    return image;
+}
+
+void release_overlay_image(struct OverlayAtlas *atlas, struct OverlayAtlasImage *image) {
+    struct OverlayAtlasPage *page = &atlas->pages[image->page_idx];
+
+    image->is_resident = false;
+    image->generation = (image->generation + 1) & (UINT32_MAX >> OVL_ATLAS_IMAGE_IDX_BITS);
+
+    page->image_count -= 1;
+    atlas->stats.image_count -= 1;
+}
+
+// The page space can be reused once no frame in flight samples it
+bool is_overlay_atlas_page_idle(struct OverlayAtlas *atlas, struct OverlayAtlasPage *page) {
+    return atlas->frame_idx - page->last_used_frame > atlas->frame_count;
+}
+
+void evict_overlay_atlas_page(struct OverlayAtlas *atlas, uint32_t page_idx) {
+    struct OverlayAtlasPage *page = &atlas->pages[page_idx];
+
+    if (page->image_count > 0) {
+        debug(
+            LOG_TARGET,
+            LOG_GROUP(struct, "evicting atlas page #%d (%d images)"),
+            page_idx, page->image_count
+        );
+
+        for (uint32_t i = 0; i < OVL_ATLAS_MAX_IMAGES; ++i) {
+            struct OverlayAtlasImage *image = &atlas->images[i];
+
+            if (image->is_resident && image->page_idx == page_idx)
+                release_overlay_image(atlas, image);
+        }
+
+        atlas->stats.eviction_count += 1;
+    }
+
+    atlas->stats.used_texel_count -= page->used_texel_count;
+    reset_overlay_atlas_skyline(page);
+}
+
+// Packs into the existing pages, then into a new page,
+// then into the least recently used idle page
+Result place_overlay_image(
+    struct OverlayAtlas *atlas,
+    uint32_t width,
+    uint32_t height,
+    struct OverlayAtlasImage *image
+) {
+    Result result = { 0 };
+    uint32_t lru_page_idx = UINT32_MAX;
+
+    for (uint32_t i = 0; i < atlas->page_count; ++i) {
+        struct OverlayAtlasPage *page = &atlas->pages[i];
+
+        // The removed images leave holes: the empty page is started over
+        if (page->image_count == 0 && page->used_texel_count > 0 && is_overlay_atlas_page_idle(atlas, page))
+            evict_overlay_atlas_page(atlas, i);
+
+        if (pack_overlay_atlas_rect(page, width, height, &image->x, &image->y)) {
+            image->page_idx = i;
+            goto exit;
+        }
+    }
+
+    if (atlas->page_count < OVL_ATLAS_MAX_PAGES) {
+        result = new_overlay_atlas_page(atlas);
+        EXPECT_SUCCESS(result);
+
+        atlas->stats.page_count = atlas->page_count;
+        image->page_idx = atlas->page_count - 1;
+    } else {
+        for (uint32_t i = 0; i < atlas->page_count; ++i) {
+            struct OverlayAtlasPage *page = &atlas->pages[i];
+
+            if (!is_overlay_atlas_page_idle(atlas, page))
+                continue;
+
+            if (lru_page_idx == UINT32_MAX || page->last_used_frame < atlas->pages[lru_page_idx].last_used_frame)
+                lru_page_idx = i;
+        }
+
+        if (lru_page_idx == UINT32_MAX) {
+            result.error = OVERLAY_ATLAS_FULL;
+            EXPECT_SUCCESS(result);
+        }
+
+        evict_overlay_atlas_page(atlas, lru_page_idx);
+        image->page_idx = lru_page_idx;
+    }
+
+    // The image fits into the empty page (the size is checked by the caller)
+    pack_overlay_atlas_rect(&atlas->pages[image->page_idx], width, height, &image->x, &image->y);
+
+    FN_FORCE_EXIT(result);
+}
+
+Result overlay_atlas_add_image(
+    struct OverlayAtlas *atlas,
+    uint32_t width,
+    uint32_t height,
+    const void *pixels,
+    uint32_t *image_id
+) {
+    ASSERT_NOT_NULL(atlas);
+    ASSERT_NOT_NULL(pixels);
+    ASSERT_NOT_NULL(image_id);
+
+    Result result = { 0 };
+    uint32_t padded_width = width + 2 * OVL_ATLAS_PADDING;
+    uint32_t padded_height = height + 2 * OVL_ATLAS_PADDING;
+    uint32_t max_height = OVL_ATLAS_PAGE_SIZE - OVL_ATLAS_WHITE_SIZE - 2 * OVL_ATLAS_PADDING;
+    uint32_t image_idx = 0;
+    struct OverlayAtlasImage *image = NULL;
+    VkRect2D region = {
+        .extent = { .width = width, .height = height }
+    };
+
+    *image_id = OVL_ATLAS_NULL_IMAGE_ID;
+
+    if (width == 0 || height == 0) {
+        result.error = OVERLAY_REGION_INVALID;
+        EXPECT_SUCCESS(result);
+    }
+
+    // The white block occupies the top left corner of every page
+    // (the unpadded sizes are checked too: the padding can wrap the huge ones around)
+    if (
+        width > OVL_ATLAS_PAGE_SIZE || height > OVL_ATLAS_PAGE_SIZE
+        || padded_width > OVL_ATLAS_PAGE_SIZE || padded_height > max_height
+    ) {
+        result.error = OVERLAY_ATLAS_FULL;
+        EXPECT_SUCCESS(result);
+    }
+
+    while (image_idx < OVL_ATLAS_MAX_IMAGES && atlas->images[image_idx].is_resident)
+        ++image_idx;
+
+    if (image_idx == OVL_ATLAS_MAX_IMAGES) {
+        result.error = OVERLAY_ATLAS_FULL;
+        EXPECT_SUCCESS(result);
+    }
+
+    image = &atlas->images[image_idx];
+
+    result = place_overlay_image(atlas, padded_width, padded_height, image);
+    EXPECT_SUCCESS(result);
+
+    image->x += OVL_ATLAS_PADDING;
+    image->y += OVL_ATLAS_PADDING;
+    image->width = width;
+    image->height = height;
+    image->is_resident = true;
+    image->is_drawn = false;
+
+    atlas->pages[image->page_idx].image_count += 1;
+    atlas->stats.image_count += 1;
+    atlas->stats.used_texel_count += AS(padded_width, uint64_t) * padded_height;
+
+    result = upload_overlay_atlas_region(atlas, image, &region, pixels);
+    EXPECT_SUCCESS(result);
+
+    *image_id = (image->generation << OVL_ATLAS_IMAGE_IDX_BITS) | (image_idx + 1);
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "image #%d (%dx%d) is placed at page #%d (%d, %d)"),
+        *image_id, width, height, image->page_idx, image->x, image->y
+    );
+
+    FN_FORCE_EXIT(result);
+}
+
+Result overlay_atlas_update_image(
+    struct OverlayAtlas *atlas,
+    uint32_t image_id,
+    const VkRect2D *region,
+    const void *pixels
+) {
+    ASSERT_NOT_NULL(atlas);
+    ASSERT_NOT_NULL(region);
+    ASSERT_NOT_NULL(pixels);
+
+    Result result = { 0 };
+    struct OverlayAtlasImage *image = find_overlay_image(atlas, image_id);
+
+    if (image == NULL) {
+        result.error = OVERLAY_IMAGE_NOT_FOUND;
+        EXPECT_SUCCESS(result);
+    }
+
+    // The sums can't overflow in 64 bits
+    if (
+        region->offset.x < 0 || region->offset.y < 0
+        || region->extent.width == 0 || region->extent.height == 0
+        || AS(region->offset.x, uint64_t) + region->extent.width > image->width
+        || AS(region->offset.y, uint64_t) + region->extent.height > image->height
+    ) {
+        result.error = OVERLAY_REGION_INVALID;
+        EXPECT_SUCCESS(result);
+    }
+
+    result = upload_overlay_atlas_region(atlas, image, region, pixels);
+    EXPECT_SUCCESS(result);
+
+    FN_FORCE_EXIT(result);
+}
+
+void overlay_atlas_remove_image(struct OverlayAtlas *atlas, uint32_t image_id) {
+    ASSERT_NOT_NULL(atlas);
+
+    struct OverlayAtlasImage *image = find_overlay_image(atlas, image_id);
+
+    if (image != NULL)
+        release_overlay_image(atlas, image);
+}
+
+bool is_overlay_image_resident(struct OverlayAtlas *atlas, uint32_t image_id) {
+    ASSERT_NOT_NULL(atlas);
+
+    return find_overlay_image(atlas, image_id) != NULL;
+}
+
+struct OverlayAtlasLocation resolve_overlay_image(
+    struct OverlayAtlas *atlas,
+    uint32_t image_id,
+    const OverlayRect *tex_rect
+) {
+    ASSERT_NOT_NULL(atlas);
+    ASSERT_NOT_NULL(tex_rect);
+
+    struct OverlayAtlasImage *image = find_overlay_image(atlas, image_id);
+    struct OverlayAtlasLocation location = {
+        .page_idx = 0,
+        .tex_rect = {
+            .x = OVL_ATLAS_WHITE_TEXEL,
+            .y = OVL_ATLAS_WHITE_TEXEL
+        }
+    };
+
+    if (image != NULL) {
+        location.page_idx = image->page_idx;
+        location.tex_rect = *tex_rect;
+        location.tex_rect.x += AS(image->x, float);
+        location.tex_rect.y += AS(image->y, float);
+
+        image->is_drawn = true;
+        image->last_drawn_frame = atlas->frame_idx;
+    }
+
+    atlas->pages[location.page_idx].last_used_frame = atlas->frame_idx;
+
+    return location;
+}
+
+Result prepare_overlay_atlas_frame(struct OverlayAtlas *atlas) {
+    ASSERT_NOT_NULL(atlas);
+
+    Result result = { 0 };
+    VkDescriptorImageInfo descr_image_infos[OVL_ATLAS_MAX_PAGES] = { 0 };
+    VkWriteDescriptorSet descr_writes[OVL_ATLAS_MAX_PAGES] = { 0 };
+
+    if (atlas->bindless != NULL)
+        goto exit;
+
+    for (uint32_t i = 0; i < atlas->page_count; ++i) {
+        struct OverlayAtlasPage *page = &atlas->pages[i];
+
+        result = descr_allocator_alloc(atlas->descr_allocator, atlas->descr_set_layout, &page->descr_set);
+        EXPECT_SUCCESS(result);
+
+        descr_image_infos[i].imageView = page->view;
+        descr_image_infos[i].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+        descr_writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descr_writes[i].dstSet = page->descr_set;
+        descr_writes[i].dstBinding = OVL_ATLAS_DESCR_BINDING;
+        descr_writes[i].descriptorCount = 1;
+        descr_writes[i].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        descr_writes[i].pImageInfo = &descr_image_infos[i];
+    }
+
+    vkUpdateDescriptorSets(atlas->device, atlas->page_count, descr_writes, 0, NULL);
+
+    FN_FORCE_EXIT(result);
+}
+
+VkDescriptorSet overlay_atlas_page_descr_set(struct OverlayAtlas *atlas, uint32_t page_idx) {
+    ASSERT_NOT_NULL(atlas);
+    assert(page_idx < atlas->page_count && "atlas page index is out of range");
+
+    return atlas->pages[page_idx].descr_set;
+}
+
+uint32_t overlay_atlas_page_texture_idx(struct OverlayAtlas *atlas, uint32_t page_idx) {
+    ASSERT_NOT_NULL(atlas);
+    assert(page_idx < atlas->page_count && "atlas page index is out of range");
+
+    return atlas->pages[page_idx].texture_idx;
+}
+
+void complete_overlay_atlas_frame(struct OverlayAtlas *atlas) {
+    ASSERT_NOT_NULL(atlas);
+
+    // The uploads of the next frames keep the content
+    for (uint32_t i = 0; i < atlas->page_count; ++i)
+        atlas->pages[i].upload_layout = VK_IMAGE_LAYOUT_GENERAL;
+
+    atlas->stats.frame_uploaded_texel_count = atlas->pending_uploaded_texel_count;
+    atlas->pending_uploaded_texel_count = 0;
+    atlas->frame_idx += 1;
+}
+
+void drop_overlay_atlas(struct OverlayAtlas *atlas) {
+    if (atlas == NULL)
+        goto exit;
+
+    for (uint32_t i = 0; i < atlas->page_count; ++i)
+        drop_overlay_atlas_page(atlas, &atlas->pages[i]);
+
+    free(atlas->images);
+    free(atlas);
+
+exit:
+    debug(LOG_TARGET, "drop overlay atlas");
+}
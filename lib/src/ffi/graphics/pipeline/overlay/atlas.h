@@ -0,0 +1,187 @@
+#ifndef ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_ATLAS_H___
+#define ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_ATLAS_H___
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+
+#include "ffi/core/result.h"
+#include "ffi/graphics/memory/allocator.h"
+#include "ffi/graphics/pipeline/bindless.h"
+#include "ffi/graphics/renderer/descr_allocator.h"
+#include "ffi/graphics/renderer/queues.h"
+#include "ffi/graphics/renderer/staging.h"
+#include "ffi/graphics/renderer/stats.h"
+#include "mod.h"
+#include "quad.h"
+
+// Overlay images (RGBA8) are packed into a few large pages with the skyline packer,
+// so the quads of different images share a descriptor set and a draw call.
+//
+// Only the written regions are uploaded (through the staging ring).
+// The pages stay in `VK_IMAGE_LAYOUT_GENERAL`: the new images are copied
+// into the free space of a page while the frames in flight sample the rest of it.
+// An update of an image drawn by the frames in flight waits for their reads
+// (the staging batch falls back to the graphics queue).
+//
+// A single image can't be freed from the skyline:
+// the page space is reclaimed once all of its images are removed,
+// or by evicting the least recently drawn page if there is no room for a new image.
+//
+// In the bindless mode the pages occupy the bindless table slots
+// instead of having their own descriptor sets.
+// Otherwise the page sets are transient: every frame allocates them from the descriptor allocator.
+
+#define OVL_ATLAS_PAGE_SIZE 1024
+#define OVL_ATLAS_MAX_PAGES 4
+#define OVL_ATLAS_MAX_IMAGES 4096
+#define OVL_ATLAS_FORMAT VK_FORMAT_R8G8B8A8_UNORM
+#define OVL_ATLAS_TEXEL_SIZE 4
+
+// Every image is surrounded by its extruded edge texels:
+// the linear filter never fetches the neighbour images
+#define OVL_ATLAS_PADDING 1
+
+// Every page starts with a white block the untextured quads sample
+#define OVL_ATLAS_WHITE_SIZE 2
+#define OVL_ATLAS_WHITE_TEXEL (OVL_ATLAS_PADDING + OVL_ATLAS_WHITE_SIZE / 2)
+
+// The image id is `(generation << OVL_ATLAS_IMAGE_IDX_BITS) | (image_idx + 1)`:
+// an id of a removed or evicted image never matches a new image in the same slot
+#define OVL_ATLAS_IMAGE_IDX_BITS 16
+#define OVL_ATLAS_NULL_IMAGE_ID 0
+
+struct OverlaySkylineNode {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+};
+
+struct OverlayAtlasPage {
+    VkImage image;
+    struct GpuAllocation allocation;
+    VkImageView view;
+
+    // Either of them, depends on the mode.
+    // The set is valid for the current frame only.
+    VkDescriptorSet descr_set;
+    uint32_t texture_idx;
+
+    // Sorted by `x`, cover the whole page width
+    struct OverlaySkylineNode *skyline;
+    uint32_t node_count;
+
+    // The uploads collected before the first submission
+    // define the page content, so they start from the undefined layout
+    VkImageLayout upload_layout;
+
+    uint32_t image_count;
+    uint64_t used_texel_count;
+    uint64_t last_used_frame;
+};
+
+struct OverlayAtlasImage {
+    uint32_t generation;
+    bool is_resident;
+
+    uint32_t page_idx;
+
+    // Without the padding
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+
+    bool is_drawn;
+    uint64_t last_drawn_frame;
+};
+
+// Where a quad samples its image
+struct OverlayAtlasLocation {
+    uint32_t page_idx;
+    OverlayRect tex_rect;
+};
+
+struct OverlayAtlas {
+    VkDevice device;
+    struct GpuAllocator *allocator;
+    struct StagingRing *staging;
+    struct RendererQueueFamilies *families;
+
+    // NULL in the descriptor set mode
+    struct BindlessTable *bindless;
+
+    VkDescriptorSetLayout descr_set_layout;
+    struct DescrAllocator *descr_allocator;
+
+    struct OverlayAtlasPage pages[OVL_ATLAS_MAX_PAGES];
+    uint32_t page_count;
+
+    struct OverlayAtlasImage *images;
+
+    // A page drawn by one of the last `frame_count` frames can't be evicted
+    uint64_t frame_idx;
+    uint32_t frame_count;
+
+    uint64_t pending_uploaded_texel_count;
+    OverlayAtlasStats stats;
+};
+
+// The first page is created (and its white block is uploaded) with the next frame
+Result new_overlay_atlas(
+    VkDevice device,
+    struct GpuAllocator *allocator,
+    struct StagingRing *staging,
+    struct DescrAllocator *descr_allocator,
+    struct RendererQueueFamilies *families,
+    struct PipelineOVL *pipeline,
+    uint32_t frame_count
+);
+
+// `pixels` are `width * height` tightly packed RGBA8 texels.
+// Fails with `OVERLAY_REGION_INVALID` if the image is empty.
+Result overlay_atlas_add_image(
+    struct OverlayAtlas *atlas,
+    uint32_t width,
+    uint32_t height,
+    const void *pixels,
+    uint32_t *image_id
+);
+
+// Uploads the dirty `region` of the image only.
+// `pixels` are `region->width * region->height` tightly packed RGBA8 texels.
+// Fails with `OVERLAY_REGION_INVALID` if the region is empty or not inside of the image.
+Result overlay_atlas_update_image(
+    struct OverlayAtlas *atlas,
+    uint32_t image_id,
+    const VkRect2D *region,
+    const void *pixels
+);
+
+void overlay_atlas_remove_image(struct OverlayAtlas *atlas, uint32_t image_id);
+
+bool is_overlay_image_resident(struct OverlayAtlas *atlas, uint32_t image_id);
+
+// `tex_rect` is relative to the image.
+// The null, removed and evicted images resolve to the white block.
+// Marks the image and its page as used by the current frame.
+struct OverlayAtlasLocation resolve_overlay_image(
+    struct OverlayAtlas *atlas,
+    uint32_t image_id,
+    const OverlayRect *tex_rect
+);
+
+// Allocates the page sets of the current frame (the descriptor set mode only).
+// Must be called after the pages of the frame are created and before the draws are recorded.
+Result prepare_overlay_atlas_frame(struct OverlayAtlas *atlas);
+
+VkDescriptorSet overlay_atlas_page_descr_set(struct OverlayAtlas *atlas, uint32_t page_idx);
+
+// The bindless mode only
+uint32_t overlay_atlas_page_texture_idx(struct OverlayAtlas *atlas, uint32_t page_idx);
+
+// Must be called once the frame (and its staging batch) is submitted
+void complete_overlay_atlas_frame(struct OverlayAtlas *atlas);
+
+void drop_overlay_atlas(struct OverlayAtlas *atlas);
+
+#endif // ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_ATLAS_H___
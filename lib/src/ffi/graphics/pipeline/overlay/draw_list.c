@@ -0,0 +1,466 @@
+#include <stddef.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "draw_list.h"
+#include "pipeline_overlay.impl.h"
+#include "vertex_overlay.h"
+
+#include "ffi/core/log.h"
+#include "ffi/util/mod.h"
+#include "ffi/math/mod.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(OverlayDrawList)
+
+Result upload_overlay_indices(struct OverlayDrawList *list, struct StagingRing *staging) {
+    Result result = { 0 };
+    VkDeviceSize size = sizeof(IndexOVL) * OVL_QUAD_INDEX_COUNT * MAX_OVL_QUADS;
+    VkBufferCreateInfo buffer_ci = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+    struct StagingDst dst = {
+        .sharing_mode = VK_SHARING_MODE_EXCLUSIVE,
+        .stage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+        .access = VK_ACCESS_INDEX_READ_BIT
+    };
+    IndexOVL quad_indices[OVL_QUAD_INDEX_COUNT] = { 0, 1, 2, 2, 3, 0 };
+
+    buffer_ci.size = size;
+
+    IndexOVL *indices = ALLOC_ARRAY_UNINIT(result, IndexOVL, OVL_QUAD_INDEX_COUNT * MAX_OVL_QUADS);
+
+    for (uint32_t quad = 0; quad < MAX_OVL_QUADS; ++quad) {
+        for (uint32_t i = 0; i < OVL_QUAD_INDEX_COUNT; ++i) {
+            indices[quad * OVL_QUAD_INDEX_COUNT + i] = AS(
+                quad * OVL_QUAD_VERTEX_COUNT + quad_indices[i],
+                IndexOVL
+            );
+        }
+    }
+
+    result = gpu_alloc_buffer(
+        list->allocator,
+        &buffer_ci,
+        GPU_MEMORY_USAGE_DEVICE_LOCAL,
+        &list->index_buffer,
+        &list->index_allocation
+    );
+    EXPECT_SUCCESS(result);
+
+    result = staging_upload_buffer(staging, indices, size, list->index_buffer, 0, &dst);
+    EXPECT_SUCCESS(result);
+
+    FN_FORCE_EXIT(result, {
+        free(indices);
+    });
+}
+
+Result new_overlay_draw_list(
+    struct GpuAllocator *allocator,
+    struct StagingRing *staging,
+    struct PipelineOVL *pipeline,
+    struct OverlayAtlas *atlas,
+    uint32_t frame_count
+) {
+    ASSERT_NOT_NULL(allocator);
+    ASSERT_NOT_NULL(staging);
+    ASSERT_NOT_NULL(pipeline);
+    ASSERT_NOT_NULL(atlas);
+
+    static_assert(
+        MAX_OVL_QUADS * OVL_QUAD_VERTEX_COUNT <= UINT16_MAX + 1,
+        "overlay vertices must be addressable by 16-bit indices"
+    );
+
+    Result result = { 0 };
+    VkBufferCreateInfo vertex_buffer_ci = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = sizeof(struct VertexOVL) * OVL_QUAD_VERTEX_COUNT * MAX_OVL_QUADS,
+        .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+
+    info(LOG_TARGET, "creating new overlay draw list...");
+
+    struct OverlayDrawList *list = ALLOC(result, struct OverlayDrawList);
+
+    list->allocator = allocator;
+    list->pipeline = pipeline;
+    list->atlas = atlas;
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "max quads: %d, frame slots: %d"),
+        MAX_OVL_QUADS, frame_count
+    );
+
+    list->quads = ALLOC_ARRAY_UNINIT(result, OverlayQuad, MAX_OVL_QUADS);
+    list->sort_items = ALLOC_ARRAY_UNINIT(result, struct OverlaySortItem, MAX_OVL_QUADS);
+    list->batches = ALLOC_ARRAY_UNINIT(result, struct OverlayBatch, MAX_OVL_QUADS);
+
+    list->vertex_buffers = ALLOC_ARRAY(result, struct OverlayVertexBuffer, frame_count);
+    list->frame_count = frame_count;
+
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        result = gpu_alloc_buffer(
+            allocator,
+            &vertex_buffer_ci,
+            GPU_MEMORY_USAGE_DYNAMIC,
+            &list->vertex_buffers[i].buffer,
+            &list->vertex_buffers[i].allocation
+        );
+        EXPECT_SUCCESS(result);
+
+        ASSERT_NOT_NULL(list->vertex_buffers[i].allocation.mapped);
+    }
+
+    result = upload_overlay_indices(list, staging);
+    EXPECT_SUCCESS(result);
+
+    result.object = list;
+    info(LOG_TARGET, "new overlay draw list created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_overlay_draw_list(list);
+    });
+}
+
+void overlay_draw_list_push(struct OverlayDrawList *list, const OverlayQuad *quads, uint32_t count) {
+    ASSERT_NOT_NULL(list);
+    ASSERT_NOT_NULL(quads);
+
+    uint32_t accepted_count = MIN(count, MAX_OVL_QUADS - list->quad_count);
+
+    for (uint32_t i = 0; i < accepted_count; ++i) {
+        uint32_t quad_idx = list->quad_count + i;
+        struct OverlaySortItem *item = &list->sort_items[quad_idx];
+        struct OverlayAtlasLocation location = resolve_overlay_image(
+            list->atlas,
+            quads[i].texture_id,
+            &quads[i].tex_rect
+        );
+
+        list->quads[quad_idx] = quads[i];
+        list->quads[quad_idx].tex_rect = location.tex_rect;
+
+        item->layer = quads[i].layer;
+        item->page_idx = location.page_idx;
+        item->scissor = quads[i].scissor;
+        item->quad_idx = quad_idx;
+    }
+
+    list->quad_count += accepted_count;
+    list->dropped_quad_count += count - accepted_count;
+}
+
+void clear_overlay_draw_list(struct OverlayDrawList *list) {
+    ASSERT_NOT_NULL(list);
+
+    list->quad_count = 0;
+    list->dropped_quad_count = 0;
+}
+
+bool is_same_overlay_scissor(const OverlayScissor *a, const OverlayScissor *b) {
+    return a->x == b->x
+        && a->y == b->y
+        && a->width == b->width
+        && a->height == b->height;
+}
+
+int compare_overlay_sort_items(const void *lhs, const void *rhs) {
+    const struct OverlaySortItem *a = lhs;
+    const struct OverlaySortItem *b = rhs;
+
+#   define COMPARE_FIELD(field) \
+        if (a->field != b->field) \
+            return a->field < b->field ? -1 : 1
+
+    COMPARE_FIELD(layer);
+    COMPARE_FIELD(page_idx);
+    COMPARE_FIELD(scissor.x);
+    COMPARE_FIELD(scissor.y);
+    COMPARE_FIELD(scissor.width);
+    COMPARE_FIELD(scissor.height);
+
+    // Keeps the push order of the equal quads (qsort is not stable)
+    COMPARE_FIELD(quad_idx);
+
+#   undef COMPARE_FIELD
+
+    return 0;
+}
+
+#if OVL_COMPACT_VERTEX
+int16_t pack_overlay_pos(float pos) {
+    float fixed = CLAMP(pos * (1 << OVL_POS_SUBPIXEL_BITS), INT16_MIN, INT16_MAX);
+
+    return AS(ROUND_32(fixed), int16_t);
+}
+
+uint16_t pack_overlay_tex(float tex) {
+    float texel = CLAMP(tex, 0, UINT16_MAX);
+
+    return AS(ROUND_32(texel), uint16_t);
+}
+
+uint8_t pack_overlay_color(float channel) {
+    float value = CLAMP(channel, 0.0f, 1.0f) * UINT8_MAX;
+
+    return AS(ROUND_32(value), uint8_t);
+}
+
+#   define OVL_POS(px, py) { .x = pack_overlay_pos(px), .y = pack_overlay_pos(py) }
+#   define OVL_TEX(tu, tv) { .u = pack_overlay_tex(tu), .v = pack_overlay_tex(tv) }
+#else
+#   define OVL_POS(px, py) { .x = (px), .y = (py) }
+#   define OVL_TEX(tu, tv) { .u = (tu), .v = (tv) }
+#endif // OVL_COMPACT_VERTEX
+
+void write_overlay_vertices(struct VertexOVL *vertices, const OverlayQuad *quad) {
+    const OverlayRect *rect = &quad->rect;
+    const OverlayRect *tex = &quad->tex_rect;
+    float left = rect->x;
+    float top = rect->y;
+    float right = rect->x + rect->width;
+    float bottom = rect->y + rect->height;
+    float tex_left = tex->x;
+    float tex_top = tex->y;
+    float tex_right = tex->x + tex->width;
+    float tex_bottom = tex->y + tex->height;
+
+#if OVL_COMPACT_VERTEX
+    ubyte4 color = {
+        .r = pack_overlay_color(quad->color[0]),
+        .g = pack_overlay_color(quad->color[1]),
+        .b = pack_overlay_color(quad->color[2]),
+        .a = pack_overlay_color(quad->color[3])
+    };
+#else
+    float4 color = {
+        .r = quad->color[0],
+        .g = quad->color[1],
+        .b = quad->color[2],
+        .a = quad->color[3]
+    };
+#endif // OVL_COMPACT_VERTEX
+
+    // Clockwise from the top left corner
+    vertices[0] = (struct VertexOVL) {
+        .pos = OVL_POS(left, top),
+        .color = color,
+        .tex = OVL_TEX(tex_left, tex_top)
+    };
+    vertices[1] = (struct VertexOVL) {
+        .pos = OVL_POS(right, top),
+        .color = color,
+        .tex = OVL_TEX(tex_right, tex_top)
+    };
+    vertices[2] = (struct VertexOVL) {
+        .pos = OVL_POS(right, bottom),
+        .color = color,
+        .tex = OVL_TEX(tex_right, tex_bottom)
+    };
+    vertices[3] = (struct VertexOVL) {
+        .pos = OVL_POS(left, bottom),
+        .color = color,
+        .tex = OVL_TEX(tex_left, tex_bottom)
+    };
+}
+
+#undef OVL_POS
+#undef OVL_TEX
+
+// Sorts the quads, writes them into the mapped vertex buffer and merges them into batches
+void build_overlay_batches(struct OverlayDrawList *list, struct VertexOVL *vertices) {
+    struct OverlayBatch *batch = NULL;
+
+    qsort(list->sort_items, list->quad_count, sizeof(struct OverlaySortItem), compare_overlay_sort_items);
+
+    list->batch_count = 0;
+
+    for (uint32_t i = 0; i < list->quad_count; ++i) {
+        struct OverlaySortItem *item = &list->sort_items[i];
+
+        write_overlay_vertices(&vertices[i * OVL_QUAD_VERTEX_COUNT], &list->quads[item->quad_idx]);
+
+        // The layer change alone doesn't break the batch:
+        // the sorted quads are contiguous in the vertex buffer anyway
+        if (
+            batch != NULL
+            && batch->page_idx == item->page_idx
+            && is_same_overlay_scissor(&batch->scissor, &item->scissor)
+        ) {
+            batch->quad_count += 1;
+            continue;
+        }
+
+        batch = &list->batches[list->batch_count++];
+        batch->page_idx = item->page_idx;
+        batch->scissor = item->scissor;
+        batch->first_quad = i;
+        batch->quad_count = 1;
+    }
+}
+
+VkRect2D overlay_scissor_rect(const OverlayScissor *scissor, VkExtent2D extent) {
+    VkRect2D rect = { 0 };
+
+    if (scissor->width == 0 || scissor->height == 0) {
+        rect.extent = extent;
+        return rect;
+    }
+
+    // Vulkan rejects negative scissor offsets
+    rect.offset.x = MAX(scissor->x, 0);
+    rect.offset.y = MAX(scissor->y, 0);
+    rect.extent.width = AS(MAX(AS(scissor->width, int64_t) + scissor->x - rect.offset.x, 0), uint32_t);
+    rect.extent.height = AS(MAX(AS(scissor->height, int64_t) + scissor->y - rect.offset.y, 0), uint32_t);
+
+    return rect;
+}
+
+void prepare_overlay_draw_list(struct OverlayDrawList *list, uint32_t frame_idx) {
+    ASSERT_NOT_NULL(list);
+    assert(frame_idx < list->frame_count && "frame index is out of range");
+
+    list->batch_count = 0;
+
+    if (list->quad_count > 0)
+        build_overlay_batches(list, list->vertex_buffers[frame_idx].allocation.mapped);
+
+    list->stats.quad_count = list->quad_count;
+    list->stats.draw_call_count = list->batch_count;
+    list->stats.dropped_quad_count = list->dropped_quad_count;
+}
+
+void cmd_draw_overlay_batches(
+    struct OverlayDrawList *list,
+    VkCommandBuffer cmd_buffer,
+    uint32_t frame_idx,
+    VkExtent2D extent,
+    uint32_t first_batch,
+    uint32_t batch_count
+) {
+    ASSERT_NOT_NULL(list);
+    ASSERT_NOT_NULL(cmd_buffer);
+    assert(frame_idx < list->frame_count && "frame index is out of range");
+    assert(first_batch + batch_count <= list->batch_count && "overlay batch range is out of range");
+
+    struct OverlayVertexBuffer *vertex_buffer = &list->vertex_buffers[frame_idx];
+    VkDeviceSize vertex_offset = 0;
+    struct PushConstantsOVL push_constants = {
+        .scale = { .x = 2.0f / AS(extent.width, float), .y = 2.0f / AS(extent.height, float) },
+        .translate = { .x = -1.0f, .y = -1.0f },
+        .texture_idx = BINDLESS_NULL_TEXTURE_IDX
+    };
+    struct BindlessTable *bindless = list->atlas->bindless;
+
+    if (batch_count == 0)
+        return;
+
+    // The range can start a separate command buffer: the whole state is set again
+    vkCmdBindPipeline(cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, list->pipeline->vk_handle);
+
+    vkCmdPushConstants(
+        cmd_buffer,
+        list->pipeline->layout,
+        OVL_PUSH_CONSTANTS_STAGES,
+        0,
+        OVL_PUSH_CONSTANTS_SIZE,
+        &push_constants
+    );
+
+    // The whole frame shares the bindless set, the batches push the page index only
+    if (bindless != NULL) {
+        vkCmdBindDescriptorSets(
+            cmd_buffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            list->pipeline->layout,
+            OVL_DESCR_SET,
+            1,
+            &bindless->set,
+            0,
+            NULL
+        );
+    }
+
+    vkCmdBindVertexBuffers(cmd_buffer, OVL_VERTEX_INPUT_BINDING, 1, &vertex_buffer->buffer, &vertex_offset);
+    vkCmdBindIndexBuffer(cmd_buffer, list->index_buffer, 0, VK_INDEX_TYPE_UINT16);
+
+    for (uint32_t i = first_batch; i < first_batch + batch_count; ++i) {
+        struct OverlayBatch *batch = &list->batches[i];
+        bool is_first = i == first_batch;
+
+        bool is_new_page = is_first || batch->page_idx != list->batches[i - 1].page_idx;
+
+        if (is_new_page && bindless != NULL) {
+            push_constants.texture_idx = overlay_atlas_page_texture_idx(list->atlas, batch->page_idx);
+
+            vkCmdPushConstants(
+                cmd_buffer,
+                list->pipeline->layout,
+                OVL_PUSH_CONSTANTS_STAGES,
+                offsetof(struct PushConstantsOVL, texture_idx),
+                sizeof(push_constants.texture_idx),
+                &push_constants.texture_idx
+            );
+        } else if (is_new_page) {
+            VkDescriptorSet descr_set = overlay_atlas_page_descr_set(list->atlas, batch->page_idx);
+
+            vkCmdBindDescriptorSets(
+                cmd_buffer,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                list->pipeline->layout,
+                OVL_DESCR_SET,
+                1,
+                &descr_set,
+                0,
+                NULL
+            );
+        }
+
+        if (is_first || !is_same_overlay_scissor(&batch->scissor, &list->batches[i - 1].scissor)) {
+            VkRect2D scissor = overlay_scissor_rect(&batch->scissor, extent);
+            vkCmdSetScissor(cmd_buffer, 0, 1, &scissor);
+        }
+
+        vkCmdDrawIndexed(
+            cmd_buffer,
+            batch->quad_count * OVL_QUAD_INDEX_COUNT,
+            1,
+            batch->first_quad * OVL_QUAD_INDEX_COUNT,
+            0,
+            0
+        );
+    }
+}
+
+void drop_overlay_draw_list(struct OverlayDrawList *list) {
+    if (list == NULL)
+        goto exit;
+
+    if (list->vertex_buffers != NULL) {
+        for (uint32_t i = 0; i < list->frame_count; ++i) {
+            gpu_free_buffer(
+                list->allocator,
+                list->vertex_buffers[i].buffer,
+                &list->vertex_buffers[i].allocation
+            );
+        }
+    }
+
+    gpu_free_buffer(list->allocator, list->index_buffer, &list->index_allocation);
+
+    free(list->vertex_buffers);
+    free(list->batches);
+    free(list->sort_items);
+    free(list->quads);
+    free(list);
+
+exit:
+    debug(LOG_TARGET, "drop overlay draw list");
+}
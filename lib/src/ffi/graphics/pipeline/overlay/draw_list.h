@@ -0,0 +1,103 @@
+#ifndef ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_DRAW_LIST_H___
+#define ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_DRAW_LIST_H___
+
+#include <vulkan/vulkan.h>
+
+#include "ffi/core/result.h"
+#include "ffi/graphics/memory/allocator.h"
+#include "ffi/graphics/renderer/staging.h"
+#include "ffi/graphics/renderer/stats.h"
+#include "mod.h"
+#include "quad.h"
+#include "atlas.h"
+
+// Quads of all the overlay panels are collected during the frame,
+// sorted by (layer, atlas page, scissor) and written into the vertex buffer of the frame slot.
+// Every run of quads sharing the atlas page and the scissor is a single `vkCmdDrawIndexed`.
+
+#define MAX_OVL_QUADS 8192
+
+#define OVL_QUAD_VERTEX_COUNT 4
+#define OVL_QUAD_INDEX_COUNT 6
+
+// All the quads have the same index pattern:
+// the index buffer is static and 16-bit indices are enough
+typedef uint16_t IndexOVL;
+
+struct OverlayBatch {
+    uint32_t page_idx;
+    OverlayScissor scissor;
+    uint32_t first_quad;
+    uint32_t quad_count;
+};
+
+struct OverlaySortItem {
+    uint32_t layer;
+    uint32_t page_idx;
+    OverlayScissor scissor;
+    uint32_t quad_idx;
+};
+
+struct OverlayVertexBuffer {
+    VkBuffer buffer;
+    struct GpuAllocation allocation;
+};
+
+struct OverlayDrawList {
+    struct GpuAllocator *allocator;
+    struct PipelineOVL *pipeline;
+    struct OverlayAtlas *atlas;
+
+    VkBuffer index_buffer;
+    struct GpuAllocation index_allocation;
+
+    // One per frame slot: the buffer is written while the slot fence is signaled only
+    struct OverlayVertexBuffer *vertex_buffers;
+    uint32_t frame_count;
+
+    // The texture rects are resolved to the atlas page on push
+    OverlayQuad *quads;
+    struct OverlaySortItem *sort_items;
+    uint32_t quad_count;
+    uint32_t dropped_quad_count;
+
+    struct OverlayBatch *batches;
+    uint32_t batch_count;
+
+    OverlayDrawStats stats;
+};
+
+// The static index buffer is uploaded through the staging ring with the next frame
+Result new_overlay_draw_list(
+    struct GpuAllocator *allocator,
+    struct StagingRing *staging,
+    struct PipelineOVL *pipeline,
+    struct OverlayAtlas *atlas,
+    uint32_t frame_count
+);
+
+// Quads beyond `MAX_OVL_QUADS` are dropped (and counted in the stats)
+void overlay_draw_list_push(struct OverlayDrawList *list, const OverlayQuad *quads, uint32_t count);
+
+// Drops the collected quads (e.g. the frame is skipped)
+void clear_overlay_draw_list(struct OverlayDrawList *list);
+
+// Sorts the collected quads into batches and writes the vertex buffer of the frame slot.
+// The batches are recorded by `cmd_draw_overlay_batches`, then the list must be cleared.
+void prepare_overlay_draw_list(struct OverlayDrawList *list, uint32_t frame_idx);
+
+// Records the batches `[first_batch, first_batch + batch_count)` of the prepared list.
+// The batch ranges can be recorded into different command buffers in parallel.
+// Must be called inside of the overlay subpass, the viewport must be set.
+void cmd_draw_overlay_batches(
+    struct OverlayDrawList *list,
+    VkCommandBuffer cmd_buffer,
+    uint32_t frame_idx,
+    VkExtent2D extent,
+    uint32_t first_batch,
+    uint32_t batch_count
+);
+
+void drop_overlay_draw_list(struct OverlayDrawList *list);
+
+#endif // ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_DRAW_LIST_H___
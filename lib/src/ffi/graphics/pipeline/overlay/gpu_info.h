@@ -5,9 +5,47 @@
 #define OVL_VERTEX_INPUT_LOCATION_COLOR 1
 #define OVL_VERTEX_INPUT_LOCATION_TEXTURE 2
 
+// The overlay vertex format: the C struct, the pipeline vertex input
+// and the HLSL vertex input are all generated from `OVL_VERTEX_ATTRIBUTES`.
+//
+// The compact format is 12 bytes per vertex instead of 32:
+// - positions are 16-bit fixed point pixels with `OVL_POS_SUBPIXEL_BITS` fraction bits;
+// - colors are `R8G8B8A8_UNORM`;
+// - texture coordinates are 16-bit texels (the sampler uses unnormalized coordinates).
+#ifndef OVL_COMPACT_VERTEX
+#   define OVL_COMPACT_VERTEX 1
+#endif // OVL_COMPACT_VERTEX
+
+// ATTR(field, C type, HLSL type, Vulkan format, location, semantics)
+#if OVL_COMPACT_VERTEX
+#   define OVL_POS_SUBPIXEL_BITS 2
+#   define OVL_POS_SCALE (1.0 / (1 << OVL_POS_SUBPIXEL_BITS))
+
+#   define OVL_VERTEX_ATTRIBUTES(ATTR) \
+        ATTR(pos, short2, int2, VK_FORMAT_R16G16_SINT, OVL_VERTEX_INPUT_LOCATION_POS, POSITION) \
+        ATTR(color, ubyte4, float4, VK_FORMAT_R8G8B8A8_UNORM, OVL_VERTEX_INPUT_LOCATION_COLOR, COLOR) \
+        ATTR(tex, ushort2, uint2, VK_FORMAT_R16G16_UINT, OVL_VERTEX_INPUT_LOCATION_TEXTURE, TEXCOORD)
+#else
+#   define OVL_POS_SCALE 1.0
+
+#   define OVL_VERTEX_ATTRIBUTES(ATTR) \
+        ATTR(pos, float2, float2, VK_FORMAT_R32G32_SFLOAT, OVL_VERTEX_INPUT_LOCATION_POS, POSITION) \
+        ATTR(color, float4, float4, VK_FORMAT_R32G32B32A32_SFLOAT, OVL_VERTEX_INPUT_LOCATION_COLOR, COLOR) \
+        ATTR(tex, float2, float2, VK_FORMAT_R32G32_SFLOAT, OVL_VERTEX_INPUT_LOCATION_TEXTURE, TEXCOORD)
+#endif // OVL_COMPACT_VERTEX
+
 #define OVL_FRAGMENT_INPUT_LOCATION_COLOR 0
+#define OVL_FRAGMENT_INPUT_LOCATION_TEXTURE 1
 
+// The atlas page and the (immutable) sampler are separate bindings:
+// HLSL has no combined image samplers
 #define OVL_DESCR_SET 0
-#define OVL_COMBINED_IMAGE_SAMPLER_DESCR_BINDING 0
+#define OVL_ATLAS_DESCR_BINDING 0
+#define OVL_SAMPLER_DESCR_BINDING 1
+
+// The fragment specialization constants (`VkBool32` on the C side).
+// The alpha test discards the almost transparent fragments of the sparse quads (e.g. glyphs).
+#define OVL_ALPHA_TEST_CONSTANT_ID 0
+#define OVL_ALPHA_TEST_THRESHOLD (1.0 / 255.0)
 
 #endif // ___APRIORI2_GRAPHICS_PIPELINE_SHADER_INFO_H___
\ No newline at end of file
@@ -1,42 +1,59 @@
 #ifndef ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_H___
 #define ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_H___
 
+#include <stdbool.h>
 #include <vulkan/vulkan.h>
 
 #include "ffi/core/result.h"
 #include "ffi/util/mod.h"
 #include "ffi/math/mod.h"
+#include "ffi/graphics/pipeline/bindless.h"
+#include "vertex_overlay.h"
 
-#define OVL_COMBINED_IMAGE_SAMPLER_DESCR_IDX 0
-
-#define OVL_PUSH_CONSTANT_POSITION_SIZE sizeof(Coord)
-#define OVL_PUSH_CONSTANT_IMAGE_EXTENT_SIZE sizeof(VkExtent2D)
-
-#define PUSH_CONSTANTS_SIZE_COUNT_UNITS 4
-
-#define PUSH_CONSTANTS_RAW_SIZE ( \
-    OVL_PUSH_CONSTANT_POSITION_SIZE \
-    + OVL_PUSH_CONSTANT_IMAGE_EXTENT_SIZE \
-)
-
-#define OVL_PUSH_CONSTANTS_SIZE AS_BINARY_COUNT_UNITS( \
-    PUSH_CONSTANTS_RAW_SIZE, \
-    PUSH_CONSTANTS_SIZE_COUNT_UNITS, \
-    uint32_t \
-)
+#define OVL_PUSH_CONSTANTS_SIZE sizeof(struct PushConstantsOVL)
+#define OVL_PUSH_CONSTANTS_STAGES (VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT)
 
 struct PipelineOVL;
 
+// The pipeline samples the atlas pages through the `bindless` table if it isn't NULL,
+// otherwise through its own descriptor set (one per page).
+// `is_alpha_test` is a specialization constant, not a separate shader variant.
 Result new_pipeline_ovl(
     VkDevice device,
     VkRenderPass render_pass,
-    const VkExtent2D *render_target_extent,
+    VkPipelineCache pipeline_cache,
     uint32_t render_target_count,
-    float *anisotropy
+    float *anisotropy,
+    struct BindlessTable *bindless,
+    bool is_alpha_test
 );
 
 void drop_pipeline_ovl(struct PipelineOVL *pipeline);
 
-Result get_ovl_descriptor_pool_sizes();
+struct PipelineOVLRebuild;
+
+// Creates the pipeline with new shaders (e.g. hot reloaded) for the same layout and render pass.
+// Can be called on any thread while `pipeline` is in use.
+// The fragment shader must be the `pipeline_ovl_fragment_variant` variant.
+Result new_pipeline_ovl_rebuild(
+    struct PipelineOVL *pipeline,
+    const uint32_t *vertex_code,
+    size_t vertex_code_size,
+    const uint32_t *fragment_code,
+    size_t fragment_code_size
+);
+
+// Exchanges the shaders and the pipeline: `rebuild` takes the old ones,
+// it must not be dropped until the GPU has finished the frames using them.
+// Must be called on the thread recording the frames.
+void swap_pipeline_ovl(struct PipelineOVL *pipeline, struct PipelineOVLRebuild *rebuild);
+
+void drop_pipeline_ovl_rebuild(struct PipelineOVLRebuild *rebuild);
+
+// The `FRAGMENT_OVERLAY_VARIANT_*` bitmask of the fragment shader
+uint32_t pipeline_ovl_fragment_variant(struct PipelineOVL *pipeline);
+
+// The descriptors of `set_count` overlay sets (a DynArray of `VkDescriptorPoolSize`)
+Result get_ovl_descriptor_pool_sizes(uint32_t set_count);
 
 #endif // ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_H___
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "gpu_info.h"
 
 #include "ffi/core/log.h"
+#include "ffi/core/cpu_profiler/mod.h"
 #include "ffi/util/mod.h"
 #include "ffi/graphics/renderer/mod.h"
 
@@ -14,31 +15,32 @@
 
 #define LOG_TARGET LOG_STRUCT_TARGET(PipelineOVL)
 
-Result new_pipeline_ovl(
-    VkDevice device,
-    VkRenderPass render_pass,
-    const VkExtent2D *render_target_extent,
-    uint32_t render_target_count,
-    float *anisotropy
+// Creates the graphics pipeline with the given shaders.
+// Reads only the fields of `pipeline` fixed at creation, so it can run on any thread.
+Result create_pipeline_ovl_handle(
+    struct PipelineOVL *pipeline,
+    VkShaderModule vertex_shader,
+    VkShaderModule fragment_shader,
+    VkPipeline *vk_handle
 ) {
-    ASSERT_NOT_NULL(device);
-    ASSERT_NOT_NULL(render_pass);
-    ASSERT_NOT_NULL(render_target_extent);
-
     Result result = { 0 };
-    struct PipelineOVL *pipeline = NULL;
 
-    VkShaderModuleCreateInfo vertex_shader_ci = {
-        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+    VkBool32 alpha_test = pipeline->is_alpha_test ? VK_TRUE : VK_FALSE;
+
+    VkSpecializationMapEntry fragment_constants[] = {
+        {
+            .constantID = OVL_ALPHA_TEST_CONSTANT_ID,
+            .offset = 0,
+            .size = sizeof(alpha_test)
+        }
     };
-    vertex_shader_ci.codeSize = vertex_overlay_code_size();
-    vertex_shader_ci.pCode = vertex_overlay();
 
-    VkShaderModuleCreateInfo fragment_shader_ci = {
-        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+    VkSpecializationInfo fragment_specialization = {
+        .mapEntryCount = STATIC_ARRAY_SIZE(fragment_constants),
+        .dataSize = sizeof(alpha_test),
     };
-    fragment_shader_ci.codeSize = fragment_overlay_code_size();
-    fragment_shader_ci.pCode = fragment_overlay();
+    fragment_specialization.pMapEntries = fragment_constants;
+    fragment_specialization.pData = &alpha_test;
 
     VkVertexInputBindingDescription vertex_binding_descr = {
         .binding = OVL_VERTEX_INPUT_BINDING,
@@ -46,26 +48,19 @@ Result new_pipeline_ovl(
         .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
     };
 
-    VkVertexInputAttributeDescription vertex_attr_descrs[] = {
-        {
-            .binding = OVL_VERTEX_INPUT_BINDING,
-            .location = OVL_VERTEX_INPUT_LOCATION_POS,
-            .offset = offsetof(struct VertexOVL, pos),
-            .format = VK_FORMAT_R32G32_SFLOAT
-        },
-        {
-            .binding = OVL_VERTEX_INPUT_BINDING,
-            .location = OVL_VERTEX_INPUT_LOCATION_COLOR,
-            .offset = offsetof(struct VertexOVL, color),
-            .format = VK_FORMAT_R32G32B32A32_SFLOAT
-        },
-        {
-            .binding = OVL_VERTEX_INPUT_BINDING,
-            .location = OVL_VERTEX_INPUT_LOCATION_TEXTURE,
-            .offset = offsetof(struct VertexOVL, tex),
-            .format = VK_FORMAT_R32G32_SFLOAT
+#   define OVL_VERTEX_ATTRIBUTE_DESCR(field, c_type, hlsl_type, vk_format, loc, sem) \
+        { \
+            .binding = OVL_VERTEX_INPUT_BINDING, \
+            .location = (loc), \
+            .offset = offsetof(struct VertexOVL, field), \
+            .format = (vk_format) \
         },
+
+    VkVertexInputAttributeDescription vertex_attr_descrs[] = {
+        OVL_VERTEX_ATTRIBUTES(OVL_VERTEX_ATTRIBUTE_DESCR)
     };
+
+#   undef OVL_VERTEX_ATTRIBUTE_DESCR
     VkPipelineVertexInputStateCreateInfo vertex_input_state_ci = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .vertexBindingDescriptionCount = 1,
@@ -80,16 +75,13 @@ Result new_pipeline_ovl(
         .primitiveRestartEnable = VK_FALSE
     };
 
-    VkRect2D scissor = {
-        .offset = {0, 0}
-    };
-    scissor.extent = *render_target_extent;
-
+    // Both viewport and scissor are dynamic:
+    // the pipeline survives the swapchain recreation
     VkPipelineViewportStateCreateInfo viewport_ci = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .viewportCount = 1,
         .scissorCount = 1
     };
-    viewport_ci.pScissors = &scissor;
 
     VkPipelineRasterizationStateCreateInfo raster_state_ci = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
@@ -106,7 +98,7 @@ Result new_pipeline_ovl(
     VkPipelineColorBlendAttachmentState *color_blend_attachments = ALLOC_ARRAY(
         result,
         VkPipelineColorBlendAttachmentState,
-        render_target_count
+        pipeline->render_target_count
     );
     color_blend_attachments->colorWriteMask = VK_COLOR_COMPONENT_R_BIT
         | VK_COLOR_COMPONENT_G_BIT
@@ -124,16 +116,106 @@ Result new_pipeline_ovl(
     VkPipelineColorBlendStateCreateInfo color_blend_ci = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
     };
-    color_blend_ci.attachmentCount = render_target_count;
+    // The overlay subpass has the only color attachment
+    color_blend_ci.attachmentCount = 1;
     color_blend_ci.pAttachments = color_blend_attachments;
 
-    VkDynamicState dyn_viewport = VK_DYNAMIC_STATE_VIEWPORT;
+    VkDynamicState dyn_states[] = {
+        VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR
+    };
 
     VkPipelineDynamicStateCreateInfo dyn_state_ci = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-        .dynamicStateCount = 1,
+        .dynamicStateCount = STATIC_ARRAY_SIZE(dyn_states),
     };
-    dyn_state_ci.pDynamicStates = &dyn_viewport;
+    dyn_state_ci.pDynamicStates = dyn_states;
+
+    VkPipelineShaderStageCreateInfo stages[] = {
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_VERTEX_BIT,
+            .pName = SHADER_DEFAULT_ENTRY_POINT
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .pName = SHADER_DEFAULT_ENTRY_POINT
+        }
+    };
+    stages[0].module = vertex_shader;
+    stages[1].module = fragment_shader;
+    stages[1].pSpecializationInfo = &fragment_specialization;
+
+    VkGraphicsPipelineCreateInfo pipeline_ci = {
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .subpass = RENDER_SUBPASS_OVERLAY_IDX
+    };
+    pipeline_ci.stageCount = STATIC_ARRAY_SIZE(stages);
+    pipeline_ci.pStages = stages;
+    pipeline_ci.pVertexInputState = &vertex_input_state_ci;
+    pipeline_ci.pInputAssemblyState = &input_assembly_ci;
+    pipeline_ci.pViewportState = &viewport_ci;
+    pipeline_ci.pRasterizationState = &raster_state_ci;
+    pipeline_ci.pMultisampleState = &multisample_ci;
+    pipeline_ci.pColorBlendState = &color_blend_ci;
+    pipeline_ci.pDynamicState = &dyn_state_ci;
+    pipeline_ci.layout = pipeline->layout;
+    pipeline_ci.renderPass = pipeline->render_pass;
+
+    result.error = VK_RESULT(vkCreateGraphicsPipelines(
+        pipeline->device,
+        pipeline->pipeline_cache,
+        1,
+        &pipeline_ci,
+        NULL,
+        vk_handle
+    ));
+
+    FN_FORCE_EXIT(result, {
+        free(color_blend_attachments);
+    });
+}
+
+Result create_pipeline_ovl_shader(VkDevice device, const uint32_t *code, size_t code_size, VkShaderModule *shader) {
+    Result result = { 0 };
+
+    VkShaderModuleCreateInfo shader_ci = {
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+    };
+    shader_ci.codeSize = code_size;
+    shader_ci.pCode = code;
+
+    result.error = VK_RESULT(vkCreateShaderModule(
+        device,
+        &shader_ci,
+        NULL,
+        shader
+    ));
+
+    return result;
+}
+
+Result new_pipeline_ovl(
+    VkDevice device,
+    VkRenderPass render_pass,
+    VkPipelineCache pipeline_cache,
+    uint32_t render_target_count,
+    float *anisotropy,
+    struct BindlessTable *bindless,
+    bool is_alpha_test
+) {
+    ASSERT_NOT_NULL(device);
+    ASSERT_NOT_NULL(render_pass);
+
+    Result result = { 0 };
+    struct PipelineOVL *pipeline = NULL;
+
+    PROFILE_ZONE_BEGIN(new_pipeline_ovl);
+
+    uint32_t fragment_variant = 0;
+    if (bindless != NULL)
+        fragment_variant |= FRAGMENT_OVERLAY_VARIANT_OVL_BINDLESS;
 
     VkSamplerCreateInfo sampler_ci = {
         .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
@@ -149,21 +231,12 @@ Result new_pipeline_ovl(
         .unnormalizedCoordinates = VK_TRUE
     };
 
-    VkPushConstantRange ui_plane_position_pcr = {
-        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
-        .offset = 0,
-        .size = sizeof(float2)
-    };
-
-    VkPushConstantRange ui_plane_extent_pcr = {
-        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-        .offset = sizeof(float2),
-        .size = sizeof(VkExtent2D)
-    };
-
     VkPushConstantRange push_constant_ranges[] = {
-        ui_plane_position_pcr,
-        ui_plane_extent_pcr
+        {
+            .stageFlags = OVL_PUSH_CONSTANTS_STAGES,
+            .offset = 0,
+            .size = OVL_PUSH_CONSTANTS_SIZE
+        }
     };
 
     VkDescriptorSetLayoutCreateInfo descr_set_layout_ci = {
@@ -174,106 +247,107 @@ Result new_pipeline_ovl(
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO
     };
 
-    VkGraphicsPipelineCreateInfo pipeline_ci = {
-        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-        .subpass = RENDER_SUBPASS_OVERLAY_IDX
-    };
-
     info(LOG_TARGET, "creating new pipeline overlay...");
 
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "vertex format: %s (%d bytes)"),
+        OVL_COMPACT_VERTEX ? "compact" : "float",
+        AS(sizeof(struct VertexOVL), uint32_t)
+    );
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "bindless: %s"), bindless != NULL ? "yes" : "no");
+    trace(LOG_TARGET, LOG_GROUP(struct, "alpha test: %s"), is_alpha_test ? "yes" : "no");
+
     pipeline = ALLOC(result, struct PipelineOVL);
     pipeline->device = device;
-
-    result.error = vkCreateShaderModule(
+    pipeline->render_pass = render_pass;
+    pipeline->pipeline_cache = pipeline_cache;
+    pipeline->render_target_count = render_target_count;
+    pipeline->is_alpha_test = is_alpha_test;
+    pipeline->fragment_variant = fragment_variant;
+    pipeline->bindless = bindless;
+
+    result = create_pipeline_ovl_shader(
         device,
-        &vertex_shader_ci,
-        NULL,
+        vertex_overlay(),
+        vertex_overlay_code_size(),
         &pipeline->vertex_shader
     );
     EXPECT_SUCCESS(result);
 
-    result.error = vkCreateShaderModule(
+    result = create_pipeline_ovl_shader(
         device,
-        &fragment_shader_ci,
-        NULL,
+        fragment_overlay(fragment_variant),
+        fragment_overlay_code_size(fragment_variant),
         &pipeline->fragment_shader
     );
     EXPECT_SUCCESS(result);
 
-    VkPipelineShaderStageCreateInfo stages[] = {
-        {
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-            .stage = VK_SHADER_STAGE_VERTEX_BIT,
-            .pName = SHADER_DEFAULT_ENTRY_POINT
-        },
-        {
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-            .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
-            .pName = SHADER_DEFAULT_ENTRY_POINT
-        }
-    };
-    stages[0].module = pipeline->vertex_shader;
-    stages[1].module = pipeline->fragment_shader;
-
-    result.error = vkCreateSampler(
-        device,
-        &sampler_ci,
-        NULL,
-        &pipeline->sampler
-    );
-    EXPECT_SUCCESS(result);
-
-    VkDescriptorSetLayoutBinding set_layout_bindings[] = {
-        {
-            .binding = OVL_COMBINED_IMAGE_SAMPLER_DESCR_BINDING,
-            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount = 1,
-            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
-        }
-    };
-    set_layout_bindings[0].pImmutableSamplers = &pipeline->sampler;
-
-    descr_set_layout_ci.bindingCount = STATIC_ARRAY_SIZE(set_layout_bindings);
-    descr_set_layout_ci.pBindings = set_layout_bindings;
-
-    result.error = vkCreateDescriptorSetLayout(
-        device,
-        &descr_set_layout_ci,
-        NULL,
-        &pipeline->descr_set_layout
-    );
-    EXPECT_SUCCESS(result);
+    // The bindless table has its own layout and samplers
+    if (bindless == NULL) {
+        result.error = VK_RESULT(vkCreateSampler(
+            device,
+            &sampler_ci,
+            NULL,
+            &pipeline->sampler
+        ));
+        EXPECT_SUCCESS(result);
+
+        VkDescriptorSetLayoutBinding set_layout_bindings[] = {
+            {
+                .binding = OVL_ATLAS_DESCR_BINDING,
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                .descriptorCount = 1,
+                .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
+            },
+            {
+                .binding = OVL_SAMPLER_DESCR_BINDING,
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+                .descriptorCount = 1,
+                .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
+            }
+        };
+        set_layout_bindings[1].pImmutableSamplers = &pipeline->sampler;
+
+        descr_set_layout_ci.bindingCount = STATIC_ARRAY_SIZE(set_layout_bindings);
+        descr_set_layout_ci.pBindings = set_layout_bindings;
+
+        result.error = VK_RESULT(vkCreateDescriptorSetLayout(
+            device,
+            &descr_set_layout_ci,
+            NULL,
+            &pipeline->descr_set_layout
+        ));
+        EXPECT_SUCCESS(result);
+    }
 
     layout_ci.setLayoutCount = 1;
-    layout_ci.pSetLayouts = &pipeline->descr_set_layout;
+    layout_ci.pSetLayouts = bindless != NULL ? &bindless->layout : &pipeline->descr_set_layout;
     layout_ci.pushConstantRangeCount = STATIC_ARRAY_SIZE(push_constant_ranges);
     layout_ci.pPushConstantRanges = push_constant_ranges;
 
-    result.error = vkCreatePipelineLayout(
+    result.error = VK_RESULT(vkCreatePipelineLayout(
         device,
         &layout_ci,
         NULL,
         &pipeline->layout
-    );
+    ));
     EXPECT_SUCCESS(result);
 
-    pipeline_ci.stageCount = STATIC_ARRAY_SIZE(stages);
-    pipeline_ci.pStages = stages;
-    pipeline_ci.pVertexInputState = &vertex_input_state_ci;
-    pipeline_ci.pInputAssemblyState = &input_assembly_ci;
-    pipeline_ci.pViewportState = &viewport_ci;
-    pipeline_ci.pRasterizationState = &raster_state_ci;
-    pipeline_ci.pMultisampleState = &multisample_ci;
-    pipeline_ci.pColorBlendState = &color_blend_ci;
-    pipeline_ci.pDynamicState = &dyn_state_ci;
-    pipeline_ci.layout = pipeline->layout;
-    pipeline_ci.renderPass = render_pass;
+    result = create_pipeline_ovl_handle(
+        pipeline,
+        pipeline->vertex_shader,
+        pipeline->fragment_shader,
+        &pipeline->vk_handle
+    );
+    EXPECT_SUCCESS(result);
 
     info(LOG_TARGET, "new pipeline overlay created successfully");
     result.object = pipeline;
 
     FN_EXIT(result, {
-        free(color_blend_attachments);
+        PROFILE_ZONE_END(new_pipeline_ovl);
     });
 
     FN_FAILURE(result, {
@@ -281,6 +355,112 @@ Result new_pipeline_ovl(
     });
 }
 
+Result new_pipeline_ovl_rebuild(
+    struct PipelineOVL *pipeline,
+    const uint32_t *vertex_code,
+    size_t vertex_code_size,
+    const uint32_t *fragment_code,
+    size_t fragment_code_size
+) {
+    ASSERT_NOT_NULL(pipeline);
+    ASSERT_NOT_NULL(vertex_code);
+    ASSERT_NOT_NULL(fragment_code);
+
+    Result result = { 0 };
+    struct PipelineOVLRebuild *rebuild = NULL;
+
+    debug(LOG_TARGET, "rebuilding pipeline overlay...");
+
+    rebuild = ALLOC(result, struct PipelineOVLRebuild);
+    rebuild->device = pipeline->device;
+
+    result = create_pipeline_ovl_shader(
+        pipeline->device,
+        vertex_code,
+        vertex_code_size,
+        &rebuild->vertex_shader
+    );
+    EXPECT_SUCCESS(result);
+
+    result = create_pipeline_ovl_shader(
+        pipeline->device,
+        fragment_code,
+        fragment_code_size,
+        &rebuild->fragment_shader
+    );
+    EXPECT_SUCCESS(result);
+
+    result = create_pipeline_ovl_handle(
+        pipeline,
+        rebuild->vertex_shader,
+        rebuild->fragment_shader,
+        &rebuild->vk_handle
+    );
+    EXPECT_SUCCESS(result);
+
+    debug(LOG_TARGET, "pipeline overlay rebuilt successfully");
+    result.object = rebuild;
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_pipeline_ovl_rebuild(rebuild);
+    });
+}
+
+void swap_pipeline_ovl(struct PipelineOVL *pipeline, struct PipelineOVLRebuild *rebuild) {
+    ASSERT_NOT_NULL(pipeline);
+    ASSERT_NOT_NULL(rebuild);
+
+    VkShaderModule vertex_shader = pipeline->vertex_shader;
+    VkShaderModule fragment_shader = pipeline->fragment_shader;
+    VkPipeline vk_handle = pipeline->vk_handle;
+
+    pipeline->vertex_shader = rebuild->vertex_shader;
+    pipeline->fragment_shader = rebuild->fragment_shader;
+    pipeline->vk_handle = rebuild->vk_handle;
+
+    rebuild->vertex_shader = vertex_shader;
+    rebuild->fragment_shader = fragment_shader;
+    rebuild->vk_handle = vk_handle;
+
+    debug(LOG_TARGET, "pipeline overlay swapped");
+}
+
+uint32_t pipeline_ovl_fragment_variant(struct PipelineOVL *pipeline) {
+    ASSERT_NOT_NULL(pipeline);
+
+    return pipeline->fragment_variant;
+}
+
+void drop_pipeline_ovl_rebuild(struct PipelineOVLRebuild *rebuild) {
+    if (rebuild == NULL)
+        goto exit;
+
+    vkDestroyPipeline(
+        rebuild->device,
+        rebuild->vk_handle,
+        NULL
+    );
+
+    vkDestroyShaderModule(
+        rebuild->device,
+        rebuild->fragment_shader,
+        NULL
+    );
+
+    vkDestroyShaderModule(
+        rebuild->device,
+        rebuild->vertex_shader,
+        NULL
+    );
+
+    free(rebuild);
+
+exit:
+    debug(LOG_TARGET, "drop pipeline OVL rebuild");
+}
+
 void drop_pipeline_ovl(struct PipelineOVL *pipeline) {
     if (pipeline == NULL)
         goto exit;
@@ -321,22 +501,27 @@ void drop_pipeline_ovl(struct PipelineOVL *pipeline) {
         NULL
     );
 
+    free(pipeline);
+
 exit:
     debug(LOG_TARGET, "drop pipeline OVL");
 }
 
-Result get_ovl_descriptor_pool_sizes(uint32_t render_target_count) {
+Result get_ovl_descriptor_pool_sizes(uint32_t set_count) {
     Result result = { 0 };
-    const size_t needed_descriptor_count = render_target_count;
+    DynArray pool_sizes = NULL;
+    VkDescriptorPoolSize *sizes = NULL;
 
-    VkDescriptorPoolSize *pool_sizes = ALLOC_ARRAY_UNINIT(
-        result,
-        VkDescriptorPoolSize,
-        needed_descriptor_count
-    );
+    result = NEW_DYN_ARRAY(VkDescriptorPoolSize, 2);
+    RESULT_UNWRAP(pool_sizes, result);
+
+    sizes = pool_sizes->data;
 
-    pool_sizes[OVL_COMBINED_IMAGE_SAMPLER_DESCR_IDX].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    pool_sizes[OVL_COMBINED_IMAGE_SAMPLER_DESCR_IDX].descriptorCount = render_target_count;
+    // The immutable sampler is counted by the pool as well
+    sizes[0].type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    sizes[0].descriptorCount = set_count;
+    sizes[1].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    sizes[1].descriptorCount = set_count;
 
     FN_FORCE_EXIT(result);
 }
@@ -7,12 +7,26 @@
 
 struct PipelineOVL {
     VkDevice device;
+    VkRenderPass render_pass;
+    VkPipelineCache pipeline_cache;
+    uint32_t render_target_count;
+    bool is_alpha_test;
+    uint32_t fragment_variant;
     VkShaderModule vertex_shader;
     VkShaderModule fragment_shader;
     VkSampler sampler;
     VkDescriptorSetLayout descr_set_layout;
+    struct BindlessTable *bindless;
     VkPipelineLayout layout;
     VkPipeline vk_handle;
 };
 
+// The shaders and the pipeline rebuilt for the same layout and render pass
+struct PipelineOVLRebuild {
+    VkDevice device;
+    VkShaderModule vertex_shader;
+    VkShaderModule fragment_shader;
+    VkPipeline vk_handle;
+};
+
 #endif // ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_IMPL_H___
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_QUAD_H___
+#define ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_QUAD_H___
+
+#include <stdint.h>
+
+// In pixels, the origin is the top left corner of the render target
+typedef struct OverlayRect {
+    float x;
+    float y;
+    float width;
+    float height;
+} OverlayRect;
+
+// The zero extent means the whole render target
+typedef struct OverlayScissor {
+    int32_t x;
+    int32_t y;
+    uint32_t width;
+    uint32_t height;
+} OverlayScissor;
+
+typedef struct OverlayQuad {
+    OverlayRect rect;
+
+    // In texels of the image, the origin is the top left corner of the image
+    OverlayRect tex_rect;
+
+    // Multiplies the image texels
+    float color[4];
+
+    // The overlay image id, 0 means untextured.
+    // The removed and evicted images are drawn untextured.
+    uint32_t texture_id;
+
+    // Quads are drawn from the lowest layer to the highest one.
+    // The order inside of a layer is unspecified:
+    // it is what makes merging the draw calls possible.
+    uint32_t layer;
+
+    OverlayScissor scissor;
+} OverlayQuad;
+
+#endif // ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_QUAD_H___
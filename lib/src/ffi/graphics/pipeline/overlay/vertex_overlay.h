@@ -4,15 +4,26 @@
 #include "ffi/graphics/gpu.h"
 #include "ffi/graphics/pipeline/overlay/gpu_info.h"
 
+#define ___apriori_impl_OVL_VERTEX_FIELD(field, c_type, hlsl_type, vk_format, loc, sem) \
+    vk_location(loc) \
+    gpu_type(c_type, hlsl_type) field semantics(sem);
+
 struct VertexOVL {
-    vk_location(OVL_VERTEX_INPUT_LOCATION_POS)
-    float2 pos semantics(POSITION);
+    OVL_VERTEX_ATTRIBUTES(___apriori_impl_OVL_VERTEX_FIELD)
+};
 
-    vk_location(OVL_VERTEX_INPUT_LOCATION_COLOR)
-    float4 color semantics(COLOR);
+#undef ___apriori_impl_OVL_VERTEX_FIELD
 
-    vk_location(OVL_VERTEX_INPUT_LOCATION_TEXTURE)
-    float2 tex semantics(TEXCOORD);
+// Vertex positions are in pixels (the origin is the top left corner):
+// all the overlay quads share one transform to the clip space,
+// so they can be drawn by a single draw call.
+//
+// `texture_idx` is the bindless slot of the atlas page (the bindless mode only),
+// it is the only constant pushed per batch.
+struct PushConstantsOVL {
+    float2 scale;
+    float2 translate;
+    gpu_type(uint32_t, uint) texture_idx;
 };
 
 #endif // ___APRIORI2_GRAPHICS_PIPELINE_OVERLAY_VERTEX_H___
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef ___APRIORI2_GRAPHICS_PIPELINE_STATS_H___
+#define ___APRIORI2_GRAPHICS_PIPELINE_STATS_H___
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct PipelineCacheStats {
+    // Whether the pipeline cache was loaded from disk (warm start)
+    bool is_warm;
+    uint64_t loaded_data_size;
+
+    // Creation time of all renderer pipelines
+    uint64_t creation_time_ns;
+} PipelineCacheStats;
+
+#endif // ___APRIORI2_GRAPHICS_PIPELINE_STATS_H___
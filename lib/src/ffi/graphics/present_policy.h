@@ -0,0 +1,36 @@
+#ifndef ___APRIORI2_GRAPHICS_PRESENT_POLICY_H___
+#define ___APRIORI2_GRAPHICS_PRESENT_POLICY_H___
+
+#include <stdint.h>
+
+typedef enum PresentPolicy {
+    // IMMEDIATE or MAILBOX with (min + 1) images
+    PRESENT_POLICY_LOW_LATENCY,
+
+    // FIFO with triple buffering
+    PRESENT_POLICY_THROUGHPUT,
+
+    // FIFO_RELAXED with the minimal image count
+    PRESENT_POLICY_POWER_SAVING
+} PresentPolicy;
+
+// Mirrors VkPresentModeKHR (Vulkan types are not visible from Rust)
+typedef enum PresentMode {
+    // The offscreen swapchain is not presented
+    PRESENT_MODE_NONE,
+    PRESENT_MODE_IMMEDIATE,
+    PRESENT_MODE_MAILBOX,
+    PRESENT_MODE_FIFO,
+    PRESENT_MODE_FIFO_RELAXED
+} PresentMode;
+
+// What the swapchain actually got for the requested policy
+typedef struct SwapchainInfo {
+    PresentPolicy policy;
+    PresentMode present_mode;
+    uint32_t image_count;
+    uint32_t image_width;
+    uint32_t image_height;
+} SwapchainInfo;
+
+#endif // ___APRIORI2_GRAPHICS_PRESENT_POLICY_H___
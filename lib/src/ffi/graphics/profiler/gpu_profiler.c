@@ -0,0 +1,300 @@
+#include <string.h>
+#include <stdint.h>
+
+#include "gpu_profiler.h"
+
+#include "ffi/core/log.h"
+#include "ffi/util/mod.h"
+#include "ffi/math/mod.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(GpuProfiler)
+
+#define GPU_SCOPE_QUERY_COUNT 2
+#define GPU_PROFILER_QUERY_COUNT (MAX_GPU_SCOPES * GPU_SCOPE_QUERY_COUNT)
+
+// Every query result is followed by its availability
+#define GPU_QUERY_RESULT_COUNT 2
+
+Result timestamp_valid_bits(VkPhysicalDevice phy_device, uint32_t queue_family_idx, uint32_t *valid_bits) {
+    Result result = { 0 };
+    VkQueueFamilyProperties *family_props = NULL;
+    uint32_t family_count = 0;
+
+    vkGetPhysicalDeviceQueueFamilyProperties(phy_device, &family_count, NULL);
+
+    family_props = ALLOC_ARRAY_UNINIT(result, VkQueueFamilyProperties, family_count);
+
+    vkGetPhysicalDeviceQueueFamilyProperties(phy_device, &family_count, family_props);
+
+    assert(queue_family_idx < family_count && "queue family index is out of range");
+    *valid_bits = family_props[queue_family_idx].timestampValidBits;
+
+    FN_FORCE_EXIT(result, {
+        free(family_props);
+    });
+}
+
+Result new_gpu_profiler(
+    VkPhysicalDevice phy_device,
+    VkDevice device,
+    const VkPhysicalDeviceProperties *props,
+    uint32_t queue_family_idx,
+    uint32_t frame_count
+) {
+    ASSERT_NOT_NULL(phy_device);
+    ASSERT_NOT_NULL(device);
+    ASSERT_NOT_NULL(props);
+
+    Result result = { 0 };
+    uint32_t valid_bits = 0;
+    VkQueryPoolCreateInfo query_pool_ci = {
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = GPU_PROFILER_QUERY_COUNT
+    };
+
+    info(LOG_TARGET, "creating new GPU profiler...");
+
+    struct GpuProfiler *profiler = ALLOC(result, struct GpuProfiler);
+
+    profiler->device = device;
+    profiler->frame_count = frame_count;
+
+    result = timestamp_valid_bits(phy_device, queue_family_idx, &valid_bits);
+    EXPECT_SUCCESS(result);
+
+    profiler->is_supported = valid_bits > 0 && props->limits.timestampPeriod > 0.0f;
+    profiler->ns_per_tick = props->limits.timestampPeriod;
+    profiler->tick_mask = valid_bits >= 64 ? UINT64_MAX : POW_2(valid_bits, uint64_t) - 1;
+    profiler->stats.is_supported = profiler->is_supported;
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "timestamps: %s (valid bits: %d, period: %f ns)"),
+        profiler->is_supported ? "supported" : "not supported",
+        valid_bits, props->limits.timestampPeriod
+    );
+
+    if (!profiler->is_supported)
+        goto created;
+
+    profiler->frames = ALLOC_ARRAY(result, struct GpuProfilerFrame, frame_count);
+
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        result.error = VK_RESULT(vkCreateQueryPool(device, &query_pool_ci, NULL, &profiler->frames[i].query_pool));
+        EXPECT_SUCCESS(result);
+    }
+
+created:
+    result.object = profiler;
+    info(LOG_TARGET, "new GPU profiler created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_gpu_profiler(profiler);
+    });
+}
+
+struct GpuScopeHistory *gpu_scope_history(struct GpuProfiler *profiler, const char *name) {
+    for (uint32_t i = 0; i < profiler->history_count; ++i) {
+        if (profiler->history[i].name == name || !strcmp(profiler->history[i].name, name))
+            return &profiler->history[i];
+    }
+
+    if (profiler->history_count == MAX_GPU_SCOPES)
+        return NULL;
+
+    struct GpuScopeHistory *history = &profiler->history[profiler->history_count++];
+
+    memset(history, 0, sizeof(struct GpuScopeHistory));
+    history->name = name;
+
+    return history;
+}
+
+uint64_t push_gpu_scope_sample(struct GpuScopeHistory *history, uint64_t time_ns) {
+    if (history == NULL)
+        return time_ns;
+
+    if (history->sample_count == GPU_SCOPE_AVG_FRAMES)
+        history->sample_sum -= history->samples[history->next_sample_idx];
+    else
+        history->sample_count += 1;
+
+    history->samples[history->next_sample_idx] = time_ns;
+    history->sample_sum += time_ns;
+    history->next_sample_idx = (history->next_sample_idx + 1) % GPU_SCOPE_AVG_FRAMES;
+
+    return history->sample_sum / history->sample_count;
+}
+
+Result resolve_gpu_profiler_frame(struct GpuProfiler *profiler, struct GpuProfilerFrame *frame) {
+    Result result = { 0 };
+    uint64_t query_results[GPU_PROFILER_QUERY_COUNT * GPU_QUERY_RESULT_COUNT] = { 0 };
+    uint32_t query_count = frame->scope_count * GPU_SCOPE_QUERY_COUNT;
+    GpuProfilerStats *stats = &profiler->stats;
+
+    if (!frame->is_submitted || frame->scope_count == 0)
+        goto exit;
+
+    // The slot fence is signaled: no need to wait for the results.
+    // The queries of an unended scope are never written,
+    // only such scopes are skipped instead of the whole frame.
+    VkResult query_result = vkGetQueryPoolResults(
+        profiler->device,
+        frame->query_pool,
+        0,
+        query_count,
+        sizeof(query_results),
+        query_results,
+        sizeof(uint64_t) * GPU_QUERY_RESULT_COUNT,
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+    );
+
+    if (query_result == VK_NOT_READY)
+        query_result = VK_SUCCESS;
+
+    result.error = VK_RESULT(query_result);
+    EXPECT_SUCCESS(result);
+
+    stats->frame_number = frame->frame_number;
+    stats->scope_count = 0;
+
+    for (uint32_t i = 0; i < frame->scope_count; ++i) {
+        struct GpuProfilerScope *scope = &frame->scopes[i];
+        GpuScopeStats *scope_stats = &stats->scopes[stats->scope_count];
+
+        uint64_t *begin = &query_results[i * GPU_SCOPE_QUERY_COUNT * GPU_QUERY_RESULT_COUNT];
+        uint64_t *end = begin + GPU_QUERY_RESULT_COUNT;
+
+        if (!scope->is_ended || !begin[1] || !end[1]) {
+            debug(
+                LOG_TARGET,
+                LOG_GROUP(struct, "the \"%s\" scope results are not available, skipped"),
+                scope->name
+            );
+            continue;
+        }
+
+        uint64_t ticks = (end[0] - begin[0]) & profiler->tick_mask;
+
+        scope_stats->name = scope->name;
+        scope_stats->depth = scope->depth;
+        scope_stats->time_ns = AS(AS(ticks, double) * profiler->ns_per_tick, uint64_t);
+        scope_stats->avg_time_ns = push_gpu_scope_sample(
+            gpu_scope_history(profiler, scope->name),
+            scope_stats->time_ns
+        );
+
+        stats->scope_count += 1;
+    }
+
+    FN_FORCE_EXIT(result);
+}
+
+Result begin_gpu_profiler_frame(struct GpuProfiler *profiler, VkCommandBuffer cmd_buffer, uint32_t frame_idx) {
+    ASSERT_NOT_NULL(profiler);
+    ASSERT_NOT_NULL(cmd_buffer);
+    assert(frame_idx < profiler->frame_count && "frame index is out of range");
+
+    Result result = { 0 };
+    struct GpuProfilerFrame *frame = NULL;
+
+    if (!profiler->is_supported)
+        goto exit;
+
+    frame = &profiler->frames[frame_idx];
+
+    result = resolve_gpu_profiler_frame(profiler, frame);
+    EXPECT_SUCCESS(result);
+
+    vkCmdResetQueryPool(cmd_buffer, frame->query_pool, 0, GPU_PROFILER_QUERY_COUNT);
+
+    frame->scope_count = 0;
+    frame->frame_number = profiler->frame_number;
+    frame->is_submitted = false;
+
+    profiler->current_frame_idx = frame_idx;
+    profiler->depth = 0;
+
+    FN_FORCE_EXIT(result);
+}
+
+uint32_t begin_gpu_scope(struct GpuProfiler *profiler, VkCommandBuffer cmd_buffer, const char *name) {
+    ASSERT_NOT_NULL(profiler);
+    ASSERT_NOT_NULL(cmd_buffer);
+    ASSERT_NOT_NULL(name);
+
+    struct GpuProfilerFrame *frame = NULL;
+    uint32_t scope_idx = 0;
+
+    if (!profiler->is_supported)
+        return GPU_SCOPE_NULL;
+
+    frame = &profiler->frames[profiler->current_frame_idx];
+
+    if (frame->scope_count == MAX_GPU_SCOPES)
+        return GPU_SCOPE_NULL;
+
+    scope_idx = frame->scope_count++;
+
+    frame->scopes[scope_idx].name = name;
+    frame->scopes[scope_idx].depth = profiler->depth++;
+    frame->scopes[scope_idx].is_ended = false;
+
+    vkCmdWriteTimestamp(
+        cmd_buffer,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        frame->query_pool,
+        scope_idx * GPU_SCOPE_QUERY_COUNT
+    );
+
+    return scope_idx;
+}
+
+void end_gpu_scope(struct GpuProfiler *profiler, VkCommandBuffer cmd_buffer, uint32_t scope_idx) {
+    ASSERT_NOT_NULL(profiler);
+    ASSERT_NOT_NULL(cmd_buffer);
+
+    struct GpuProfilerFrame *frame = NULL;
+
+    if (scope_idx == GPU_SCOPE_NULL)
+        return;
+
+    frame = &profiler->frames[profiler->current_frame_idx];
+    assert(scope_idx < frame->scope_count && "GPU scope index is out of range");
+
+    frame->scopes[scope_idx].is_ended = true;
+    profiler->depth -= 1;
+
+    vkCmdWriteTimestamp(
+        cmd_buffer,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        frame->query_pool,
+        scope_idx * GPU_SCOPE_QUERY_COUNT + 1
+    );
+}
+
+void complete_gpu_profiler_frame(struct GpuProfiler *profiler) {
+    ASSERT_NOT_NULL(profiler);
+
+    if (profiler->is_supported)
+        profiler->frames[profiler->current_frame_idx].is_submitted = true;
+
+    profiler->frame_number += 1;
+}
+
+void drop_gpu_profiler(struct GpuProfiler *profiler) {
+    if (profiler == NULL)
+        goto exit;
+
+    for (uint32_t i = 0; profiler->frames != NULL && i < profiler->frame_count; ++i)
+        vkDestroyQueryPool(profiler->device, profiler->frames[i].query_pool, NULL);
+
+    free(profiler->frames);
+    free(profiler);
+
+exit:
+    debug(LOG_TARGET, "drop GPU profiler");
+}
@@ -0,0 +1,98 @@
+#ifndef ___APRIORI2_GRAPHICS_PROFILER_GPU_PROFILER_H___
+#define ___APRIORI2_GRAPHICS_PROFILER_GPU_PROFILER_H___
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+
+#include "ffi/core/result.h"
+#include "stats.h"
+
+// GPU time of the scopes recorded into the frame command buffer.
+//
+// Every frame slot has its own timestamp query pool:
+// the queries of a frame are read when its slot comes around again,
+// by then the slot fence is signaled and the results are available without waiting.
+//
+// The scopes are recorded by the rendering thread into the primary command buffer only
+// (the timestamps can't be written inside of a subpass with secondary command buffers).
+
+#define GPU_SCOPE_NULL UINT32_MAX
+
+#define GPU_SCOPE_BEGIN(profiler, cmd_buffer, name) \
+    uint32_t ___apriori_gpu_scope_##name = begin_gpu_scope((profiler), (cmd_buffer), #name)
+
+#define GPU_SCOPE_END(profiler, cmd_buffer, name) \
+    end_gpu_scope((profiler), (cmd_buffer), ___apriori_gpu_scope_##name)
+
+struct GpuProfilerScope {
+    const char *name;
+    uint32_t depth;
+    bool is_ended;
+};
+
+struct GpuProfilerFrame {
+    // Two queries per scope: the beginning and the end
+    VkQueryPool query_pool;
+
+    struct GpuProfilerScope scopes[MAX_GPU_SCOPES];
+    uint32_t scope_count;
+
+    uint64_t frame_number;
+
+    // The queries of an unsubmitted frame are never resolved
+    bool is_submitted;
+};
+
+struct GpuScopeHistory {
+    const char *name;
+    uint64_t samples[GPU_SCOPE_AVG_FRAMES];
+    uint32_t sample_count;
+    uint32_t next_sample_idx;
+    uint64_t sample_sum;
+};
+
+struct GpuProfiler {
+    VkDevice device;
+    bool is_supported;
+
+    double ns_per_tick;
+    uint64_t tick_mask;
+
+    struct GpuProfilerFrame *frames;
+    uint32_t frame_count;
+    uint32_t current_frame_idx;
+    uint32_t depth;
+    uint64_t frame_number;
+
+    struct GpuScopeHistory history[MAX_GPU_SCOPES];
+    uint32_t history_count;
+
+    GpuProfilerStats stats;
+};
+
+// `queue_family_idx` is the family the profiled command buffers are submitted to
+Result new_gpu_profiler(
+    VkPhysicalDevice phy_device,
+    VkDevice device,
+    const VkPhysicalDeviceProperties *props,
+    uint32_t queue_family_idx,
+    uint32_t frame_count
+);
+
+// Resolves the previous frame of the slot and resets its queries.
+// Must be recorded outside of a render pass, the slot fence must be signaled.
+Result begin_gpu_profiler_frame(struct GpuProfiler *profiler, VkCommandBuffer cmd_buffer, uint32_t frame_idx);
+
+// Returns `GPU_SCOPE_NULL` if the frame has no free scope (or the profiler is not supported).
+// `name` must be a static string.
+uint32_t begin_gpu_scope(struct GpuProfiler *profiler, VkCommandBuffer cmd_buffer, const char *name);
+
+// A scope left unended is skipped when the frame is resolved, the other scopes are kept
+void end_gpu_scope(struct GpuProfiler *profiler, VkCommandBuffer cmd_buffer, uint32_t scope_idx);
+
+// Must be called once the frame command buffer is submitted
+void complete_gpu_profiler_frame(struct GpuProfiler *profiler);
+
+void drop_gpu_profiler(struct GpuProfiler *profiler);
+
+#endif // ___APRIORI2_GRAPHICS_PROFILER_GPU_PROFILER_H___
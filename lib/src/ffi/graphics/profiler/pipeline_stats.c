@@ -0,0 +1,242 @@
+#include <stdint.h>
+
+#include "pipeline_stats.h"
+
+#include "ffi/core/log.h"
+#include "ffi/util/mod.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(PipelineStatsProfiler)
+
+bool is_pipeline_stats_supported(const VkPhysicalDeviceFeatures *features) {
+    ASSERT_NOT_NULL(features);
+
+    return features->pipelineStatisticsQuery && features->inheritedQueries;
+}
+
+Result new_pipeline_stats_profiler(VkDevice device, bool is_supported, uint32_t frame_count) {
+    ASSERT_NOT_NULL(device);
+
+    Result result = { 0 };
+    VkQueryPoolCreateInfo query_pool_ci = {
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+        .queryCount = MAX_PIPELINE_STATS_PASSES,
+        .pipelineStatistics = PIPELINE_STATS_FLAGS
+    };
+
+    info(LOG_TARGET, "creating new pipeline statistics profiler...");
+
+    struct PipelineStatsProfiler *profiler = ALLOC(result, struct PipelineStatsProfiler);
+
+    profiler->device = device;
+    profiler->is_supported = is_supported;
+    profiler->slot_count = frame_count;
+    profiler->active_pass_idx = PIPELINE_STATS_PASS_NULL;
+    profiler->stats.is_supported = is_supported;
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "pipeline statistics: %s"),
+        is_supported ? "supported" : "not supported"
+    );
+
+    if (!is_supported)
+        goto created;
+
+    profiler->slots = ALLOC_ARRAY(result, struct PipelineStatsSlot, frame_count);
+
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        result.error = VK_RESULT(vkCreateQueryPool(device, &query_pool_ci, NULL, &profiler->slots[i].query_pool));
+        EXPECT_SUCCESS(result);
+    }
+
+created:
+    result.object = profiler;
+    info(LOG_TARGET, "new pipeline statistics profiler created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_pipeline_stats_profiler(profiler);
+    });
+}
+
+void set_pipeline_stats_enabled(struct PipelineStatsProfiler *profiler, bool is_enabled) {
+    ASSERT_NOT_NULL(profiler);
+
+    profiler->is_enabled = is_enabled && profiler->is_supported;
+    profiler->stats.is_enabled = profiler->is_enabled;
+
+    debug(LOG_TARGET, LOG_GROUP(struct, "pipeline statistics %s"), profiler->is_enabled ? "enabled" : "disabled");
+}
+
+Result resolve_pipeline_stats_slot(struct PipelineStatsProfiler *profiler, struct PipelineStatsSlot *slot) {
+    Result result = { 0 };
+    uint64_t counters[MAX_PIPELINE_STATS_PASSES][PIPELINE_STATS_COUNTER_COUNT] = { 0 };
+    PipelineStatsFrame *stats = &profiler->stats;
+
+    if (!slot->is_recording || !slot->is_submitted || slot->pass_count == 0)
+        goto exit;
+
+    // The slot fence is signaled: no need to wait for the results
+    VkResult query_result = vkGetQueryPoolResults(
+        profiler->device,
+        slot->query_pool,
+        0,
+        slot->pass_count,
+        sizeof(counters),
+        counters,
+        sizeof(counters[0]),
+        VK_QUERY_RESULT_64_BIT
+    );
+
+    if (query_result == VK_NOT_READY) {
+        debug(LOG_TARGET, LOG_GROUP(struct, "frame results are not ready, skipped"));
+        goto exit;
+    }
+
+    result.error = VK_RESULT(query_result);
+    EXPECT_SUCCESS(result);
+
+    stats->frame_number = slot->frame_number;
+    stats->pass_count = 0;
+
+    for (uint32_t i = 0; i < slot->pass_count; ++i) {
+        struct PipelineStatsPass *pass = &slot->passes[i];
+        PassPipelineStats *pass_stats = &stats->passes[stats->pass_count];
+
+        if (!pass->is_ended)
+            continue;
+
+        pass_stats->name = pass->name;
+        pass_stats->input_vertex_count = counters[i][0];
+        pass_stats->input_primitive_count = counters[i][1];
+        pass_stats->vertex_invocation_count = counters[i][2];
+        pass_stats->clipping_invocation_count = counters[i][3];
+        pass_stats->clipping_primitive_count = counters[i][4];
+        pass_stats->fragment_invocation_count = counters[i][5];
+        pass_stats->pixel_count = pass->pixel_count;
+
+        stats->pass_count += 1;
+    }
+
+    FN_FORCE_EXIT(result);
+}
+
+Result begin_pipeline_stats_frame(
+    struct PipelineStatsProfiler *profiler,
+    VkCommandBuffer cmd_buffer,
+    uint32_t frame_idx
+) {
+    ASSERT_NOT_NULL(profiler);
+    ASSERT_NOT_NULL(cmd_buffer);
+    assert(frame_idx < profiler->slot_count && "frame index is out of range");
+
+    Result result = { 0 };
+    struct PipelineStatsSlot *slot = NULL;
+
+    profiler->current_slot_idx = frame_idx;
+    profiler->active_pass_idx = PIPELINE_STATS_PASS_NULL;
+
+    if (!profiler->is_supported)
+        goto exit;
+
+    slot = &profiler->slots[frame_idx];
+
+    result = resolve_pipeline_stats_slot(profiler, slot);
+    EXPECT_SUCCESS(result);
+
+    // The disabled counters cost nothing but this check
+    slot->is_recording = profiler->is_enabled;
+    slot->is_submitted = false;
+    slot->pass_count = 0;
+    slot->frame_number = profiler->frame_number;
+
+    if (slot->is_recording)
+        vkCmdResetQueryPool(cmd_buffer, slot->query_pool, 0, MAX_PIPELINE_STATS_PASSES);
+
+    FN_FORCE_EXIT(result);
+}
+
+uint32_t begin_pipeline_stats_pass(
+    struct PipelineStatsProfiler *profiler,
+    VkCommandBuffer cmd_buffer,
+    const char *name,
+    uint64_t pixel_count
+) {
+    ASSERT_NOT_NULL(profiler);
+    ASSERT_NOT_NULL(cmd_buffer);
+    ASSERT_NOT_NULL(name);
+
+    struct PipelineStatsSlot *slot = NULL;
+    uint32_t pass_idx = 0;
+
+    if (!profiler->is_supported)
+        return PIPELINE_STATS_PASS_NULL;
+
+    slot = &profiler->slots[profiler->current_slot_idx];
+
+    if (!slot->is_recording || slot->pass_count == MAX_PIPELINE_STATS_PASSES)
+        return PIPELINE_STATS_PASS_NULL;
+
+    assert(profiler->active_pass_idx == PIPELINE_STATS_PASS_NULL && "pipeline statistics passes can't nest");
+
+    pass_idx = slot->pass_count++;
+
+    slot->passes[pass_idx].name = name;
+    slot->passes[pass_idx].pixel_count = pixel_count;
+    slot->passes[pass_idx].is_ended = false;
+
+    profiler->active_pass_idx = pass_idx;
+
+    vkCmdBeginQuery(cmd_buffer, slot->query_pool, pass_idx, 0);
+
+    return pass_idx;
+}
+
+void end_pipeline_stats_pass(struct PipelineStatsProfiler *profiler, VkCommandBuffer cmd_buffer, uint32_t pass_idx) {
+    ASSERT_NOT_NULL(profiler);
+    ASSERT_NOT_NULL(cmd_buffer);
+
+    struct PipelineStatsSlot *slot = NULL;
+
+    if (pass_idx == PIPELINE_STATS_PASS_NULL)
+        return;
+
+    assert(pass_idx == profiler->active_pass_idx && "only the active pipeline statistics pass can be ended");
+
+    slot = &profiler->slots[profiler->current_slot_idx];
+    slot->passes[pass_idx].is_ended = true;
+    profiler->active_pass_idx = PIPELINE_STATS_PASS_NULL;
+
+    vkCmdEndQuery(cmd_buffer, slot->query_pool, pass_idx);
+}
+
+VkQueryPipelineStatisticFlags pipeline_stats_inheritance(struct PipelineStatsProfiler *profiler) {
+    ASSERT_NOT_NULL(profiler);
+
+    return profiler->active_pass_idx != PIPELINE_STATS_PASS_NULL ? PIPELINE_STATS_FLAGS : 0;
+}
+
+void complete_pipeline_stats_frame(struct PipelineStatsProfiler *profiler) {
+    ASSERT_NOT_NULL(profiler);
+
+    if (profiler->is_supported)
+        profiler->slots[profiler->current_slot_idx].is_submitted = true;
+
+    profiler->frame_number += 1;
+}
+
+void drop_pipeline_stats_profiler(struct PipelineStatsProfiler *profiler) {
+    if (profiler == NULL)
+        goto exit;
+
+    for (uint32_t i = 0; profiler->slots != NULL && i < profiler->slot_count; ++i)
+        vkDestroyQueryPool(profiler->device, profiler->slots[i].query_pool, NULL);
+
+    free(profiler->slots);
+    free(profiler);
+
+exit:
+    debug(LOG_TARGET, "drop pipeline statistics profiler");
+}
@@ -0,0 +1,102 @@
+#ifndef ___APRIORI2_GRAPHICS_PROFILER_PIPELINE_STATS_H___
+#define ___APRIORI2_GRAPHICS_PROFILER_PIPELINE_STATS_H___
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+
+#include "ffi/core/result.h"
+#include "stats.h"
+
+// Pipeline statistics counters (vertices, primitives, clipping, fragment invocations) per pass.
+//
+// The counters are disabled by default: nothing is recorded while they are disabled.
+// The query pools are per frame slot and resolved when the slot comes around again,
+// like the timestamps of `GpuProfiler`.
+//
+// The passes are recorded around the render pass instances (outside of them),
+// their secondary command buffers inherit the active query.
+// It needs both `pipelineStatisticsQuery` and `inheritedQueries` device features.
+
+#define PIPELINE_STATS_FLAGS \
+    (VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT \
+    | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT \
+    | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT \
+    | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT \
+    | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT \
+    | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT)
+
+#define PIPELINE_STATS_COUNTER_COUNT 6
+
+#define PIPELINE_STATS_PASS_NULL UINT32_MAX
+
+struct PipelineStatsPass {
+    const char *name;
+    uint64_t pixel_count;
+    bool is_ended;
+};
+
+struct PipelineStatsSlot {
+    VkQueryPool query_pool;
+
+    struct PipelineStatsPass passes[MAX_PIPELINE_STATS_PASSES];
+    uint32_t pass_count;
+
+    uint64_t frame_number;
+
+    // The counters were enabled when the frame was recorded
+    bool is_recording;
+    bool is_submitted;
+};
+
+struct PipelineStatsProfiler {
+    VkDevice device;
+    bool is_supported;
+    bool is_enabled;
+
+    struct PipelineStatsSlot *slots;
+    uint32_t slot_count;
+    uint32_t current_slot_idx;
+
+    // The pass with the active query (at most one)
+    uint32_t active_pass_idx;
+
+    uint64_t frame_number;
+
+    PipelineStatsFrame stats;
+};
+
+bool is_pipeline_stats_supported(const VkPhysicalDeviceFeatures *features);
+
+Result new_pipeline_stats_profiler(VkDevice device, bool is_supported, uint32_t frame_count);
+
+// Takes effect with the next frame
+void set_pipeline_stats_enabled(struct PipelineStatsProfiler *profiler, bool is_enabled);
+
+// Resolves the previous frame of the slot and resets its queries (if enabled).
+// Must be recorded outside of a render pass, the slot fence must be signaled.
+Result begin_pipeline_stats_frame(
+    struct PipelineStatsProfiler *profiler,
+    VkCommandBuffer cmd_buffer,
+    uint32_t frame_idx
+);
+
+// Returns `PIPELINE_STATS_PASS_NULL` if the counters are disabled or the frame has no free pass.
+// `name` must be a static string. The passes can't nest.
+uint32_t begin_pipeline_stats_pass(
+    struct PipelineStatsProfiler *profiler,
+    VkCommandBuffer cmd_buffer,
+    const char *name,
+    uint64_t pixel_count
+);
+
+void end_pipeline_stats_pass(struct PipelineStatsProfiler *profiler, VkCommandBuffer cmd_buffer, uint32_t pass_idx);
+
+// The counters the secondary command buffers recorded inside of the active pass inherit
+VkQueryPipelineStatisticFlags pipeline_stats_inheritance(struct PipelineStatsProfiler *profiler);
+
+// Must be called once the frame command buffer is submitted
+void complete_pipeline_stats_frame(struct PipelineStatsProfiler *profiler);
+
+void drop_pipeline_stats_profiler(struct PipelineStatsProfiler *profiler);
+
+#endif // ___APRIORI2_GRAPHICS_PROFILER_PIPELINE_STATS_H___
@@ -0,0 +1,66 @@
+#ifndef ___APRIORI2_GRAPHICS_PROFILER_STATS_H___
+#define ___APRIORI2_GRAPHICS_PROFILER_STATS_H___
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MAX_GPU_SCOPES 32
+
+// The rolling average window (in the frames the scope was recorded)
+#define GPU_SCOPE_AVG_FRAMES 64
+
+typedef struct GpuScopeStats {
+    // The static string passed to `begin_gpu_scope`
+    const char *name;
+
+    // Nesting level of the scope inside of the frame
+    uint32_t depth;
+
+    uint64_t time_ns;
+    uint64_t avg_time_ns;
+} GpuScopeStats;
+
+// The scopes of the last resolved frame:
+// the results are read once the frame slot comes around again (no stall)
+typedef struct GpuProfilerStats {
+    // False if the graphics queue has no timestamps
+    bool is_supported;
+
+    uint64_t frame_number;
+
+    // In the recording order
+    uint32_t scope_count;
+    GpuScopeStats scopes[MAX_GPU_SCOPES];
+} GpuProfilerStats;
+
+#define MAX_PIPELINE_STATS_PASSES 8
+
+// The counters are in the order of the `VK_QUERY_PIPELINE_STATISTIC_*` bits
+typedef struct PassPipelineStats {
+    // The static string passed to `begin_pipeline_stats_pass`
+    const char *name;
+
+    uint64_t input_vertex_count;
+    uint64_t input_primitive_count;
+    uint64_t vertex_invocation_count;
+    uint64_t clipping_invocation_count;
+    uint64_t clipping_primitive_count;
+    uint64_t fragment_invocation_count;
+
+    // The render area of the pass: the fragment invocations per pixel is the overdraw
+    uint64_t pixel_count;
+} PassPipelineStats;
+
+// The passes of the last resolved frame (recorded while the counters were enabled)
+typedef struct PipelineStatsFrame {
+    // False if the device can't count the secondary command buffers work
+    bool is_supported;
+    bool is_enabled;
+
+    uint64_t frame_number;
+
+    uint32_t pass_count;
+    PassPipelineStats passes[MAX_PIPELINE_STATS_PASSES];
+} PipelineStatsFrame;
+
+#endif // ___APRIORI2_GRAPHICS_PROFILER_STATS_H___
@@ -20,11 +20,11 @@ Result new_command_buffer(VkDevice device, VkCommandPool cmd_pool, uint32_t buff
     allocate_info.commandPool = cmd_pool;
     allocate_info.commandBufferCount = buffer_count;
 
-    result.error = vkAllocateCommandBuffers(
+    result.error = VK_RESULT(vkAllocateCommandBuffers(
         device,
         &allocate_info,
         buffers
-    );
+    ));
     result.object = buffers;
 
     FN_EXIT(result);
@@ -50,6 +50,7 @@ Result new_renderer_cmd_buffers(
     struct RendererCmdBuffers *cmd_buffers = ALLOC(result, struct RendererCmdBuffers);
 
     cmd_buffers->device = device;
+    cmd_buffers->cmd_pools = cmd_pools;
     cmd_buffers->buffers_count = buffers_count;
 
     if (is_same_queue_families(queues)) {
@@ -89,6 +90,32 @@ Result new_renderer_cmd_buffers(
         );
     }
 
+    result = new_command_buffer(
+        device,
+        cmd_pools->transfer,
+        buffers_count
+    );
+
+    RESULT_UNWRAP(
+        cmd_buffers->transfer,
+        result
+    );
+
+    if (queues->transfer_idx == queues->graphics_idx) {
+        cmd_buffers->staging_fallback = cmd_buffers->transfer;
+    } else {
+        result = new_command_buffer(
+            device,
+            cmd_pools->graphics,
+            buffers_count
+        );
+
+        RESULT_UNWRAP(
+            cmd_buffers->staging_fallback,
+            result
+        );
+    }
+
     result.object = cmd_buffers;
     info(LOG_TARGET, "new command buffers created successfully");
 
@@ -127,6 +154,31 @@ void drop_renderer_cmd_buffers(struct RendererCmdBuffers *cmd_buffers) {
 
             free(cmd_buffers->present);
         }
+
+        if (cmd_buffers->transfer) {
+            vkFreeCommandBuffers(
+                cmd_buffers->device,
+                cmd_buffers->cmd_pools->transfer,
+                cmd_buffers->buffers_count,
+                cmd_buffers->transfer
+            );
+
+            free(cmd_buffers->transfer);
+        }
+
+        if (
+            cmd_buffers->staging_fallback
+            && cmd_buffers->staging_fallback != cmd_buffers->transfer
+        ) {
+            vkFreeCommandBuffers(
+                cmd_buffers->device,
+                cmd_buffers->cmd_pools->graphics,
+                cmd_buffers->buffers_count,
+                cmd_buffers->staging_fallback
+            );
+
+            free(cmd_buffers->staging_fallback);
+        }
     }
 
     free(cmd_buffers);
@@ -11,6 +11,14 @@ struct RendererCmdBuffers {
     struct RendererCmdPools *cmd_pools;
     VkCommandBuffer *graphics;
     VkCommandBuffer *present;
+
+    // Staging uploads (allocated from the transfer pool even if it is the graphics one)
+    VkCommandBuffer *transfer;
+
+    // Staging uploads the transfer queue can't order after the graphics reads
+    // (allocated from the graphics pool, the same as `transfer` if the families match)
+    VkCommandBuffer *staging_fallback;
+
     uint32_t buffers_count;
 };
 
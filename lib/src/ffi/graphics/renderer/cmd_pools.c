@@ -11,29 +11,54 @@ Result new_command_pool(VkDevice device, uint32_t queue_family_index) {
 
     Result result = { 0 };
 
+    // Frame command buffers are re-recorded every time their frame slot comes around
     VkCommandPoolCreateInfo cmd_pool_ci = {
-        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT
     };
     VkCommandPool cmd_pool = VK_NULL_HANDLE;
 
     cmd_pool_ci.queueFamilyIndex = queue_family_index;
 
-    result.error = vkCreateCommandPool(
+    result.error = VK_RESULT(vkCreateCommandPool(
         device,
         &cmd_pool_ci,
         NULL,
         &cmd_pool
-    );
+    ));
     result.object = cmd_pool;
 
     return result;
 }
 
+// Returns the already created pool of the family or creates a new one
+Result family_cmd_pool(
+    VkDevice device,
+    uint32_t family_idx,
+    const uint32_t *pool_families,
+    const VkCommandPool *pools,
+    uint32_t pools_count
+) {
+    for (uint32_t i = 0; i < pools_count; ++i) {
+        if (pool_families[i] == family_idx) {
+            Result result = { 0 };
+            result.object = pools[i];
+
+            return result;
+        }
+    }
+
+    return new_command_pool(device, family_idx);
+}
+
 Result new_renderer_cmd_pools(VkDevice device, struct RendererQueueFamilies *queues) {
     ASSERT_NOT_NULL(device);
     ASSERT_NOT_NULL(queues);
 
     Result result = { 0 };
+    uint32_t pool_families[MAX_RENDERER_QUEUE_FAMILIES] = { 0 };
+    VkCommandPool pools[MAX_RENDERER_QUEUE_FAMILIES] = { 0 };
+    uint32_t pools_count = 0;
 
     info(LOG_TARGET, "creating new renderer command pools...");
 
@@ -41,29 +66,26 @@ Result new_renderer_cmd_pools(VkDevice device, struct RendererQueueFamilies *que
 
     cmd_pools->device = device;
 
-    if (is_same_queue_families(queues)) {
-        uint32_t family_idx = queues->graphics_idx;
-
-        result = new_command_pool(device, family_idx);
-        RESULT_UNWRAP(
-            cmd_pools->graphics,
-            result
-        );
-
-        cmd_pools->present = cmd_pools->graphics;
-    } else {
-        result = new_command_pool(device, queues->graphics_idx);
-        RESULT_UNWRAP(
-            cmd_pools->graphics,
-            result
-        );
-
-        result = new_command_pool(device, queues->present_idx);
-        RESULT_UNWRAP(
-            cmd_pools->present,
-            result
-        );
-    }
+#define FAMILY_CMD_POOL(role) do { \
+    result = family_cmd_pool( \
+        device, \
+        queues->role##_idx, \
+        pool_families, \
+        pools, \
+        pools_count \
+    ); \
+    RESULT_UNWRAP(cmd_pools->role, result); \
+    pool_families[pools_count] = queues->role##_idx; \
+    pools[pools_count] = cmd_pools->role; \
+    pools_count += 1; \
+} while (0)
+
+    FAMILY_CMD_POOL(graphics);
+    FAMILY_CMD_POOL(present);
+    FAMILY_CMD_POOL(transfer);
+    FAMILY_CMD_POOL(compute);
+
+#undef FAMILY_CMD_POOL
 
     result.object = cmd_pools;
     info(LOG_TARGET, "new renderer command pools created successfully");
@@ -79,12 +101,27 @@ void drop_renderer_cmd_pools(struct RendererCmdPools *cmd_pools) {
     if (cmd_pools == NULL)
         goto exit;
 
-    if (cmd_pools->device) {
-        if (cmd_pools->graphics)
-            vkDestroyCommandPool(cmd_pools->device, cmd_pools->graphics, NULL);
+    VkCommandPool pools[] = {
+        cmd_pools->graphics,
+        cmd_pools->present,
+        cmd_pools->transfer,
+        cmd_pools->compute
+    };
 
-        if (cmd_pools->present && cmd_pools->graphics != cmd_pools->present)
-            vkDestroyCommandPool(cmd_pools->device, cmd_pools->present, NULL);
+    if (cmd_pools->device) {
+        for (uint32_t i = 0, j = 0; i < STATIC_ARRAY_SIZE(pools); ++i) {
+            if (pools[i] == VK_NULL_HANDLE)
+                continue;
+
+            // The shared pool is destroyed once
+            for (j = 0; j < i; ++j) {
+                if (pools[j] == pools[i])
+                    break;
+            }
+
+            if (j == i)
+                vkDestroyCommandPool(cmd_pools->device, pools[i], NULL);
+        }
     }
 
     free(cmd_pools);
@@ -6,10 +6,13 @@
 
 #include "ffi/core/result.h"
 
+// Roles sharing the queue family share the command pool as well
 struct RendererCmdPools {
     VkDevice device;
     VkCommandPool graphics;
     VkCommandPool present;
+    VkCommandPool transfer;
+    VkCommandPool compute;
 };
 
 Result new_renderer_cmd_pools(VkDevice device, struct RendererQueueFamilies *queues);
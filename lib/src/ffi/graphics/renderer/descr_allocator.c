@@ -0,0 +1,192 @@
+#include "descr_allocator.h"
+
+#include "ffi/core/log.h"
+#include "ffi/util/mod.h"
+
+#define LOG_TARGET LOG_STRUCT_TARGET(DescrAllocator)
+
+Result new_descr_allocator(VkDevice device, uint32_t frame_count) {
+    ASSERT_NOT_NULL(device);
+    assert(frame_count > 0 && "descriptor allocator needs at least one frame slot");
+
+    Result result = { 0 };
+
+    info(LOG_TARGET, "creating new descriptor allocator...");
+
+    struct DescrAllocator *allocator = ALLOC(result, struct DescrAllocator);
+
+    allocator->device = device;
+    allocator->frame_count = frame_count;
+    allocator->frames = ALLOC_ARRAY(result, struct DescrFramePools, frame_count);
+
+    result.object = allocator;
+    info(LOG_TARGET, "new descriptor allocator created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_descr_allocator(allocator);
+    });
+}
+
+void register_descr_pool_sizes(struct DescrAllocator *allocator, DynArray pool_sizes, uint32_t max_sets) {
+    ASSERT_NOT_NULL(allocator);
+    ASSERT_NOT_NULL(pool_sizes);
+    assert(allocator->stats.pool_count == 0 && "pool sizes must be registered before the first allocation");
+
+    VkDescriptorPoolSize *sizes = pool_sizes->data;
+
+    for (uint32_t i = 0; i < pool_sizes->count; ++i) {
+        uint32_t size_idx = 0;
+
+        while (size_idx < allocator->pool_size_count && allocator->pool_sizes[size_idx].type != sizes[i].type)
+            ++size_idx;
+
+        if (size_idx == allocator->pool_size_count) {
+            assert(size_idx < MAX_DESCR_POOL_SIZES && "too many descriptor types");
+
+            allocator->pool_sizes[size_idx].type = sizes[i].type;
+            allocator->pool_sizes[size_idx].descriptorCount = 0;
+            allocator->pool_size_count += 1;
+        }
+
+        allocator->pool_sizes[size_idx].descriptorCount += sizes[i].descriptorCount;
+    }
+
+    allocator->max_sets += max_sets;
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "registered %d pool sizes (max sets: %d, descriptor types: %d)"),
+        pool_sizes->count, allocator->max_sets, allocator->pool_size_count
+    );
+}
+
+Result grow_descr_frame_pools(struct DescrAllocator *allocator, struct DescrFramePools *frame) {
+    Result result = { 0 };
+    VkDescriptorPoolCreateInfo pool_ci = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .maxSets = allocator->max_sets,
+        .poolSizeCount = allocator->pool_size_count
+    };
+    pool_ci.pPoolSizes = allocator->pool_sizes;
+
+    assert(allocator->max_sets > 0 && "no pool sizes are registered");
+
+    if (frame->pool_count == MAX_DESCR_FRAME_POOLS) {
+        result.error = DESCR_ALLOCATOR_FULL;
+        EXPECT_SUCCESS(result);
+    }
+
+    result.error = VK_RESULT(vkCreateDescriptorPool(allocator->device, &pool_ci, NULL, &frame->pools[frame->pool_count]));
+    EXPECT_SUCCESS(result);
+
+    frame->pool_count += 1;
+    allocator->stats.pool_count += 1;
+
+    // The first pool of a slot is not a growth
+    if (frame->pool_count > 1)
+        allocator->stats.grow_count += 1;
+
+    debug(
+        LOG_TARGET,
+        LOG_GROUP(struct, "frame slot #%d pool count: %d"),
+        allocator->current_frame_idx, frame->pool_count
+    );
+
+    FN_FORCE_EXIT(result);
+}
+
+Result begin_descr_allocator_frame(struct DescrAllocator *allocator, uint32_t frame_idx) {
+    ASSERT_NOT_NULL(allocator);
+    assert(frame_idx < allocator->frame_count && "frame index is out of range");
+
+    Result result = { 0 };
+    struct DescrFramePools *frame = &allocator->frames[frame_idx];
+
+    for (uint32_t i = 0; i < frame->pool_count && i <= frame->current_pool_idx; ++i) {
+        result.error = VK_RESULT(vkResetDescriptorPool(allocator->device, frame->pools[i], 0));
+        EXPECT_SUCCESS(result);
+    }
+
+    frame->current_pool_idx = 0;
+    frame->set_count_in_pool = 0;
+    frame->set_count = 0;
+    allocator->current_frame_idx = frame_idx;
+
+    FN_FORCE_EXIT(result);
+}
+
+Result descr_allocator_alloc(
+    struct DescrAllocator *allocator,
+    VkDescriptorSetLayout layout,
+    VkDescriptorSet *descr_set
+) {
+    ASSERT_NOT_NULL(allocator);
+    ASSERT_NOT_NULL(layout);
+    ASSERT_NOT_NULL(descr_set);
+
+    Result result = { 0 };
+    struct DescrFramePools *frame = &allocator->frames[allocator->current_frame_idx];
+    VkDescriptorSetAllocateInfo set_ai = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorSetCount = 1
+    };
+    set_ai.pSetLayouts = &layout;
+
+    if (frame->pool_count == 0) {
+        result = grow_descr_frame_pools(allocator, frame);
+        EXPECT_SUCCESS(result);
+    }
+
+    for (;;) {
+        set_ai.descriptorPool = frame->pools[frame->current_pool_idx];
+
+        VkResult alloc_result = vkAllocateDescriptorSets(allocator->device, &set_ai, descr_set);
+
+        // An exhausted pool can report either of them (or the out of memory without maintenance1)
+        bool is_exhausted = alloc_result == VK_ERROR_OUT_OF_POOL_MEMORY
+            || alloc_result == VK_ERROR_FRAGMENTED_POOL
+            || alloc_result == VK_ERROR_OUT_OF_DEVICE_MEMORY
+            || alloc_result == VK_ERROR_OUT_OF_HOST_MEMORY;
+
+        // A fresh pool can't be exhausted, the error is real
+        if (!is_exhausted || frame->set_count_in_pool == 0) {
+            result.error = VK_RESULT(alloc_result);
+            EXPECT_SUCCESS(result);
+            break;
+        }
+
+        frame->current_pool_idx += 1;
+        frame->set_count_in_pool = 0;
+
+        if (frame->current_pool_idx == frame->pool_count) {
+            result = grow_descr_frame_pools(allocator, frame);
+            EXPECT_SUCCESS(result);
+        }
+    }
+
+    frame->set_count += 1;
+    frame->set_count_in_pool += 1;
+    allocator->stats.frame_set_count = frame->set_count;
+
+    FN_FORCE_EXIT(result);
+}
+
+void drop_descr_allocator(struct DescrAllocator *allocator) {
+    if (allocator == NULL)
+        goto exit;
+
+    for (uint32_t i = 0; i < allocator->frame_count && allocator->frames != NULL; ++i) {
+        struct DescrFramePools *frame = &allocator->frames[i];
+
+        for (uint32_t j = 0; j < frame->pool_count; ++j)
+            vkDestroyDescriptorPool(allocator->device, frame->pools[j], NULL);
+    }
+
+    free(allocator->frames);
+    free(allocator);
+
+exit:
+    debug(LOG_TARGET, "drop descriptor allocator");
+}
@@ -0,0 +1,65 @@
+#ifndef ___APRIORI2_GRAPHICS_RENDERER_DESCR_ALLOCATOR_H___
+#define ___APRIORI2_GRAPHICS_RENDERER_DESCR_ALLOCATOR_H___
+
+#include <vulkan/vulkan.h>
+
+#include "ffi/core/result.h"
+#include "ffi/util/dyn_array.h"
+#include "stats.h"
+
+// Linear allocator of the transient descriptor sets (valid for a single frame).
+//
+// Every frame slot has its own pools: they are reset wholesale
+// once the slot fence is signaled, the sets are never freed one by one.
+// A slot grows by another pool when its pools are exhausted,
+// the grown pools are reused by the next frames of the slot.
+//
+// The pool sizes are merged from the requirements the pipelines register.
+
+#define MAX_DESCR_POOL_SIZES 16
+#define MAX_DESCR_FRAME_POOLS 16
+
+struct DescrFramePools {
+    VkDescriptorPool pools[MAX_DESCR_FRAME_POOLS];
+    uint32_t pool_count;
+
+    // The pool the sets are allocated from, the previous ones are exhausted
+    uint32_t current_pool_idx;
+    uint32_t set_count_in_pool;
+    uint32_t set_count;
+};
+
+struct DescrAllocator {
+    VkDevice device;
+
+    // Per pool, merged by the descriptor type
+    VkDescriptorPoolSize pool_sizes[MAX_DESCR_POOL_SIZES];
+    uint32_t pool_size_count;
+    uint32_t max_sets;
+
+    struct DescrFramePools *frames;
+    uint32_t frame_count;
+    uint32_t current_frame_idx;
+
+    DescrAllocatorStats stats;
+};
+
+Result new_descr_allocator(VkDevice device, uint32_t frame_count);
+
+// `pool_sizes` is a DynArray of `VkDescriptorPoolSize` needed by `max_sets` sets a frame.
+// Must be called before the first allocation.
+void register_descr_pool_sizes(struct DescrAllocator *allocator, DynArray pool_sizes, uint32_t max_sets);
+
+// Resets the pools of the frame slot, the GPU must have finished the previous frame of the slot
+Result begin_descr_allocator_frame(struct DescrAllocator *allocator, uint32_t frame_idx);
+
+// The set is valid until the current frame slot comes around again
+Result descr_allocator_alloc(
+    struct DescrAllocator *allocator,
+    VkDescriptorSetLayout layout,
+    VkDescriptorSet *descr_set
+);
+
+void drop_descr_allocator(struct DescrAllocator *allocator);
+
+#endif // ___APRIORI2_GRAPHICS_RENDERER_DESCR_ALLOCATOR_H___
@@ -0,0 +1,79 @@
+#include "framebuffers.h"
+
+#include "ffi/util/mod.h"
+#include "ffi/core/log.h"
+
+#define LOG_TARGET LOG_SUB_TARGET( \
+    LOG_STRUCT_TARGET(Renderer), LOG_STRUCT_TARGET(RendererFramebuffers) \
+)
+
+Result new_renderer_framebuffers(
+    VkDevice device,
+    VkRenderPass render_pass,
+    struct Swapchain *swapchain
+) {
+    ASSERT_NOT_NULL(device);
+    ASSERT_NOT_NULL(render_pass);
+    ASSERT_NOT_NULL(swapchain);
+
+    Result result = { 0 };
+    VkFramebufferCreateInfo framebuffer_ci = {
+        .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+        .attachmentCount = 1,
+        .layers = 1
+    };
+
+    info(LOG_TARGET, "creating new renderer framebuffers...");
+
+    struct RendererFramebuffers *framebuffers = ALLOC(result, struct RendererFramebuffers);
+
+    framebuffers->device = device;
+    framebuffers->framebuffers = ALLOC_ARRAY(result, VkFramebuffer, swapchain->image_count);
+    framebuffers->count = swapchain->image_count;
+
+    framebuffer_ci.renderPass = render_pass;
+    framebuffer_ci.width = swapchain->image_extent.width;
+    framebuffer_ci.height = swapchain->image_extent.height;
+
+    for (uint32_t i = 0; i < framebuffers->count; ++i) {
+        framebuffer_ci.pAttachments = &swapchain->views[i];
+
+        result.error = VK_RESULT(vkCreateFramebuffer(
+            device,
+            &framebuffer_ci,
+            NULL,
+            &framebuffers->framebuffers[i]
+        ));
+        EXPECT_SUCCESS(result);
+    }
+
+    result.object = framebuffers;
+    info(LOG_TARGET, "new renderer framebuffers created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_renderer_framebuffers(framebuffers);
+    });
+}
+
+void drop_renderer_framebuffers(struct RendererFramebuffers *framebuffers) {
+    if (framebuffers == NULL)
+        goto exit;
+
+    if (framebuffers->framebuffers != NULL) {
+        for (uint32_t i = 0; i < framebuffers->count; ++i) {
+            vkDestroyFramebuffer(
+                framebuffers->device,
+                framebuffers->framebuffers[i],
+                NULL
+            );
+        }
+    }
+
+    free(framebuffers->framebuffers);
+    free(framebuffers);
+
+exit:
+    debug(LOG_TARGET, "drop renderer framebuffers");
+}
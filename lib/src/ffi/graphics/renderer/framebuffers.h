@@ -0,0 +1,24 @@
+#ifndef ___APRIORI2_GRAPHICS_RENDERER_FRAMEBUFFERS_H___
+#define ___APRIORI2_GRAPHICS_RENDERER_FRAMEBUFFERS_H___
+
+#include <vulkan/vulkan.h>
+
+#include "ffi/core/result.h"
+#include "ffi/graphics/swapchain.h"
+
+// One framebuffer per swapchain image
+struct RendererFramebuffers {
+    VkDevice device;
+    VkFramebuffer *framebuffers;
+    uint32_t count;
+};
+
+Result new_renderer_framebuffers(
+    VkDevice device,
+    VkRenderPass render_pass,
+    struct Swapchain *swapchain
+);
+
+void drop_renderer_framebuffers(struct RendererFramebuffers *framebuffers);
+
+#endif // ___APRIORI2_GRAPHICS_RENDERER_FRAMEBUFFERS_H___
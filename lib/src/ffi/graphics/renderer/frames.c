@@ -0,0 +1,305 @@
+#include <string.h>
+
+#include "frames.h"
+
+#include "ffi/util/mod.h"
+#include "ffi/core/log.h"
+#include "ffi/os/time.h"
+
+#define LOG_TARGET LOG_SUB_TARGET( \
+    LOG_STRUCT_TARGET(Renderer), LOG_STRUCT_TARGET(RendererFrames) \
+)
+
+Result new_renderer_frames(
+    VkDevice device,
+    VkCommandBuffer *cmd_buffers,
+    uint32_t frame_count,
+    uint32_t swapchain_image_count
+) {
+    ASSERT_NOT_NULL(device);
+    ASSERT_NOT_NULL(cmd_buffers);
+    assert(
+        frame_count > 0 && frame_count <= MAX_FRAMES_IN_FLIGHT
+        && "frames in flight count must be in [1, MAX_FRAMES_IN_FLIGHT]"
+    );
+
+    Result result = { 0 };
+    VkSemaphoreCreateInfo semaphore_ci = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
+    };
+
+    // The first wait on each frame slot must not block
+    VkFenceCreateInfo fence_ci = {
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+        .flags = VK_FENCE_CREATE_SIGNALED_BIT
+    };
+
+    info(LOG_TARGET, "creating new renderer frames...");
+
+    struct RendererFrames *frames = ALLOC(result, struct RendererFrames);
+
+    frames->device = device;
+    frames->stats.frames_in_flight = frame_count;
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "frames in flight: %d"), frame_count);
+
+    frames->frames = ALLOC_ARRAY(result, struct RendererFrame, frame_count);
+    frames->count = frame_count;
+
+    frames->image_fences = ALLOC_ARRAY(result, VkFence, swapchain_image_count);
+    frames->image_count = swapchain_image_count;
+
+    for (uint32_t i = 0; i < frame_count; ++i) {
+        struct RendererFrame *frame = &frames->frames[i];
+
+        frame->cmd_buffer = cmd_buffers[i];
+
+        result.error = VK_RESULT(vkCreateSemaphore(device, &semaphore_ci, NULL, &frame->image_available));
+        EXPECT_SUCCESS(result);
+
+        result.error = VK_RESULT(vkCreateSemaphore(device, &semaphore_ci, NULL, &frame->render_finished));
+        EXPECT_SUCCESS(result);
+
+        result.error = VK_RESULT(vkCreateFence(device, &fence_ci, NULL, &frame->in_flight));
+        EXPECT_SUCCESS(result);
+    }
+
+    result.object = frames;
+    info(LOG_TARGET, "new renderer frames created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_renderer_frames(frames);
+    });
+}
+
+// Drops the objects unused by the submissions up to `completed_serial` in the order of deferral
+void run_deferred_drops(struct RendererFrames *frames, uint64_t completed_serial) {
+    ASSERT_NOT_NULL(frames);
+
+    uint32_t kept_count = 0;
+
+    for (uint32_t i = 0; i < frames->deferred_drop_count; ++i) {
+        struct DeferredDrop drop = frames->deferred_drops[i];
+
+        if (drop.submit_serial <= completed_serial)
+            drop.drop_fn(drop.object);
+        else
+            frames->deferred_drops[kept_count++] = drop;
+    }
+
+    frames->deferred_drop_count = kept_count;
+}
+
+struct RendererFrame *current_renderer_frame(struct RendererFrames *frames) {
+    ASSERT_NOT_NULL(frames);
+
+    return &frames->frames[frames->current_idx];
+}
+
+Result wait_renderer_frame(struct RendererFrames *frames) {
+    ASSERT_NOT_NULL(frames);
+
+    Result result = { 0 };
+    struct RendererFrame *frame = current_renderer_frame(frames);
+    uint64_t frame_begin_ns = now_ns();
+    uint64_t wait_end_ns = 0;
+
+    if (frames->last_frame_begin_ns != 0) {
+        frames->stats.frame_time_ns = frame_begin_ns - frames->last_frame_begin_ns;
+        frames->stats.total_frame_time_ns += frames->stats.frame_time_ns;
+    }
+    frames->last_frame_begin_ns = frame_begin_ns;
+
+    result.error = VK_RESULT(vkWaitForFences(
+        frames->device,
+        1,
+        &frame->in_flight,
+        VK_TRUE,
+        UINT64_MAX
+    ));
+    EXPECT_SUCCESS(result);
+
+    wait_end_ns = now_ns();
+    frames->stats.fence_wait_time_ns = wait_end_ns - frame_begin_ns;
+    frames->stats.total_fence_wait_time_ns += frames->stats.fence_wait_time_ns;
+
+    // The slot may have been skipped since its last submission (e.g. the window was minimized)
+    if (frame->submit_serial > frames->completed_serial)
+        frames->completed_serial = frame->submit_serial;
+
+    run_deferred_drops(frames, frames->completed_serial);
+
+    FN_FORCE_EXIT(result);
+}
+
+Result reserve_renderer_frame_drops(struct RendererFrames *frames, uint32_t count) {
+    ASSERT_NOT_NULL(frames);
+    assert(count <= MAX_DEFERRED_DROPS && "too many deferred drops");
+
+    Result result = { 0 };
+    struct RendererFrame *latest_frame = NULL;
+
+    if (frames->deferred_drop_count + count <= MAX_DEFERRED_DROPS)
+        goto exit;
+
+    for (uint32_t i = 0; i < frames->count; ++i) {
+        struct RendererFrame *frame = &frames->frames[i];
+
+        if (latest_frame == NULL || frame->submit_serial > latest_frame->submit_serial)
+            latest_frame = frame;
+    }
+
+    warn(
+        LOG_TARGET,
+        LOG_GROUP(struct, "deferred drops are full, waiting for the submission #%d"),
+        AS(latest_frame->submit_serial, uint32_t)
+    );
+
+    // Every drop is deferred until a submission no later than the latest one
+    result.error = VK_RESULT(vkWaitForFences(
+        frames->device,
+        1,
+        &latest_frame->in_flight,
+        VK_TRUE,
+        UINT64_MAX
+    ));
+    EXPECT_SUCCESS(result);
+
+    frames->completed_serial = frames->submit_serial;
+    run_deferred_drops(frames, frames->completed_serial);
+
+    FN_FORCE_EXIT(result);
+}
+
+void defer_renderer_frame_drop(
+    struct RendererFrames *frames,
+    DeferredDropFn drop_fn,
+    Handle object
+) {
+    ASSERT_NOT_NULL(frames);
+    ASSERT_NOT_NULL(drop_fn);
+
+    assert(
+        frames->deferred_drop_count < MAX_DEFERRED_DROPS
+        && "too many deferred drops"
+    );
+
+    struct DeferredDrop *drop = &frames->deferred_drops[frames->deferred_drop_count];
+    drop->drop_fn = drop_fn;
+    drop->object = object;
+    drop->submit_serial = frames->submit_serial;
+
+    frames->deferred_drop_count += 1;
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "drop deferred until the submission #%d is complete (deferred drops: %d)"),
+        AS(frames->submit_serial, uint32_t), frames->deferred_drop_count
+    );
+}
+
+Result reset_renderer_frame_images(struct RendererFrames *frames, uint32_t swapchain_image_count) {
+    ASSERT_NOT_NULL(frames);
+
+    Result result = { 0 };
+
+    if (swapchain_image_count != frames->image_count) {
+        VkFence *image_fences = ALLOC_ARRAY(result, VkFence, swapchain_image_count);
+
+        free(frames->image_fences);
+        frames->image_fences = image_fences;
+        frames->image_count = swapchain_image_count;
+    } else {
+        memset(frames->image_fences, 0, sizeof(VkFence) * frames->image_count);
+    }
+
+    FN_FORCE_EXIT(result);
+}
+
+Result bind_renderer_frame_image(struct RendererFrames *frames, uint32_t image_idx) {
+    ASSERT_NOT_NULL(frames);
+    assert(image_idx < frames->image_count && "image index is out of range");
+
+    Result result = { 0 };
+    struct RendererFrame *frame = current_renderer_frame(frames);
+    VkFence image_fence = frames->image_fences[image_idx];
+
+    if (image_fence != VK_NULL_HANDLE && image_fence != frame->in_flight) {
+        result.error = VK_RESULT(vkWaitForFences(
+            frames->device,
+            1,
+            &image_fence,
+            VK_TRUE,
+            UINT64_MAX
+        ));
+        EXPECT_SUCCESS(result);
+    }
+
+    frames->image_fences[image_idx] = frame->in_flight;
+
+    FN_FORCE_EXIT(result);
+}
+
+Result submit_renderer_frame(struct RendererFrames *frames, VkQueue queue, const VkSubmitInfo *submit_info) {
+    ASSERT_NOT_NULL(frames);
+    ASSERT_NOT_NULL(queue);
+    ASSERT_NOT_NULL(submit_info);
+
+    Result result = { 0 };
+    struct RendererFrame *frame = current_renderer_frame(frames);
+
+    result.error = VK_RESULT(vkResetFences(frames->device, 1, &frame->in_flight));
+    EXPECT_SUCCESS(result);
+
+    result.error = VK_RESULT(vkQueueSubmit(queue, 1, submit_info, frame->in_flight));
+    if (result.error != SUCCESS) {
+        // An empty submission signals the fence, so the next wait on the slot doesn't hang
+        if (vkQueueSubmit(queue, 0, NULL, frame->in_flight) != VK_SUCCESS)
+            error(LOG_TARGET, "unable to signal the fence of the failed frame submission");
+
+        goto exit;
+    }
+
+    frames->submit_serial += 1;
+    frame->submit_serial = frames->submit_serial;
+
+    FN_FORCE_EXIT(result);
+}
+
+void advance_renderer_frame(struct RendererFrames *frames) {
+    ASSERT_NOT_NULL(frames);
+
+    // The fence wait time is accounted separately
+    frames->stats.cpu_time_ns = now_ns() - frames->last_frame_begin_ns - frames->stats.fence_wait_time_ns;
+    frames->stats.total_cpu_time_ns += frames->stats.cpu_time_ns;
+    frames->stats.frame_count += 1;
+
+    frames->current_idx = (frames->current_idx + 1) % frames->count;
+}
+
+void drop_renderer_frames(struct RendererFrames *frames) {
+    if (frames == NULL)
+        goto exit;
+
+    // The device is idle: every submission is complete
+    run_deferred_drops(frames, UINT64_MAX);
+
+    if (frames->frames != NULL) {
+        for (uint32_t i = 0; i < frames->count; ++i) {
+            struct RendererFrame *frame = &frames->frames[i];
+
+            vkDestroySemaphore(frames->device, frame->image_available, NULL);
+            vkDestroySemaphore(frames->device, frame->render_finished, NULL);
+            vkDestroyFence(frames->device, frame->in_flight, NULL);
+        }
+    }
+
+    free(frames->image_fences);
+    free(frames->frames);
+    free(frames);
+
+exit:
+    debug(LOG_TARGET, "drop renderer frames");
+}
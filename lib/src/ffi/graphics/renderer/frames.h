@@ -0,0 +1,106 @@
+#ifndef ___APRIORI2_GRAPHICS_RENDERER_FRAMES_H___
+#define ___APRIORI2_GRAPHICS_RENDERER_FRAMES_H___
+
+#include <vulkan/vulkan.h>
+
+#include "ffi/core/result.h"
+#include "stats.h"
+
+#define DEFAULT_FRAMES_IN_FLIGHT 2
+#define MAX_FRAMES_IN_FLIGHT 8
+
+#define MAX_DEFERRED_DROPS 64
+
+typedef void (*DeferredDropFn)(Handle object);
+
+struct DeferredDrop {
+    DeferredDropFn drop_fn;
+    Handle object;
+
+    // The last submission that could use the object
+    uint64_t submit_serial;
+};
+
+struct RendererFrame {
+    VkSemaphore image_available;
+    VkSemaphore render_finished;
+
+    // Signaled when the GPU has finished the commands of the frame slot
+    VkFence in_flight;
+
+    // Owned by `RendererCmdBuffers`
+    VkCommandBuffer cmd_buffer;
+
+    // The serial of the last submission of the slot (0 if none),
+    // it is complete once `in_flight` is waited
+    uint64_t submit_serial;
+};
+
+struct RendererFrames {
+    VkDevice device;
+    struct RendererFrame *frames;
+    uint32_t count;
+    uint32_t current_idx;
+
+    // Submissions to the graphics queue are numbered from 1.
+    // A signaled frame fence completes its submission and all the earlier ones.
+    uint64_t submit_serial;
+    uint64_t completed_serial;
+
+    // In the order of deferral
+    struct DeferredDrop deferred_drops[MAX_DEFERRED_DROPS];
+    uint32_t deferred_drop_count;
+
+    // The fence of the frame that uses the swapchain image (or VK_NULL_HANDLE).
+    // There can be more swapchain images than frames in flight and vice versa.
+    VkFence *image_fences;
+    uint32_t image_count;
+
+    uint64_t last_frame_begin_ns;
+    RendererFrameStats stats;
+};
+
+Result new_renderer_frames(
+    VkDevice device,
+    VkCommandBuffer *cmd_buffers,
+    uint32_t frame_count,
+    uint32_t swapchain_image_count
+);
+
+struct RendererFrame *current_renderer_frame(struct RendererFrames *frames);
+
+// Waits until the GPU has finished the previous submission of the current frame slot
+// and drops the deferred objects no submission can use anymore
+Result wait_renderer_frame(struct RendererFrames *frames);
+
+// Makes room for `count` more deferred drops.
+// If there is not enough room (e.g. the swapchain is recreated repeatedly without a submitted frame),
+// waits until the GPU has finished the latest submission and drops everything deferred so far.
+Result reserve_renderer_frame_drops(struct RendererFrames *frames, uint32_t count);
+
+// Defers the object drop until the GPU has finished all the submissions made so far.
+// A frame that is not submitted (e.g. skipped) doesn't delay or hasten the drop.
+// The room for the drop must be reserved beforehand.
+void defer_renderer_frame_drop(
+    struct RendererFrames *frames,
+    DeferredDropFn drop_fn,
+    Handle object
+);
+
+// Forgets the image-to-frame bindings, must be called when the swapchain is recreated
+Result reset_renderer_frame_images(struct RendererFrames *frames, uint32_t swapchain_image_count);
+
+// Waits until the GPU has finished the previous frame rendered into the image
+// and assigns the image to the current frame slot
+Result bind_renderer_frame_image(struct RendererFrames *frames, uint32_t image_idx);
+
+// Submits the frame signaling the slot fence.
+// The fence is reset right before the submission: it stays signaled on every earlier exit,
+// and it is signaled again if the submission fails.
+Result submit_renderer_frame(struct RendererFrames *frames, VkQueue queue, const VkSubmitInfo *submit_info);
+
+void advance_renderer_frame(struct RendererFrames *frames);
+
+void drop_renderer_frames(struct RendererFrames *frames);
+
+#endif // ___APRIORI2_GRAPHICS_RENDERER_FRAMES_H___
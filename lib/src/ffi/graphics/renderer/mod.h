@@ -1,20 +1,132 @@
 #ifndef ___APRIORI2_GRAPHICS_RENDERER_H___
 #define ___APRIORI2_GRAPHICS_RENDERER_H___
 
+#include <stdbool.h>
+
 #include "ffi/core/result.h"
 #include "ffi/core/vulkan_instance/mod.h"
+#include "ffi/graphics/pipeline/stats.h"
+#include "ffi/graphics/present_policy.h"
+#include "ffi/graphics/memory/stats.h"
+#include "ffi/graphics/profiler/stats.h"
+#include "ffi/graphics/pipeline/overlay/quad.h"
+#include "stats.h"
 
 #define RENDER_SUBPASS_OVERLAY_IDX 0
 
 typedef struct RendererFFI *Renderer;
 
+struct RendererCreateParams {
+    // Path to the on-disk pipeline cache.
+    // The pipeline cache is not persistent if NULL.
+    const char *pipeline_cache_path;
+
+    // 0 means DEFAULT_FRAMES_IN_FLIGHT
+    uint32_t frames_in_flight;
+
+    PresentPolicy present_policy;
+
+    // Threads recording the frame command buffers (including the rendering one),
+    // 0 means the default for the machine
+    uint32_t record_thread_count;
+
+    // Forces the per-resource descriptor sets
+    // even if the device supports the descriptor indexing
+    bool disable_bindless;
+
+    // Discards the almost transparent overlay fragments
+    bool overlay_alpha_test;
+};
+
 Result new_renderer(
     VulkanInstance vulkan_instance,
     Handle window_platform_handle,
     uint16_t window_width,
-    uint16_t window_height
+    uint16_t window_height,
+    struct RendererCreateParams *params
+);
+
+Result renderer_draw_frame(Renderer renderer);
+
+// The quads are drawn by the next `renderer_draw_frame`
+void renderer_draw_overlay(Renderer renderer, const OverlayQuad *quads, uint32_t count);
+
+// Packs the image into the overlay atlas, the quads refer to it by `image_id`.
+// `pixels` are `width * height` tightly packed RGBA8 texels.
+// Evicts the least recently drawn atlas page if there is no room for the image.
+Result renderer_add_overlay_image(
+    Renderer renderer,
+    uint32_t width,
+    uint32_t height,
+    const void *pixels,
+    uint32_t *image_id
+);
+
+// Uploads the changed region of the image only
+Result renderer_update_overlay_image(
+    Renderer renderer,
+    uint32_t image_id,
+    int32_t x,
+    int32_t y,
+    uint32_t width,
+    uint32_t height,
+    const void *pixels
 );
 
+void renderer_remove_overlay_image(Renderer renderer, uint32_t image_id);
+
+// False if the image was removed or evicted (it has to be added again)
+bool renderer_is_overlay_image_resident(Renderer renderer, uint32_t image_id);
+
+// The swapchain is recreated at the beginning of the next frame.
+// Rendering is paused while the window has a zero area.
+void renderer_resize(Renderer renderer, uint16_t width, uint16_t height);
+
+PipelineCacheStats renderer_pipeline_cache_stats(Renderer renderer);
+
+RendererFrameStats renderer_frame_stats(Renderer renderer);
+
+// Staging uploads of the last frame and totals
+RendererUploadStats renderer_upload_stats(Renderer renderer);
+
+OverlayDrawStats renderer_overlay_stats(Renderer renderer);
+
+OverlayAtlasStats renderer_overlay_atlas_stats(Renderer renderer);
+
+DescrAllocatorStats renderer_descr_allocator_stats(Renderer renderer);
+
+// The GPU time of the frame scopes, resolved `frames_in_flight` frames later
+GpuProfilerStats renderer_gpu_profiler_stats(Renderer renderer);
+
+// The pipeline statistics counters are disabled by default
+void renderer_set_pipeline_stats_enabled(Renderer renderer, bool is_enabled);
+
+// The counters of the last resolved frame recorded while they were enabled
+PipelineStatsFrame renderer_pipeline_stats(Renderer renderer);
+
+// Rebuilds the overlay pipeline with new SPIR-V (e.g. hot reloaded shaders) on the calling thread.
+// The frames keep using the old pipeline until the next frame boundary, where the new one is swapped in.
+// Can be called on any thread while the renderer is alive.
+Result renderer_rebuild_overlay_pipeline(
+    Renderer renderer,
+    const uint32_t *vertex_code,
+    size_t vertex_code_size,
+    const uint32_t *fragment_code,
+    size_t fragment_code_size
+);
+
+// The `FRAGMENT_OVERLAY_VARIANT_*` bitmask the overlay pipeline uses
+uint32_t renderer_overlay_fragment_variant(Renderer renderer);
+
+// True if the pipelines select the textures through the bindless table
+bool renderer_is_bindless(Renderer renderer);
+
+// Reflects the current swapchain (it can change after a resize)
+SwapchainInfo renderer_swapchain_info(Renderer renderer);
+
+// Device memory usage per heap
+GpuMemoryStats renderer_gpu_memory_stats(Renderer renderer);
+
 void drop_renderer(Renderer renderer);
 
 #endif // ___APRIORI2_GRAPHICS_RENDERER_H___
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "ownership.h"
+
+#include "ffi/util/mod.h"
+
+struct QueueOwnershipTransfer upload_ownership_transfer(
+    struct RendererQueueFamilies *families,
+    VkPipelineStageFlags dst_stage,
+    VkAccessFlags dst_access
+) {
+    ASSERT_NOT_NULL(families);
+
+    struct QueueOwnershipTransfer transfer = {
+        .src_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+        .src_access = VK_ACCESS_TRANSFER_WRITE_BIT
+    };
+
+    transfer.src_family = families->transfer_idx;
+    transfer.dst_family = families->graphics_idx;
+    transfer.dst_stage = dst_stage;
+    transfer.dst_access = dst_access;
+
+    return transfer;
+}
+
+bool is_ownership_transfer_needed(struct QueueOwnershipTransfer *transfer) {
+    ASSERT_NOT_NULL(transfer);
+
+    return transfer->src_family != transfer->dst_family;
+}
+
+void fill_buffer_barrier(
+    VkBufferMemoryBarrier *barrier,
+    struct QueueOwnershipTransfer *transfer,
+    VkBuffer buffer
+) {
+    barrier->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier->buffer = buffer;
+    barrier->offset = 0;
+    barrier->size = VK_WHOLE_SIZE;
+
+    if (is_ownership_transfer_needed(transfer)) {
+        barrier->srcQueueFamilyIndex = transfer->src_family;
+        barrier->dstQueueFamilyIndex = transfer->dst_family;
+    } else {
+        barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    }
+}
+
+void fill_image_barrier(
+    VkImageMemoryBarrier *barrier,
+    struct QueueOwnershipTransfer *transfer,
+    VkImage image,
+    const VkImageSubresourceRange *subresource_range,
+    VkImageLayout old_layout,
+    VkImageLayout new_layout
+) {
+    barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier->image = image;
+    barrier->subresourceRange = *subresource_range;
+    barrier->oldLayout = old_layout;
+    barrier->newLayout = new_layout;
+
+    if (is_ownership_transfer_needed(transfer)) {
+        barrier->srcQueueFamilyIndex = transfer->src_family;
+        barrier->dstQueueFamilyIndex = transfer->dst_family;
+    } else {
+        barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    }
+}
+
+void cmd_release_buffer_ownership(
+    VkCommandBuffer cmd_buffer,
+    struct QueueOwnershipTransfer *transfer,
+    VkBuffer buffer
+) {
+    ASSERT_NOT_NULL(cmd_buffer);
+    ASSERT_NOT_NULL(transfer);
+
+    VkBufferMemoryBarrier barrier = { 0 };
+
+    if (!is_ownership_transfer_needed(transfer))
+        return;
+
+    fill_buffer_barrier(&barrier, transfer, buffer);
+    barrier.srcAccessMask = transfer->src_access;
+
+    // The destination access mask is ignored by the release barrier
+    vkCmdPipelineBarrier(
+        cmd_buffer,
+        transfer->src_stage,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0,
+        0, NULL,
+        1, &barrier,
+        0, NULL
+    );
+}
+
+void cmd_acquire_buffer_ownership(
+    VkCommandBuffer cmd_buffer,
+    struct QueueOwnershipTransfer *transfer,
+    VkBuffer buffer
+) {
+    ASSERT_NOT_NULL(cmd_buffer);
+    ASSERT_NOT_NULL(transfer);
+
+    VkBufferMemoryBarrier barrier = { 0 };
+    VkPipelineStageFlags src_stage = transfer->dst_stage;
+
+    fill_buffer_barrier(&barrier, transfer, buffer);
+    barrier.dstAccessMask = transfer->dst_access;
+
+    // The source access mask is ignored by the acquire barrier
+    if (!is_ownership_transfer_needed(transfer)) {
+        src_stage = transfer->src_stage;
+        barrier.srcAccessMask = transfer->src_access;
+    }
+
+    vkCmdPipelineBarrier(
+        cmd_buffer,
+        src_stage,
+        transfer->dst_stage,
+        0,
+        0, NULL,
+        1, &barrier,
+        0, NULL
+    );
+}
+
+void cmd_release_image_ownership(
+    VkCommandBuffer cmd_buffer,
+    struct QueueOwnershipTransfer *transfer,
+    VkImage image,
+    const VkImageSubresourceRange *subresource_range,
+    VkImageLayout old_layout,
+    VkImageLayout new_layout
+) {
+    ASSERT_NOT_NULL(cmd_buffer);
+    ASSERT_NOT_NULL(transfer);
+    ASSERT_NOT_NULL(subresource_range);
+
+    VkImageMemoryBarrier barrier = { 0 };
+
+    if (!is_ownership_transfer_needed(transfer))
+        return;
+
+    fill_image_barrier(&barrier, transfer, image, subresource_range, old_layout, new_layout);
+    barrier.srcAccessMask = transfer->src_access;
+
+    vkCmdPipelineBarrier(
+        cmd_buffer,
+        transfer->src_stage,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0,
+        0, NULL,
+        0, NULL,
+        1, &barrier
+    );
+}
+
+void cmd_acquire_image_ownership(
+    VkCommandBuffer cmd_buffer,
+    struct QueueOwnershipTransfer *transfer,
+    VkImage image,
+    const VkImageSubresourceRange *subresource_range,
+    VkImageLayout old_layout,
+    VkImageLayout new_layout
+) {
+    ASSERT_NOT_NULL(cmd_buffer);
+    ASSERT_NOT_NULL(transfer);
+    ASSERT_NOT_NULL(subresource_range);
+
+    VkImageMemoryBarrier barrier = { 0 };
+    VkPipelineStageFlags src_stage = transfer->dst_stage;
+
+    fill_image_barrier(&barrier, transfer, image, subresource_range, old_layout, new_layout);
+    barrier.dstAccessMask = transfer->dst_access;
+
+    if (!is_ownership_transfer_needed(transfer)) {
+        src_stage = transfer->src_stage;
+        barrier.srcAccessMask = transfer->src_access;
+    }
+
+    vkCmdPipelineBarrier(
+        cmd_buffer,
+        src_stage,
+        transfer->dst_stage,
+        0,
+        0, NULL,
+        0, NULL,
+        1, &barrier
+    );
+}
@@ -0,0 +1,67 @@
+#ifndef ___APRIORI2_GRAPHICS_RENDERER_OWNERSHIP_H___
+#define ___APRIORI2_GRAPHICS_RENDERER_OWNERSHIP_H___
+
+#include <vulkan/vulkan.h>
+
+#include "queues.h"
+
+// Queue family ownership transfer of an exclusive resource.
+// The release half is recorded on the source queue,
+// the acquire half is recorded on the destination queue
+// and must be ordered after the release by a semaphore waited at `dst_stage`
+// (the acquire barrier source stage, so the layout transition happens after the wait).
+//
+// If both families are the same, the release is a no-op
+// and the acquire is an ordinary pipeline barrier.
+struct QueueOwnershipTransfer {
+    uint32_t src_family;
+    uint32_t dst_family;
+
+    VkPipelineStageFlags src_stage;
+    VkAccessFlags src_access;
+
+    VkPipelineStageFlags dst_stage;
+    VkAccessFlags dst_access;
+};
+
+// Uploads: the transfer queue writes, the graphics queue reads
+struct QueueOwnershipTransfer upload_ownership_transfer(
+    struct RendererQueueFamilies *families,
+    VkPipelineStageFlags dst_stage,
+    VkAccessFlags dst_access
+);
+
+bool is_ownership_transfer_needed(struct QueueOwnershipTransfer *transfer);
+
+void cmd_release_buffer_ownership(
+    VkCommandBuffer cmd_buffer,
+    struct QueueOwnershipTransfer *transfer,
+    VkBuffer buffer
+);
+
+void cmd_acquire_buffer_ownership(
+    VkCommandBuffer cmd_buffer,
+    struct QueueOwnershipTransfer *transfer,
+    VkBuffer buffer
+);
+
+// The layout transition must be the same in both halves
+void cmd_release_image_ownership(
+    VkCommandBuffer cmd_buffer,
+    struct QueueOwnershipTransfer *transfer,
+    VkImage image,
+    const VkImageSubresourceRange *subresource_range,
+    VkImageLayout old_layout,
+    VkImageLayout new_layout
+);
+
+void cmd_acquire_image_ownership(
+    VkCommandBuffer cmd_buffer,
+    struct QueueOwnershipTransfer *transfer,
+    VkImage image,
+    const VkImageSubresourceRange *subresource_range,
+    VkImageLayout old_layout,
+    VkImageLayout new_layout
+);
+
+#endif // ___APRIORI2_GRAPHICS_RENDERER_OWNERSHIP_H___
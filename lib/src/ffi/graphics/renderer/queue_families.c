@@ -54,12 +54,12 @@ Result new_renderer_queue_families(
     for (uint32_t i = 0; i < queue_family_count; ++i) {
         current = family_props + i;
 
-        result.error = vkGetPhysicalDeviceSurfaceSupportKHR(
+        result.error = VK_RESULT(vkGetPhysicalDeviceSurfaceSupportKHR(
             phy_device,
             i,
             surface,
             &is_present_support
-        );
+        ));
         EXPECT_SUCCESS(result);
 
         if (
@@ -85,6 +85,38 @@ Result new_renderer_queue_families(
         }
     }
 
+    // Dedicated families have neither graphics nor compute (for transfer) capabilities.
+    // The compute-only family can do transfers too, so it is the second choice for uploads.
+    for (uint32_t i = 0; i < queue_family_count; ++i) {
+        current = family_props + i;
+
+        if (current->queueFlags & VK_QUEUE_GRAPHICS_BIT)
+            continue;
+
+        if (
+            (current->queueFlags & VK_QUEUE_COMPUTE_BIT)
+            && !families->is_dedicated_compute
+        ) {
+            families->compute_idx = i;
+            families->is_dedicated_compute = true;
+        } else if (
+            (current->queueFlags & VK_QUEUE_TRANSFER_BIT)
+            && !(current->queueFlags & VK_QUEUE_COMPUTE_BIT)
+            && !families->is_dedicated_transfer
+        ) {
+            families->transfer_idx = i;
+            families->is_dedicated_transfer = true;
+        }
+    }
+
+    if (!families->is_dedicated_compute)
+        families->compute_idx = families->graphics_idx;
+
+    if (!families->is_dedicated_transfer) {
+        families->transfer_idx = families->compute_idx;
+        families->is_dedicated_transfer = families->is_dedicated_compute;
+    }
+
     if (!is_graphics_queue_found && !is_present_queue_found)
         result.error = RENDERER_QUEUE_FAMILIES_NOT_FOUND;
     else if (!is_graphics_queue_found)
@@ -110,6 +142,20 @@ Result new_renderer_queue_families(
             LOG_GROUP(struct, "present queue family idx: %d"),
             families->present_idx
         );
+
+        trace(
+            LOG_TARGET,
+            LOG_GROUP(struct, "transfer queue family idx: %d (%s)"),
+            families->transfer_idx,
+            families->is_dedicated_transfer ? "dedicated" : "graphics fallback"
+        );
+
+        trace(
+            LOG_TARGET,
+            LOG_GROUP(struct, "compute queue family idx: %d (%s)"),
+            families->compute_idx,
+            families->is_dedicated_compute ? "dedicated" : "graphics fallback"
+        );
     }
 
     FN_EXIT(result, {
@@ -127,6 +173,39 @@ bool is_same_queue_families(struct RendererQueueFamilies *families) {
     return families->graphics_idx == families->present_idx;
 }
 
+uint32_t unique_queue_families(
+    struct RendererQueueFamilies *families,
+    uint32_t unique_families[MAX_RENDERER_QUEUE_FAMILIES]
+) {
+    ASSERT_NOT_NULL(families);
+    ASSERT_NOT_NULL(unique_families);
+
+    uint32_t all_families[] = {
+        families->graphics_idx,
+        families->present_idx,
+        families->transfer_idx,
+        families->compute_idx
+    };
+    uint32_t unique_count = 0;
+
+    static_assert(
+        STATIC_ARRAY_SIZE(all_families) == MAX_RENDERER_QUEUE_FAMILIES,
+        "all renderer queue families must be listed"
+    );
+
+    for (uint32_t i = 0, j = 0; i < STATIC_ARRAY_SIZE(all_families); ++i) {
+        for (j = 0; j < unique_count; ++j) {
+            if (unique_families[j] == all_families[i])
+                break;
+        }
+
+        if (j == unique_count)
+            unique_families[unique_count++] = all_families[i];
+    }
+
+    return unique_count;
+}
+
 void drop_renderer_queue_families(struct RendererQueueFamilies *queues) {
     if (queues == NULL)
         goto exit;
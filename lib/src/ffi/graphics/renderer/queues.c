@@ -8,35 +8,23 @@
 
 Result new_renderer_queues(
     VkDevice device,
-    struct RendererQueueFamilies *families,
-    uint32_t queue_cis_count
+    struct RendererQueueFamilies *families
 ) {
+    ASSERT_NOT_NULL(device);
+    ASSERT_NOT_NULL(families);
+
     Result result = { 0 };
-    uint32_t graphics_idx = RENDERER_QUEUE_GRAPHICS_IDX;
-    uint32_t present_idx = RENDERER_QUEUE_PRESENT_IDX;
 
     info(LOG_TARGET, "creating new renderer queues...");
 
     struct RendererQueues *queues = ALLOC(result, struct RendererQueues);
 
-    if (queue_cis_count == 1) {
-        present_idx = graphics_idx;
-    }
-
-    vkGetDeviceQueue(
-        device,
-        families->graphics_idx,
-        graphics_idx,
-        &queues->graphics
-    );
-
-    vkGetDeviceQueue(
-        device,
-        families->present_idx,
-        present_idx,
-        &queues->present
-    );
+    vkGetDeviceQueue(device, families->graphics_idx, RENDERER_QUEUE_IDX, &queues->graphics);
+    vkGetDeviceQueue(device, families->present_idx, RENDERER_QUEUE_IDX, &queues->present);
+    vkGetDeviceQueue(device, families->transfer_idx, RENDERER_QUEUE_IDX, &queues->transfer);
+    vkGetDeviceQueue(device, families->compute_idx, RENDERER_QUEUE_IDX, &queues->compute);
 
+    result.object = queues;
     info(LOG_TARGET, "new renderer queues created successfully");
 
     FN_FORCE_EXIT(result);
@@ -6,18 +6,29 @@
 
 #include "ffi/core/result.h"
 
-// Indices inside the queue family
-#define RENDERER_QUEUE_GRAPHICS_IDX 0
-#define RENDERER_QUEUE_PRESENT_IDX 1
+// Every used queue family gets exactly one queue:
+// roles sharing the family share the queue as well
+#define RENDERER_QUEUE_IDX 0
+
+#define MAX_RENDERER_QUEUE_FAMILIES 4
 
 struct RendererQueueFamilies {
     uint32_t graphics_idx;
     uint32_t present_idx;
+
+    // Fall back to the graphics family if the device has no dedicated ones
+    uint32_t transfer_idx;
+    uint32_t compute_idx;
+
+    bool is_dedicated_transfer;
+    bool is_dedicated_compute;
 };
 
 struct RendererQueues {
     VkQueue graphics;
     VkQueue present;
+    VkQueue transfer;
+    VkQueue compute;
 };
 
 Result new_renderer_queue_families(
@@ -27,12 +38,17 @@ Result new_renderer_queue_families(
 
 bool is_same_queue_families(struct RendererQueueFamilies *families);
 
+// Fills the distinct families used by the renderer, returns their count
+uint32_t unique_queue_families(
+    struct RendererQueueFamilies *families,
+    uint32_t unique_families[MAX_RENDERER_QUEUE_FAMILIES]
+);
+
 void drop_renderer_queue_families(struct RendererQueueFamilies *families);
 
 Result new_renderer_queues(
     VkDevice device,
-    struct RendererQueueFamilies *families,
-    uint32_t queue_cis_count
+    struct RendererQueueFamilies *families
 );
 
 void drop_renderer_queues(struct RendererQueues *queues);
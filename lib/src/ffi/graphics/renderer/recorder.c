@@ -0,0 +1,236 @@
+#include "recorder.h"
+
+#include "ffi/core/log.h"
+#include "ffi/util/mod.h"
+#include "ffi/math/mod.h"
+
+#define LOG_TARGET LOG_SUB_TARGET( \
+    LOG_STRUCT_TARGET(Renderer), LOG_STRUCT_TARGET(RendererRecorder) \
+)
+
+void record_secondary_cmd_buffer(struct RendererRecorder *recorder, uint32_t thread_idx) {
+    uint32_t slot_idx = recorder->frame_idx * recorder->thread_count + thread_idx;
+    VkCommandBuffer cmd_buffer = recorder->cmd_buffers[slot_idx];
+    VkCommandBufferBeginInfo cmd_buffer_bi = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+            | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT
+    };
+    cmd_buffer_bi.pInheritanceInfo = &recorder->inheritance;
+
+    recorder->record_results[slot_idx] = vkBeginCommandBuffer(cmd_buffer, &cmd_buffer_bi);
+    if (recorder->record_results[slot_idx] != VK_SUCCESS)
+        return;
+
+    recorder->job_fn(recorder->job_ctx, cmd_buffer, thread_idx, recorder->thread_count);
+
+    recorder->record_results[slot_idx] = vkEndCommandBuffer(cmd_buffer);
+}
+
+void record_worker_main(Handle arg) {
+    struct RecordWorker *worker = arg;
+    struct RendererRecorder *recorder = worker->recorder;
+    uint64_t done_generation = 0;
+
+    lock_os_mutex(recorder->mutex);
+
+    for (;;) {
+        while (!recorder->is_stopping && recorder->job_generation == done_generation)
+            wait_os_cond(recorder->job_ready, recorder->mutex);
+
+        if (recorder->is_stopping)
+            break;
+
+        done_generation = recorder->job_generation;
+        unlock_os_mutex(recorder->mutex);
+
+        record_secondary_cmd_buffer(recorder, worker->thread_idx);
+
+        lock_os_mutex(recorder->mutex);
+
+        recorder->pending_worker_count -= 1;
+        if (recorder->pending_worker_count == 0)
+            broadcast_os_cond(recorder->job_done);
+    }
+
+    unlock_os_mutex(recorder->mutex);
+}
+
+Result new_renderer_recorder(
+    VkDevice device,
+    uint32_t graphics_family_idx,
+    uint32_t frame_count,
+    uint32_t thread_count
+) {
+    ASSERT_NOT_NULL(device);
+
+    Result result = { 0 };
+    uint32_t slot_count = 0;
+    VkCommandPoolCreateInfo cmd_pool_ci = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT
+    };
+    VkCommandBufferAllocateInfo cmd_buffer_ai = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+        .commandBufferCount = 1
+    };
+    cmd_pool_ci.queueFamilyIndex = graphics_family_idx;
+
+    if (thread_count == 0)
+        thread_count = MIN(os_cpu_count(), DEFAULT_RECORD_THREADS);
+
+    thread_count = CLAMP(thread_count, 1, MAX_RECORD_THREADS);
+    slot_count = frame_count * thread_count;
+
+    info(LOG_TARGET, "creating new renderer recorder...");
+
+    struct RendererRecorder *recorder = ALLOC(result, struct RendererRecorder);
+
+    recorder->device = device;
+    recorder->thread_count = thread_count;
+    recorder->frame_count = frame_count;
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "recording threads: %d (cpu count: %d)"),
+        thread_count, os_cpu_count()
+    );
+
+    recorder->cmd_pools = ALLOC_ARRAY(result, VkCommandPool, slot_count);
+    recorder->cmd_buffers = ALLOC_ARRAY(result, VkCommandBuffer, slot_count);
+    recorder->record_results = ALLOC_ARRAY(result, VkResult, slot_count);
+
+    for (uint32_t i = 0; i < slot_count; ++i) {
+        result.error = VK_RESULT(vkCreateCommandPool(device, &cmd_pool_ci, NULL, &recorder->cmd_pools[i]));
+        EXPECT_SUCCESS(result);
+
+        cmd_buffer_ai.commandPool = recorder->cmd_pools[i];
+
+        result.error = VK_RESULT(vkAllocateCommandBuffers(device, &cmd_buffer_ai, &recorder->cmd_buffers[i]));
+        EXPECT_SUCCESS(result);
+    }
+
+    result = new_os_mutex();
+    RESULT_UNWRAP(recorder->mutex, result);
+
+    result = new_os_cond();
+    RESULT_UNWRAP(recorder->job_ready, result);
+
+    result = new_os_cond();
+    RESULT_UNWRAP(recorder->job_done, result);
+
+    recorder->workers = ALLOC_ARRAY(result, struct RecordWorker, thread_count);
+
+    for (uint32_t i = 1; i < thread_count; ++i) {
+        struct RecordWorker *worker = &recorder->workers[i];
+
+        worker->recorder = recorder;
+        worker->thread_idx = i;
+
+        result = new_os_thread(record_worker_main, worker);
+        RESULT_UNWRAP(worker->thread, result);
+    }
+
+    result.object = recorder;
+    info(LOG_TARGET, "new renderer recorder created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_renderer_recorder(recorder);
+    });
+}
+
+Result record_renderer_secondaries(
+    struct RendererRecorder *recorder,
+    uint32_t frame_idx,
+    const VkCommandBufferInheritanceInfo *inheritance,
+    RecordJobFn job_fn,
+    Handle job_ctx,
+    VkCommandBuffer primary_cmd_buffer
+) {
+    ASSERT_NOT_NULL(recorder);
+    ASSERT_NOT_NULL(inheritance);
+    ASSERT_NOT_NULL(job_fn);
+    ASSERT_NOT_NULL(primary_cmd_buffer);
+    assert(frame_idx < recorder->frame_count && "frame index is out of range");
+
+    Result result = { 0 };
+    uint32_t first_slot_idx = frame_idx * recorder->thread_count;
+
+    // The workers are idle: the pools of the slot are not accessed by any thread
+    for (uint32_t i = 0; i < recorder->thread_count; ++i) {
+        result.error = VK_RESULT(vkResetCommandPool(recorder->device, recorder->cmd_pools[first_slot_idx + i], 0));
+        EXPECT_SUCCESS(result);
+    }
+
+    recorder->job_fn = job_fn;
+    recorder->job_ctx = job_ctx;
+    recorder->frame_idx = frame_idx;
+    recorder->inheritance = *inheritance;
+
+    lock_os_mutex(recorder->mutex);
+
+    recorder->job_generation += 1;
+    recorder->pending_worker_count = recorder->thread_count - 1;
+    broadcast_os_cond(recorder->job_ready);
+
+    unlock_os_mutex(recorder->mutex);
+
+    record_secondary_cmd_buffer(recorder, 0);
+
+    lock_os_mutex(recorder->mutex);
+
+    while (recorder->pending_worker_count > 0)
+        wait_os_cond(recorder->job_done, recorder->mutex);
+
+    unlock_os_mutex(recorder->mutex);
+
+    for (uint32_t i = 0; i < recorder->thread_count; ++i) {
+        result.error = VK_RESULT(recorder->record_results[first_slot_idx + i]);
+        EXPECT_SUCCESS(result);
+    }
+
+    vkCmdExecuteCommands(
+        primary_cmd_buffer,
+        recorder->thread_count,
+        &recorder->cmd_buffers[first_slot_idx]
+    );
+
+    FN_FORCE_EXIT(result);
+}
+
+void drop_renderer_recorder(struct RendererRecorder *recorder) {
+    if (recorder == NULL)
+        goto exit;
+
+    if (recorder->workers != NULL) {
+        lock_os_mutex(recorder->mutex);
+
+        recorder->is_stopping = true;
+        broadcast_os_cond(recorder->job_ready);
+
+        unlock_os_mutex(recorder->mutex);
+
+        for (uint32_t i = 1; i < recorder->thread_count; ++i)
+            join_os_thread(recorder->workers[i].thread);
+    }
+
+    drop_os_cond(recorder->job_done);
+    drop_os_cond(recorder->job_ready);
+    drop_os_mutex(recorder->mutex);
+
+    // The command buffers are freed with their pools
+    for (uint32_t i = 0; recorder->cmd_pools != NULL && i < recorder->frame_count * recorder->thread_count; ++i)
+        vkDestroyCommandPool(recorder->device, recorder->cmd_pools[i], NULL);
+
+    free(recorder->workers);
+    free(recorder->record_results);
+    free(recorder->cmd_buffers);
+    free(recorder->cmd_pools);
+    free(recorder);
+
+exit:
+    debug(LOG_TARGET, "drop renderer recorder");
+}
@@ -0,0 +1,85 @@
+#ifndef ___APRIORI2_GRAPHICS_RENDERER_RECORDER_H___
+#define ___APRIORI2_GRAPHICS_RENDERER_RECORDER_H___
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+
+#include "ffi/core/result.h"
+#include "ffi/os/thread.h"
+
+// Records the render pass content into secondary command buffers on several threads.
+//
+// Every recording thread (the calling one is the thread #0) has its own transient
+// command pool per frame slot: the pools are reset wholesale when the slot comes around,
+// no pool is ever shared between threads.
+// The primary buffer executes the secondary ones in the thread order,
+// so the result doesn't depend on the thread scheduling.
+
+#define MAX_RECORD_THREADS 16
+#define DEFAULT_RECORD_THREADS 4
+
+// Records the `thread_idx` share of the work into `cmd_buffer`.
+// Called on all the recording threads at once: the shared state must be read only.
+typedef void (*RecordJobFn)(Handle ctx, VkCommandBuffer cmd_buffer, uint32_t thread_idx, uint32_t thread_count);
+
+struct RendererRecorder;
+
+struct RecordWorker {
+    struct RendererRecorder *recorder;
+    uint32_t thread_idx;
+    OsThread thread;
+};
+
+struct RendererRecorder {
+    VkDevice device;
+    uint32_t thread_count;
+    uint32_t frame_count;
+
+    // `[frame_idx * thread_count + thread_idx]`
+    VkCommandPool *cmd_pools;
+    VkCommandBuffer *cmd_buffers;
+    VkResult *record_results;
+
+    // The threads #1.. (the thread #0 is the caller)
+    struct RecordWorker *workers;
+
+    OsMutex mutex;
+    OsCond job_ready;
+    OsCond job_done;
+
+    // Guarded by `mutex`
+    uint64_t job_generation;
+    uint32_t pending_worker_count;
+    bool is_stopping;
+
+    // The current job, written before the job generation is published
+    RecordJobFn job_fn;
+    Handle job_ctx;
+    uint32_t frame_idx;
+    VkCommandBufferInheritanceInfo inheritance;
+};
+
+// `thread_count` includes the calling thread, 0 means `DEFAULT_RECORD_THREADS`
+// (or less on the machines with fewer cores)
+Result new_renderer_recorder(
+    VkDevice device,
+    uint32_t graphics_family_idx,
+    uint32_t frame_count,
+    uint32_t thread_count
+);
+
+// Records `job_fn` on all the threads and executes the secondary buffers in `primary_cmd_buffer`.
+// The GPU must have finished the previous frame of the slot.
+// `inheritance` describes the subpass the secondary buffers continue.
+Result record_renderer_secondaries(
+    struct RendererRecorder *recorder,
+    uint32_t frame_idx,
+    const VkCommandBufferInheritanceInfo *inheritance,
+    RecordJobFn job_fn,
+    Handle job_ctx,
+    VkCommandBuffer primary_cmd_buffer
+);
+
+void drop_renderer_recorder(struct RendererRecorder *recorder);
+
+#endif // ___APRIORI2_GRAPHICS_RENDERER_RECORDER_H___
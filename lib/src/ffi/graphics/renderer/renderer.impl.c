@@ -10,20 +10,21 @@
 
 #include "ffi/core/def.h"
 #include "ffi/core/error.h"
+#include "ffi/core/cpu_profiler/mod.h"
 #include "ffi/core/vulkan_instance/vulkan_instance.impl.h"
 #include "ffi/core/log.h"
 #include "ffi/os/surface.h"
+#include "ffi/os/thread.h"
+#include "ffi/os/time.h"
 #include "ffi/util/mod.h"
 
 #define LOG_TARGET LOG_STRUCT_TARGET(Renderer)
 
-#define CI_GRAPHICS_IDX 0
-#define CI_PRESENT_IDX 1
-
 struct PhyDeviceDescr {
     VkPhysicalDevice phy_device;
     VkPhysicalDeviceProperties properties;
     VkPhysicalDeviceFeatures features;
+    bool is_bindless_supported;
 };
 
 uint32_t rate_phy_device_suitability(
@@ -49,6 +50,9 @@ uint32_t rate_phy_device_suitability(
         DEV_TYPE_CASE(DISCRETE_GPU, 1000);
         DEV_TYPE_CASE(INTEGRATED_GPU, 100);
         DEV_TYPE_CASE(VIRTUAL_GPU, 10);
+        DEV_TYPE_CASE(CPU, 1);
+        default:
+            break;
     }
 #undef DEV_TYPE_CASE
 
@@ -121,6 +125,8 @@ Result select_phy_device(VulkanInstance instance) {
         winner_descr->properties.deviceName, score
     );
 
+    result.object = winner_descr;
+
     FN_FORCE_EXIT(result);
 }
 
@@ -132,23 +138,23 @@ Result phy_device_surface_formats(VkPhysicalDevice phy_device, VkSurfaceKHR surf
     uint32_t surface_formats_count = 0;
     DynArray surface_formats = NULL;
 
-    result.error = vkGetPhysicalDeviceSurfaceFormatsKHR(
+    result.error = VK_RESULT(vkGetPhysicalDeviceSurfaceFormatsKHR(
         phy_device,
         surface,
         &surface_formats_count,
         NULL
-    );
+    ));
     EXPECT_SUCCESS(result);
 
     result = NEW_DYN_ARRAY(VkSurfaceFormatKHR, surface_formats_count);
     RESULT_UNWRAP(surface_formats, result);
 
-    result.error = vkGetPhysicalDeviceSurfaceFormatsKHR(
+    result.error = VK_RESULT(vkGetPhysicalDeviceSurfaceFormatsKHR(
         phy_device,
         surface,
         &surface_formats->count,
         AS(surface_formats->data, VkSurfaceFormatKHR *)
-    );
+    ));
     EXPECT_SUCCESS(result);
 
     result.object = surface_formats;
@@ -190,34 +196,18 @@ void fill_renderer_queues_create_info(
     ASSERT_NOT_NULL(queues_cis_count);
     ASSERT_NOT_NULL(queues_cis);
 
-    static float priorities[2] = { 0 };
+    static const float priority = 1.0f;
+    uint32_t unique_families[MAX_RENDERER_QUEUE_FAMILIES] = { 0 };
 
     trace(LOG_TARGET, LOG_GROUP(struct, "filling renderer queues create infos..."));
 
-    priorities[CI_GRAPHICS_IDX] = 1.0f;
-    priorities[CI_PRESENT_IDX] = 0.75f;
-
-    if (is_same_queue_families(families)) {
-        uint32_t family_idx = families->graphics_idx;
+    *queues_cis_count = unique_queue_families(families, unique_families);
 
-        *queues_cis_count = 1;
-
-        queues_cis->sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        queues_cis->queueCount = 2;
-        queues_cis->queueFamilyIndex = family_idx;
-        queues_cis->pQueuePriorities = priorities;
-    } else {
-        *queues_cis_count = 2;
-
-        queues_cis[CI_GRAPHICS_IDX].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        queues_cis[CI_GRAPHICS_IDX].queueCount = 1;
-        queues_cis[CI_GRAPHICS_IDX].queueFamilyIndex = families->graphics_idx;
-        queues_cis[CI_GRAPHICS_IDX].pQueuePriorities = &priorities[CI_GRAPHICS_IDX];
-
-        queues_cis[CI_PRESENT_IDX].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        queues_cis[CI_PRESENT_IDX].queueCount = 1;
-        queues_cis[CI_PRESENT_IDX].queueFamilyIndex = families->present_idx;
-        queues_cis[CI_PRESENT_IDX].pQueuePriorities = &priorities[CI_PRESENT_IDX];
+    for (uint32_t i = 0; i < *queues_cis_count; ++i) {
+        queues_cis[i].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        queues_cis[i].queueCount = 1;
+        queues_cis[i].queueFamilyIndex = unique_families[i];
+        queues_cis[i].pQueuePriorities = &priority;
     }
 }
 
@@ -228,14 +218,14 @@ Result check_all_device_layers_available(VkPhysicalDevice device, const char **l
 
     trace(LOG_TARGET, LOG_GROUP(struct, "checking requested validation layers"));
 
-    result.error = vkEnumerateDeviceLayerProperties(device, &property_count, NULL);
+    result.error = VK_RESULT(vkEnumerateDeviceLayerProperties(device, &property_count, NULL));
     EXPECT_SUCCESS(result);
 
     trace(LOG_TARGET, LOG_GROUP(struct, "available validation layers count: %d"), property_count);
 
     layer_props = ALLOC_ARRAY_UNINIT(result, VkLayerProperties, property_count);
 
-    result.error = vkEnumerateDeviceLayerProperties(device, &property_count, layer_props);
+    result.error = VK_RESULT(vkEnumerateDeviceLayerProperties(device, &property_count, layer_props));
     EXPECT_SUCCESS(result);
 
     for (uint32_t i = 0, j = 0; i < num_layers; ++i) {
@@ -269,14 +259,14 @@ Result check_all_device_extensions_available(
 
     trace(LOG_TARGET, LOG_GROUP(struct, "checking requested extensions"));
 
-    result.error = vkEnumerateDeviceExtensionProperties(phy_device, NULL, &property_count, NULL);
+    result.error = VK_RESULT(vkEnumerateDeviceExtensionProperties(phy_device, NULL, &property_count, NULL));
     EXPECT_SUCCESS(result);
 
     trace(LOG_TARGET, LOG_GROUP(struct, "available extension count: %d"), property_count);
 
     extension_props = ALLOC_ARRAY_UNINIT(result, VkLayerProperties, property_count);
 
-    result.error = vkEnumerateDeviceExtensionProperties(phy_device, NULL, &property_count, extension_props);
+    result.error = VK_RESULT(vkEnumerateDeviceExtensionProperties(phy_device, NULL, &property_count, extension_props));
     EXPECT_SUCCESS(result);
 
     for (uint32_t i = 0, j = 0; i < num_extensions; ++i) {
@@ -310,7 +300,13 @@ Result new_gpu(
     ASSERT_NOT_NULL(queues_cis);
 
     Result result = { 0 };
-    VkPhysicalDeviceFeatures enabled_features = { 0 };
+
+    PROFILE_ZONE_BEGIN(new_gpu);
+
+    VkPhysicalDeviceFeatures2 enabled_features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2
+    };
+    VkPhysicalDeviceDescriptorIndexingFeatures bindless_features = bindless_device_features();
     VkDeviceCreateInfo device_ci = {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO
     };
@@ -325,42 +321,63 @@ Result new_gpu(
 
     const uint32_t layer_names_count = STATIC_ARRAY_SIZE(layer_names);
 #   else
-    const char *layer_names = NULL;
+    const char **layer_names = NULL;
     const uint32_t layer_names_count = 0;
 #   endif // ___debug___
 
     const char *extension_names[] = {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME
+        VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+        VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME
     };
 
+    // The descriptor indexing is the last one
+    const uint32_t extension_names_count = phy_dev_descr->is_bindless_supported
+        ? STATIC_ARRAY_SIZE(extension_names)
+        : STATIC_ARRAY_SIZE(extension_names) - 1;
+
     result = check_all_device_layers_available(phy_dev_descr->phy_device, layer_names, layer_names_count);
     EXPECT_SUCCESS(result);
 
     result = check_all_device_extensions_available(
         phy_dev_descr->phy_device,
         extension_names,
-        STATIC_ARRAY_SIZE(extension_names)
+        extension_names_count
     );
     EXPECT_SUCCESS(result);
 
     if (phy_dev_descr->features.samplerAnisotropy)
-        enabled_features.samplerAnisotropy = VK_TRUE;
+        enabled_features.features.samplerAnisotropy = VK_TRUE;
+
+    // The counters are disabled at runtime, the features themselves cost nothing
+    if (is_pipeline_stats_supported(&phy_dev_descr->features)) {
+        enabled_features.features.pipelineStatisticsQuery = VK_TRUE;
+        enabled_features.features.inheritedQueries = VK_TRUE;
+    }
+
+    if (phy_dev_descr->is_bindless_supported) {
+        enabled_features.features.shaderSampledImageArrayDynamicIndexing = VK_TRUE;
+        enabled_features.pNext = &bindless_features;
+    }
 
     device_ci.enabledLayerCount = layer_names_count;
     device_ci.ppEnabledLayerNames = layer_names;
-    device_ci.enabledExtensionCount = STATIC_ARRAY_SIZE(extension_names);
+    device_ci.enabledExtensionCount = extension_names_count;
     device_ci.ppEnabledExtensionNames = extension_names;
     device_ci.queueCreateInfoCount = queues_cis_count;
     device_ci.pQueueCreateInfos = queues_cis;
-    device_ci.pEnabledFeatures = &enabled_features;
 
-    result.error = vkCreateDevice(phy_dev_descr->phy_device, &device_ci, NULL, &gpu);
+    // The features are chained, `pEnabledFeatures` must be NULL
+    device_ci.pNext = &enabled_features;
+
+    result.error = VK_RESULT(vkCreateDevice(phy_dev_descr->phy_device, &device_ci, NULL, &gpu));
     result.object = gpu;
     EXPECT_SUCCESS(result);
 
     info(LOG_TARGET, "new GPU object created successfully");
 
-    FN_FORCE_EXIT(result);
+    FN_FORCE_EXIT(result, {
+        PROFILE_ZONE_END(new_gpu);
+    });
 }
 
 Result new_render_pass(VkDevice device, VkFormat surface_format) {
@@ -392,28 +409,39 @@ Result new_render_pass(VkDevice device, VkFormat surface_format) {
     };
     subpasses[RENDER_SUBPASS_OVERLAY_IDX].pColorAttachments = &color_attachment_ref;
 
+    // The image layout transition must wait
+    // until the presentation engine has released the image
+    VkSubpassDependency dependencies[] = {
+        {
+            .srcSubpass = VK_SUBPASS_EXTERNAL,
+            .dstSubpass = RENDER_SUBPASS_OVERLAY_IDX,
+            .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .srcAccessMask = 0,
+            .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+        }
+    };
+
     VkRenderPassCreateInfo render_pass_ci = {
         .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
         .attachmentCount = 1,
         .subpassCount = STATIC_ARRAY_SIZE(subpasses),
-
-        // TODO subpasses dependencies
-        .dependencyCount = 0,
-        .pDependencies = NULL
+        .dependencyCount = STATIC_ARRAY_SIZE(dependencies),
     };
     VkRenderPass render_pass = VK_NULL_HANDLE;
 
     render_pass_ci.pAttachments = &color_attachment;
     render_pass_ci.pSubpasses = subpasses;
+    render_pass_ci.pDependencies = dependencies;
 
     info(LOG_TARGET, LOG_GROUP(struct, "creating new renderer render pass..."));
 
-    result.error = vkCreateRenderPass(
+    result.error = VK_RESULT(vkCreateRenderPass(
         device,
         &render_pass_ci,
         NULL,
         &render_pass
-    );
+    ));
     result.object = render_pass;
     EXPECT_SUCCESS(result);
 
@@ -426,14 +454,25 @@ Result new_renderer(
     VulkanInstance vulkan_instance,
     Handle window_platform_handle,
     uint16_t window_width,
-    uint16_t window_height
+    uint16_t window_height,
+    struct RendererCreateParams *params
 ) {
+    ASSERT_NOT_NULL(params);
+
     Result result = { 0 };
+    struct PhyDeviceDescr *phy_dev_descr = NULL;
     struct RendererQueueFamilies *families = NULL;
     uint32_t queues_cis_count = 0;
-    VkDeviceQueueCreateInfo queues_cis[2] = { 0 };
+    VkDeviceQueueCreateInfo queues_cis[MAX_RENDERER_QUEUE_FAMILIES] = { 0 };
     DynArray surface_formats = NULL;
+    DynArray ovl_descr_pool_sizes = NULL;
     struct SwapchainCreateParams swapchain_params = { 0 };
+    uint64_t pipelines_creation_start_ns = 0;
+    uint32_t frames_in_flight = params->frames_in_flight == 0
+        ? DEFAULT_FRAMES_IN_FLIGHT
+        : params->frames_in_flight;
+
+    PROFILE_ZONE_BEGIN(new_renderer);
 
     info(
         LOG_TARGET,
@@ -444,11 +483,26 @@ Result new_renderer(
 
     renderer->vk_instance = vulkan_instance;
 
-    struct PhyDeviceDescr *phy_dev_descr = NULL;
     result = select_phy_device(vulkan_instance);
     RESULT_UNWRAP(phy_dev_descr, result);
 
     VkPhysicalDevice phy_device = phy_dev_descr->phy_device;
+
+    if (!params->disable_bindless) {
+        result = check_bindless_support(
+            phy_device,
+            &phy_dev_descr->properties,
+            &phy_dev_descr->is_bindless_supported
+        );
+        EXPECT_SUCCESS(result);
+    }
+
+    info(
+        LOG_TARGET,
+        "descriptor mode: %s",
+        phy_dev_descr->is_bindless_supported ? "bindless" : "descriptor sets"
+    );
+
     result = new_surface(vulkan_instance->vk_handle, window_platform_handle);
     RESULT_UNWRAP(
         renderer->surface,
@@ -457,9 +511,10 @@ Result new_renderer(
 
     result = new_renderer_queue_families(phy_device, renderer->surface);
     RESULT_UNWRAP(
-        families,
+        renderer->families,
         result
     );
+    families = renderer->families;
 
     fill_renderer_queues_create_info(families, queues_cis, &queues_cis_count);
 
@@ -469,18 +524,26 @@ Result new_renderer(
         result
     );
 
-    result = new_renderer_queues(renderer->gpu, families, queues_cis_count);
+    result = new_renderer_queues(renderer->gpu, families);
     RESULT_UNWRAP(
         renderer->queues,
         result
     );
 
+    result = new_gpu_allocator(phy_device, renderer->gpu);
+    RESULT_UNWRAP(
+        renderer->allocator,
+        result
+    );
+
     swapchain_params.phy_device = phy_device;
     swapchain_params.device = renderer->gpu;
+    swapchain_params.allocator = renderer->allocator;
     swapchain_params.image_extent.width = window_width;
     swapchain_params.image_extent.height = window_height;
     swapchain_params.families = families;
     swapchain_params.surface = renderer->surface;
+    swapchain_params.present_policy = params->present_policy;
 
     result = phy_device_surface_formats(phy_device, renderer->surface);
     RESULT_UNWRAP(
@@ -489,6 +552,7 @@ Result new_renderer(
     );
 
     swapchain_params.surface_format = select_surface_format(surface_formats);
+    renderer->swapchain_params = swapchain_params;
 
     result = new_swapchain(&swapchain_params);
     RESULT_UNWRAP(
@@ -502,44 +566,87 @@ Result new_renderer(
         result
     );
 
-    result = get_ovl_descriptor_pool_sizes(renderer->swapchain->image_count);
-    EXPECT_SUCCESS(result);
+    result = new_descr_allocator(renderer->gpu, frames_in_flight);
+    RESULT_UNWRAP(
+        renderer->pools.descr,
+        result
+    );
 
-    // TODO Combine different pool size arrays
-    DynArray descr_pool_sizes = result.object;
-
-    uint32_t max_sets_count = renderer->swapchain->image_count;
-
-    info(LOG_TARGET, LOG_GROUP(struct, "creating new renderer descriptor pool..."));
-    {
-        VkDescriptorPoolCreateInfo descr_pool_ci = {
-            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-            .maxSets = max_sets_count,
-        };
-        descr_pool_ci.poolSizeCount = descr_pool_sizes->count;
-        descr_pool_ci.pPoolSizes = descr_pool_sizes->data;
-
-        result.error = vkCreateDescriptorPool(
-            renderer->gpu,
-            &descr_pool_ci,
-            NULL,
-            &renderer->pools.descr
-        );
-        EXPECT_SUCCESS(result);
-    }
-    info(LOG_TARGET, LOG_GROUP(struct, "new renderer descriptor pool created sucessfully"));
+    // Every pipeline registers the transient sets of its frame
+    result = get_ovl_descriptor_pool_sizes(OVL_ATLAS_MAX_PAGES);
+    RESULT_UNWRAP(ovl_descr_pool_sizes, result);
+
+    register_descr_pool_sizes(renderer->pools.descr, ovl_descr_pool_sizes, OVL_ATLAS_MAX_PAGES);
 
     result = new_renderer_cmd_buffers(
         renderer->gpu,
         families,
         renderer->pools.cmd,
-        renderer->swapchain->image_count
+        frames_in_flight
     );
     RESULT_UNWRAP(
         renderer->buffers.cmd,
         result
     );
 
+    result = new_gpu_profiler(
+        phy_device,
+        renderer->gpu,
+        &phy_dev_descr->properties,
+        families->graphics_idx,
+        frames_in_flight
+    );
+    RESULT_UNWRAP(
+        renderer->gpu_profiler,
+        result
+    );
+
+    result = new_pipeline_stats_profiler(
+        renderer->gpu,
+        is_pipeline_stats_supported(&phy_dev_descr->features),
+        frames_in_flight
+    );
+    RESULT_UNWRAP(
+        renderer->pipeline_stats,
+        result
+    );
+
+    result = new_renderer_recorder(
+        renderer->gpu,
+        families->graphics_idx,
+        frames_in_flight,
+        params->record_thread_count
+    );
+    RESULT_UNWRAP(
+        renderer->recorder,
+        result
+    );
+
+    result = new_renderer_frames(
+        renderer->gpu,
+        renderer->buffers.cmd->graphics,
+        frames_in_flight,
+        renderer->swapchain->image_count
+    );
+    RESULT_UNWRAP(
+        renderer->frames,
+        result
+    );
+
+    result = new_staging_ring(
+        phy_device,
+        renderer->gpu,
+        renderer->allocator,
+        families,
+        renderer->buffers.cmd->transfer,
+        renderer->buffers.cmd->staging_fallback,
+        frames_in_flight
+    );
+    RESULT_UNWRAP(
+        renderer->staging,
+        result
+    );
+
     result = new_render_pass(
         renderer->gpu,
         swapchain_params.surface_format.format
@@ -549,18 +656,87 @@ Result new_renderer(
         result
     );
 
+    result = new_renderer_framebuffers(
+        renderer->gpu,
+        renderer->render_pass,
+        renderer->swapchain
+    );
+    RESULT_UNWRAP(
+        renderer->framebuffers,
+        result
+    );
+
+    result = new_pipeline_cache(
+        renderer->gpu,
+        &phy_dev_descr->properties,
+        params->pipeline_cache_path
+    );
+    RESULT_UNWRAP(
+        renderer->pipelines.cache,
+        result
+    );
+
+    if (phy_dev_descr->is_bindless_supported) {
+        result = new_bindless_table(renderer->gpu);
+        RESULT_UNWRAP(
+            renderer->pipelines.bindless,
+            result
+        );
+    }
+
+    pipelines_creation_start_ns = now_ns();
+    PROFILE_ZONE_BEGIN(new_renderer_pipelines);
+
     result = new_pipeline_ovl(
         renderer->gpu,
         renderer->render_pass,
-        &swapchain_params.image_extent,
+        renderer->pipelines.cache->vk_handle,
         renderer->swapchain->image_count,
-        NULL
+        NULL,
+        renderer->pipelines.bindless,
+        params->overlay_alpha_test
+    );
+    RESULT_UNWRAP(
+        renderer->pipelines.overlay,
+        result
+    );
+
+    renderer->pipelines.cache->stats.creation_time_ns = now_ns() - pipelines_creation_start_ns;
+    PROFILE_ZONE_END(new_renderer_pipelines);
+
+    result = new_overlay_atlas(
+        renderer->gpu,
+        renderer->allocator,
+        renderer->staging,
+        renderer->pools.descr,
+        families,
+        renderer->pipelines.overlay,
+        frames_in_flight
     );
     RESULT_UNWRAP(
+        renderer->pipelines.overlay_atlas,
+        result
+    );
+
+    result = new_overlay_draw_list(
+        renderer->allocator,
+        renderer->staging,
         renderer->pipelines.overlay,
+        renderer->pipelines.overlay_atlas,
+        frames_in_flight
+    );
+    RESULT_UNWRAP(
+        renderer->pipelines.overlay_draw_list,
         result
     );
 
+    info(
+        LOG_TARGET,
+        "renderer pipelines created in %.3f ms (%s start)",
+        NS_TO_MS(renderer->pipelines.cache->stats.creation_time_ns),
+        renderer->pipelines.cache->stats.is_warm ? "warm" : "cold"
+    );
+
     result.object = renderer;
 
     info(
@@ -569,8 +745,11 @@ Result new_renderer(
     );
 
     FN_EXIT(result, {
-        drop_renderer_queue_families(families);
         free(surface_formats);
+        free(ovl_descr_pool_sizes);
+        free(phy_dev_descr);
+
+        PROFILE_ZONE_END(new_renderer);
     });
 
     FN_FAILURE(result, {
@@ -578,6 +757,526 @@ Result new_renderer(
     });
 }
 
+// Every recording thread draws its share of the overlay batches
+void record_overlay_job(Handle ctx, VkCommandBuffer cmd_buffer, uint32_t thread_idx, uint32_t thread_count) {
+    Renderer renderer = ctx;
+    struct OverlayDrawList *draw_list = renderer->pipelines.overlay_draw_list;
+    VkExtent2D extent = renderer->swapchain->image_extent;
+    uint32_t first_batch = AS(AS(draw_list->batch_count, uint64_t) * thread_idx / thread_count, uint32_t);
+    uint32_t end_batch = AS(AS(draw_list->batch_count, uint64_t) * (thread_idx + 1) / thread_count, uint32_t);
+
+    VkViewport viewport = {
+        .minDepth = 0.0f,
+        .maxDepth = 1.0f
+    };
+    viewport.width = AS(extent.width, float);
+    viewport.height = AS(extent.height, float);
+
+    // The dynamic state is not inherited by the secondary command buffers
+    vkCmdSetViewport(cmd_buffer, 0, 1, &viewport);
+
+    cmd_draw_overlay_batches(
+        draw_list,
+        cmd_buffer,
+        renderer->frames->current_idx,
+        extent,
+        first_batch,
+        end_batch - first_batch
+    );
+}
+
+Result record_frame_cmd_buffer(
+    Renderer renderer,
+    VkCommandBuffer cmd_buffer,
+    uint32_t image_idx
+) {
+    ASSERT_NOT_NULL(renderer);
+    ASSERT_NOT_NULL(cmd_buffer);
+
+    Result result = { 0 };
+    VkClearValue clear_value = {
+        .color = { .float32 = { 0.0f, 0.0f, 0.0f, 1.0f } }
+    };
+    VkRenderPassBeginInfo render_pass_bi = {
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+        .clearValueCount = 1
+    };
+    VkCommandBufferInheritanceInfo inheritance = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .subpass = RENDER_SUBPASS_OVERLAY_IDX
+    };
+
+    render_pass_bi.renderPass = renderer->render_pass;
+    render_pass_bi.framebuffer = renderer->framebuffers->framebuffers[image_idx];
+    render_pass_bi.renderArea.extent = renderer->swapchain->image_extent;
+    render_pass_bi.pClearValues = &clear_value;
+
+    inheritance.renderPass = render_pass_bi.renderPass;
+    inheritance.framebuffer = render_pass_bi.framebuffer;
+
+    result = prepare_overlay_atlas_frame(renderer->pipelines.overlay_atlas);
+    EXPECT_SUCCESS(result);
+
+    // The batches are built once, the threads record the disjoint batch ranges
+    prepare_overlay_draw_list(renderer->pipelines.overlay_draw_list, renderer->frames->current_idx);
+
+    GPU_SCOPE_BEGIN(renderer->gpu_profiler, cmd_buffer, overlay_pass);
+
+    uint32_t stats_pass = begin_pipeline_stats_pass(
+        renderer->pipeline_stats,
+        cmd_buffer,
+        "overlay_pass",
+        AS(render_pass_bi.renderArea.extent.width, uint64_t) * render_pass_bi.renderArea.extent.height
+    );
+
+    // The secondary command buffers continue the active query
+    inheritance.pipelineStatistics = pipeline_stats_inheritance(renderer->pipeline_stats);
+
+    vkCmdBeginRenderPass(cmd_buffer, &render_pass_bi, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+    result = record_renderer_secondaries(
+        renderer->recorder,
+        renderer->frames->current_idx,
+        &inheritance,
+        record_overlay_job,
+        renderer,
+        cmd_buffer
+    );
+
+    vkCmdEndRenderPass(cmd_buffer);
+
+    end_pipeline_stats_pass(renderer->pipeline_stats, cmd_buffer, stats_pass);
+
+    GPU_SCOPE_END(renderer->gpu_profiler, cmd_buffer, overlay_pass);
+
+    clear_overlay_draw_list(renderer->pipelines.overlay_draw_list);
+
+    FN_FORCE_EXIT(result);
+}
+
+void deferred_drop_swapchain(Handle swapchain) {
+    drop_swapchain(swapchain);
+}
+
+void deferred_drop_framebuffers(Handle framebuffers) {
+    drop_renderer_framebuffers(framebuffers);
+}
+
+void deferred_drop_pipeline_ovl_rebuild(Handle rebuild) {
+    drop_pipeline_ovl_rebuild(rebuild);
+}
+
+// Must be called once the frame is going to be recorded (after a successful acquire):
+// the old pipeline is dropped when the submissions made so far are complete.
+Result swap_rebuilt_renderer_pipelines(Renderer renderer) {
+    Result result = { 0 };
+    struct PipelineOVLRebuild *rebuild = NULL;
+
+    // The room is reserved before taking the rebuild: the failure keeps it for the next frame
+    result = reserve_renderer_frame_drops(renderer->frames, 1);
+    EXPECT_SUCCESS(result);
+
+    rebuild = os_atomic_exchange_ptr(&renderer->pipelines.overlay_rebuild, NULL);
+
+    if (rebuild != NULL) {
+        swap_pipeline_ovl(renderer->pipelines.overlay, rebuild);
+        defer_renderer_frame_drop(renderer->frames, deferred_drop_pipeline_ovl_rebuild, rebuild);
+    }
+
+    FN_FORCE_EXIT(result);
+}
+
+// Must be called after the current frame slot fence is waited:
+// the retired objects are dropped when the submissions made so far are complete.
+Result recreate_renderer_swapchain(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    Result result = { 0 };
+    struct SwapchainCreateParams swapchain_params = renderer->swapchain_params;
+    struct Swapchain *swapchain = NULL;
+    struct RendererFramebuffers *framebuffers = NULL;
+
+    info(
+        LOG_TARGET,
+        "recreating renderer swapchain (new extent: %dx%d)...",
+        renderer->resize.extent.width,
+        renderer->resize.extent.height
+    );
+
+    // Both retired objects are deferred at once, after the new ones are created
+    result = reserve_renderer_frame_drops(renderer->frames, 2);
+    EXPECT_SUCCESS(result);
+
+    swapchain_params.image_extent = renderer->resize.extent;
+    swapchain_params.old_swapchain = renderer->swapchain->vk_handle;
+
+    result = new_swapchain(&swapchain_params);
+    RESULT_UNWRAP(swapchain, result);
+
+    result = new_renderer_framebuffers(
+        renderer->gpu,
+        renderer->render_pass,
+        swapchain
+    );
+    RESULT_UNWRAP(framebuffers, result);
+
+    result = reset_renderer_frame_images(renderer->frames, swapchain->image_count);
+    EXPECT_SUCCESS(result);
+
+    // Framebuffers reference the swapchain image views, so they are dropped first
+    defer_renderer_frame_drop(renderer->frames, deferred_drop_framebuffers, renderer->framebuffers);
+    defer_renderer_frame_drop(renderer->frames, deferred_drop_swapchain, renderer->swapchain);
+
+    renderer->swapchain = swapchain;
+    renderer->framebuffers = framebuffers;
+    renderer->swapchain_params.image_extent = swapchain->image_extent;
+    renderer->resize.is_pending = false;
+
+    info(LOG_TARGET, "renderer swapchain recreated successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_renderer_framebuffers(framebuffers);
+        drop_swapchain(swapchain);
+    });
+}
+
+// The surface has changed without a resize request (e.g. its format or transform)
+void request_swapchain_recreation(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    if (!renderer->resize.is_pending) {
+        renderer->resize.is_pending = true;
+        renderer->resize.extent = renderer->swapchain->image_extent;
+    }
+}
+
+void renderer_resize(Renderer renderer, uint16_t width, uint16_t height) {
+    ASSERT_NOT_NULL(renderer);
+
+    renderer->resize.is_pending = true;
+    renderer->resize.extent.width = width;
+    renderer->resize.extent.height = height;
+
+    trace(LOG_TARGET, LOG_GROUP(struct, "resize requested: %dx%d"), width, height);
+}
+
+Result renderer_draw_frame(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    Result result = { 0 };
+    struct RendererFrame *frame = current_renderer_frame(renderer->frames);
+    uint32_t image_idx = 0;
+    bool is_offscreen = is_offscreen_swapchain(renderer->swapchain);
+    bool is_suboptimal = false;
+    VkSemaphore wait_semaphores[2] = { VK_NULL_HANDLE };
+    VkPipelineStageFlags wait_stages[2] = { 0 };
+    uint32_t wait_count = 0;
+    VkSemaphore uploaded = VK_NULL_HANDLE;
+    VkPipelineStageFlags upload_wait_stage = 0;
+    VkCommandBufferBeginInfo cmd_buffer_bi = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+    VkSubmitInfo submit_info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1
+    };
+
+    // Blocks only if the GPU is still processing the frame
+    // submitted `frames_in_flight` frames ago
+    result = wait_renderer_frame(renderer->frames);
+    EXPECT_SUCCESS(result);
+
+    // The transient sets of the previous frame in the slot are not used anymore
+    result = begin_descr_allocator_frame(renderer->pools.descr, renderer->frames->current_idx);
+    EXPECT_SUCCESS(result);
+
+    if (renderer->resize.is_pending) {
+        // The window is minimized, there is nothing to draw into
+        if (renderer->resize.extent.width == 0 || renderer->resize.extent.height == 0)
+            goto exit;
+
+        result = recreate_renderer_swapchain(renderer);
+        EXPECT_SUCCESS(result);
+    }
+
+    VkResult acquire_result = AS(swapchain_acquire_next_image(
+        renderer->swapchain,
+        frame->image_available,
+        &image_idx
+    ).error, VkResult);
+
+    if (acquire_result == VK_ERROR_OUT_OF_DATE_KHR) {
+        // The frame slot fence is still signaled, the frame is retried next time
+        request_swapchain_recreation(renderer);
+        goto exit;
+    }
+
+    // The image is acquired: it is rendered and presented,
+    // the swapchain is recreated after the present
+    if (acquire_result == VK_SUBOPTIMAL_KHR) {
+        is_suboptimal = true;
+        acquire_result = VK_SUCCESS;
+    }
+
+    result.error = VK_RESULT(acquire_result);
+    EXPECT_SUCCESS(result);
+
+    result = bind_renderer_frame_image(renderer->frames, image_idx);
+    EXPECT_SUCCESS(result);
+
+    result = swap_rebuilt_renderer_pipelines(renderer);
+    EXPECT_SUCCESS(result);
+
+    // All the uploads of the frame go as a single batch
+    result = submit_staging_ring(
+        renderer->staging,
+        renderer->queues->transfer,
+        renderer->queues->graphics,
+        &uploaded,
+        &upload_wait_stage
+    );
+    EXPECT_SUCCESS(result);
+
+    result.error = VK_RESULT(vkResetCommandBuffer(frame->cmd_buffer, 0));
+    EXPECT_SUCCESS(result);
+
+    result.error = VK_RESULT(vkBeginCommandBuffer(frame->cmd_buffer, &cmd_buffer_bi));
+    EXPECT_SUCCESS(result);
+
+    result = begin_gpu_profiler_frame(renderer->gpu_profiler, frame->cmd_buffer, renderer->frames->current_idx);
+    EXPECT_SUCCESS(result);
+
+    result = begin_pipeline_stats_frame(renderer->pipeline_stats, frame->cmd_buffer, renderer->frames->current_idx);
+    EXPECT_SUCCESS(result);
+
+    GPU_SCOPE_BEGIN(renderer->gpu_profiler, frame->cmd_buffer, frame);
+
+    cmd_acquire_staging_uploads(renderer->staging, frame->cmd_buffer);
+
+    result = record_frame_cmd_buffer(renderer, frame->cmd_buffer, image_idx);
+    EXPECT_SUCCESS(result);
+
+    GPU_SCOPE_END(renderer->gpu_profiler, frame->cmd_buffer, frame);
+
+    result.error = VK_RESULT(vkEndCommandBuffer(frame->cmd_buffer));
+    EXPECT_SUCCESS(result);
+
+    submit_info.pCommandBuffers = &frame->cmd_buffer;
+
+    // The offscreen swapchain neither signals the acquire semaphore
+    // nor waits for the present one
+    if (!is_offscreen) {
+        wait_semaphores[wait_count] = frame->image_available;
+        wait_stages[wait_count] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        wait_count += 1;
+
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &frame->render_finished;
+    }
+
+    if (uploaded != VK_NULL_HANDLE) {
+        wait_semaphores[wait_count] = uploaded;
+        wait_stages[wait_count] = upload_wait_stage;
+        wait_count += 1;
+    }
+
+    submit_info.waitSemaphoreCount = wait_count;
+    submit_info.pWaitSemaphores = wait_semaphores;
+    submit_info.pWaitDstStageMask = wait_stages;
+
+    result = submit_renderer_frame(renderer->frames, renderer->queues->graphics, &submit_info);
+    EXPECT_SUCCESS(result);
+
+    complete_overlay_atlas_frame(renderer->pipelines.overlay_atlas);
+    complete_gpu_profiler_frame(renderer->gpu_profiler);
+    complete_pipeline_stats_frame(renderer->pipeline_stats);
+
+    VkResult present_result = AS(swapchain_present(
+        renderer->swapchain,
+        renderer->queues->present,
+        frame->render_finished,
+        image_idx
+    ).error, VkResult);
+
+    advance_renderer_frame(renderer->frames);
+
+    if (present_result == VK_ERROR_OUT_OF_DATE_KHR) {
+        request_swapchain_recreation(renderer);
+        goto exit;
+    }
+
+    // E.g. the surface is rotated or rescaled without a resize
+    if (present_result == VK_SUBOPTIMAL_KHR || is_suboptimal) {
+        request_swapchain_recreation(renderer);
+        present_result = VK_SUCCESS;
+    }
+
+    result.error = VK_RESULT(present_result);
+    EXPECT_SUCCESS(result);
+
+    // The quads of a skipped frame are not carried over to the next one
+    FN_FORCE_EXIT(result, {
+        clear_overlay_draw_list(renderer->pipelines.overlay_draw_list);
+    });
+}
+
+void renderer_draw_overlay(Renderer renderer, const OverlayQuad *quads, uint32_t count) {
+    ASSERT_NOT_NULL(renderer);
+
+    overlay_draw_list_push(renderer->pipelines.overlay_draw_list, quads, count);
+}
+
+Result renderer_add_overlay_image(
+    Renderer renderer,
+    uint32_t width,
+    uint32_t height,
+    const void *pixels,
+    uint32_t *image_id
+) {
+    ASSERT_NOT_NULL(renderer);
+
+    return overlay_atlas_add_image(renderer->pipelines.overlay_atlas, width, height, pixels, image_id);
+}
+
+Result renderer_update_overlay_image(
+    Renderer renderer,
+    uint32_t image_id,
+    int32_t x,
+    int32_t y,
+    uint32_t width,
+    uint32_t height,
+    const void *pixels
+) {
+    ASSERT_NOT_NULL(renderer);
+
+    VkRect2D region = {
+        .offset = { .x = x, .y = y },
+        .extent = { .width = width, .height = height }
+    };
+
+    return overlay_atlas_update_image(renderer->pipelines.overlay_atlas, image_id, &region, pixels);
+}
+
+void renderer_remove_overlay_image(Renderer renderer, uint32_t image_id) {
+    ASSERT_NOT_NULL(renderer);
+
+    overlay_atlas_remove_image(renderer->pipelines.overlay_atlas, image_id);
+}
+
+bool renderer_is_overlay_image_resident(Renderer renderer, uint32_t image_id) {
+    ASSERT_NOT_NULL(renderer);
+
+    return is_overlay_image_resident(renderer->pipelines.overlay_atlas, image_id);
+}
+
+RendererFrameStats renderer_frame_stats(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return renderer->frames->stats;
+}
+
+SwapchainInfo renderer_swapchain_info(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return swapchain_info(renderer->swapchain);
+}
+
+PipelineCacheStats renderer_pipeline_cache_stats(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return renderer->pipelines.cache->stats;
+}
+
+RendererUploadStats renderer_upload_stats(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return renderer->staging->stats;
+}
+
+OverlayDrawStats renderer_overlay_stats(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return renderer->pipelines.overlay_draw_list->stats;
+}
+
+OverlayAtlasStats renderer_overlay_atlas_stats(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return renderer->pipelines.overlay_atlas->stats;
+}
+
+DescrAllocatorStats renderer_descr_allocator_stats(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return renderer->pools.descr->stats;
+}
+
+GpuProfilerStats renderer_gpu_profiler_stats(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return renderer->gpu_profiler->stats;
+}
+
+void renderer_set_pipeline_stats_enabled(Renderer renderer, bool is_enabled) {
+    ASSERT_NOT_NULL(renderer);
+
+    set_pipeline_stats_enabled(renderer->pipeline_stats, is_enabled);
+}
+
+PipelineStatsFrame renderer_pipeline_stats(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return renderer->pipeline_stats->stats;
+}
+
+Result renderer_rebuild_overlay_pipeline(
+    Renderer renderer,
+    const uint32_t *vertex_code,
+    size_t vertex_code_size,
+    const uint32_t *fragment_code,
+    size_t fragment_code_size
+) {
+    ASSERT_NOT_NULL(renderer);
+
+    Result result = { 0 };
+    struct PipelineOVLRebuild *rebuild = NULL;
+
+    result = new_pipeline_ovl_rebuild(
+        renderer->pipelines.overlay,
+        vertex_code,
+        vertex_code_size,
+        fragment_code,
+        fragment_code_size
+    );
+    RESULT_UNWRAP(rebuild, result);
+
+    // The replaced rebuild was never swapped in, so the GPU hasn't used it
+    drop_pipeline_ovl_rebuild(os_atomic_exchange_ptr(&renderer->pipelines.overlay_rebuild, rebuild));
+
+    FN_FORCE_EXIT(result);
+}
+
+uint32_t renderer_overlay_fragment_variant(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return pipeline_ovl_fragment_variant(renderer->pipelines.overlay);
+}
+
+bool renderer_is_bindless(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return renderer->pipelines.bindless != NULL;
+}
+
+GpuMemoryStats renderer_gpu_memory_stats(Renderer renderer) {
+    ASSERT_NOT_NULL(renderer);
+
+    return gpu_memory_stats(renderer->allocator);
+}
+
 void drop_renderer(Renderer renderer) {
     if (renderer == NULL)
         goto exit;
@@ -586,8 +1285,26 @@ void drop_renderer(Renderer renderer) {
     if (result != VK_SUCCESS)
         error(LOG_TARGET, "unable to wait device idle");
 
+    drop_overlay_draw_list(renderer->pipelines.overlay_draw_list);
+
+    drop_overlay_atlas(renderer->pipelines.overlay_atlas);
+
+    drop_pipeline_ovl_rebuild(renderer->pipelines.overlay_rebuild);
+
     drop_pipeline_ovl(renderer->pipelines.overlay);
 
+    drop_bindless_table(renderer->pipelines.bindless);
+
+    if (renderer->pipelines.cache != NULL) {
+        Result store_result = store_pipeline_cache(renderer->pipelines.cache);
+        if (store_result.error != SUCCESS)
+            error(LOG_TARGET, "unable to store pipeline cache");
+    }
+
+    drop_pipeline_cache(renderer->pipelines.cache);
+
+    drop_renderer_framebuffers(renderer->framebuffers);
+
     vkDestroyRenderPass(
         renderer->gpu,
         renderer->render_pass,
@@ -595,12 +1312,17 @@ void drop_renderer(Renderer renderer) {
     );
     debug(LOG_TARGET, LOG_GROUP(struct, "drop renderer render pass"));
 
-    vkDestroyDescriptorPool(
-        renderer->gpu,
-        renderer->pools.descr,
-        NULL
-    );
-    debug(LOG_TARGET, LOG_GROUP(struct, "drop renderer descriptor pool"));
+    drop_descr_allocator(renderer->pools.descr);
+
+    drop_staging_ring(renderer->staging);
+
+    drop_renderer_recorder(renderer->recorder);
+
+    drop_gpu_profiler(renderer->gpu_profiler);
+
+    drop_pipeline_stats_profiler(renderer->pipeline_stats);
+
+    drop_renderer_frames(renderer->frames);
 
     drop_renderer_cmd_buffers(renderer->buffers.cmd);
 
@@ -608,11 +1330,17 @@ void drop_renderer(Renderer renderer) {
 
     drop_swapchain(renderer->swapchain);
 
+    drop_gpu_allocator(renderer->allocator);
+
     vkDestroyDevice(renderer->gpu, NULL);
     debug(LOG_TARGET, LOG_GROUP(struct, "drop GPU object"));
 
+    drop_renderer_queues(renderer->queues);
+
     drop_surface(renderer->vk_instance->vk_handle, renderer->surface);
 
+    drop_renderer_queue_families(renderer->families);
+
     free(renderer);
 
 exit:
@@ -2,17 +2,31 @@
 #define ___APRIORI2_GRAPHICS_RENDERER_IMPL_H___
 
 #include <vulkan/vulkan.h>
+#include <stdbool.h>
 #include "ffi/core/vulkan_instance/mod.h"
 #include "ffi/graphics/swapchain.h"
 #include "ffi/graphics/pipeline/overlay/mod.h"
+#include "ffi/graphics/pipeline/cache.h"
+#include "ffi/graphics/pipeline/bindless.h"
+#include "ffi/graphics/pipeline/overlay/atlas.h"
+#include "ffi/graphics/pipeline/overlay/draw_list.h"
+#include "ffi/graphics/memory/allocator.h"
+#include "ffi/graphics/profiler/gpu_profiler.h"
+#include "ffi/graphics/profiler/pipeline_stats.h"
 
 #include "queues.h"
 #include "cmd_pools.h"
+#include "descr_allocator.h"
 #include "cmd_buffers.h"
+#include "recorder.h"
+#include "frames.h"
+#include "framebuffers.h"
+#include "ownership.h"
+#include "staging.h"
 
 struct RendererPools {
     struct RendererCmdPools *cmd;
-    VkDescriptorPool descr;
+    struct DescrAllocator *descr;
 };
 
 struct RendererBuffers {
@@ -20,18 +34,47 @@ struct RendererBuffers {
 };
 
 struct RendererPipelines {
+    struct PipelineCache *cache;
+
+    // NULL if the bindless mode is disabled or not supported
+    struct BindlessTable *bindless;
+
     struct PipelineOVL *overlay;
+
+    // The `PipelineOVLRebuild` waiting for the next frame boundary (or NULL),
+    // published by `renderer_rebuild_overlay_pipeline` from any thread
+    Handle volatile overlay_rebuild;
+
+    struct OverlayAtlas *overlay_atlas;
+    struct OverlayDrawList *overlay_draw_list;
+};
+
+// Resize requests are collapsed into a single swapchain recreation
+// performed at the beginning of the next frame
+struct RendererResize {
+    bool is_pending;
+    VkExtent2D extent;
 };
 
 struct RendererFFI {
     VulkanInstance vk_instance;
     VkDevice gpu;
     VkSurfaceKHR surface;
+    struct RendererQueueFamilies *families;
+    struct GpuAllocator *allocator;
+    struct SwapchainCreateParams swapchain_params;
     struct Swapchain *swapchain;
+    struct RendererResize resize;
     struct RendererQueues *queues;
     struct RendererPools pools;
     struct RendererBuffers buffers;
     VkRenderPass render_pass;
+    struct RendererFramebuffers *framebuffers;
+    struct RendererFrames *frames;
+    struct RendererRecorder *recorder;
+    struct GpuProfiler *gpu_profiler;
+    struct PipelineStatsProfiler *pipeline_stats;
+    struct StagingRing *staging;
 
     struct RendererPipelines pipelines;
 };
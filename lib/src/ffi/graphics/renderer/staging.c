@@ -0,0 +1,798 @@
+#include <string.h>
+
+#include "staging.h"
+
+#include "ffi/util/mod.h"
+#include "ffi/core/log.h"
+
+#define LOG_TARGET LOG_SUB_TARGET( \
+    LOG_STRUCT_TARGET(Renderer), LOG_STRUCT_TARGET(StagingRing) \
+)
+
+Result transfer_image_granularity(
+    VkPhysicalDevice phy_device,
+    uint32_t queue_family_idx,
+    VkExtent3D *granularity
+) {
+    Result result = { 0 };
+    VkQueueFamilyProperties *family_props = NULL;
+    uint32_t family_count = 0;
+
+    vkGetPhysicalDeviceQueueFamilyProperties(phy_device, &family_count, NULL);
+
+    family_props = ALLOC_ARRAY_UNINIT(result, VkQueueFamilyProperties, family_count);
+
+    vkGetPhysicalDeviceQueueFamilyProperties(phy_device, &family_count, family_props);
+
+    assert(queue_family_idx < family_count && "queue family index is out of range");
+    *granularity = family_props[queue_family_idx].minImageTransferGranularity;
+
+    FN_FORCE_EXIT(result, {
+        free(family_props);
+    });
+}
+
+Result new_staging_ring(
+    VkPhysicalDevice phy_device,
+    VkDevice device,
+    struct GpuAllocator *allocator,
+    struct RendererQueueFamilies *families,
+    VkCommandBuffer *transfer_cmd_buffers,
+    VkCommandBuffer *fallback_cmd_buffers,
+    uint32_t batch_count
+) {
+    ASSERT_NOT_NULL(phy_device);
+    ASSERT_NOT_NULL(device);
+    ASSERT_NOT_NULL(allocator);
+    ASSERT_NOT_NULL(families);
+    ASSERT_NOT_NULL(transfer_cmd_buffers);
+    ASSERT_NOT_NULL(fallback_cmd_buffers);
+
+    Result result = { 0 };
+    uint32_t buffer_families[] = { families->transfer_idx, families->graphics_idx };
+    VkBufferCreateInfo buffer_ci = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = STAGING_RING_SIZE,
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+    VkSemaphoreCreateInfo semaphore_ci = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
+    };
+    VkFenceCreateInfo fence_ci = {
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
+    };
+
+    info(LOG_TARGET, "creating new staging ring...");
+
+    struct StagingRing *ring = ALLOC(result, struct StagingRing);
+
+    ring->device = device;
+    ring->allocator = allocator;
+    ring->families = families;
+    ring->size = STAGING_RING_SIZE;
+    ring->stats.ring_size = STAGING_RING_SIZE;
+
+    result = transfer_image_granularity(phy_device, families->transfer_idx, &ring->transfer_granularity);
+    EXPECT_SUCCESS(result);
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "transfer image granularity: %dx%dx%d"),
+        ring->transfer_granularity.width,
+        ring->transfer_granularity.height,
+        ring->transfer_granularity.depth
+    );
+
+    // Both queues read the ring: the fallback batches are copied on the graphics one
+    if (families->transfer_idx != families->graphics_idx) {
+        buffer_ci.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        buffer_ci.queueFamilyIndexCount = STATIC_ARRAY_SIZE(buffer_families);
+        buffer_ci.pQueueFamilyIndices = buffer_families;
+    }
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "ring size: %d KiB, batches: %d"),
+        AS(STAGING_RING_SIZE >> 10, uint32_t),
+        batch_count
+    );
+
+    result = gpu_alloc_buffer(
+        allocator,
+        &buffer_ci,
+        GPU_MEMORY_USAGE_HOST_UPLOAD,
+        &ring->buffer,
+        &ring->allocation
+    );
+    EXPECT_SUCCESS(result);
+
+    ASSERT_NOT_NULL(ring->allocation.mapped);
+
+    ring->buffer_copies = ALLOC_ARRAY(result, struct StagingBufferCopy, MAX_STAGING_BUFFER_COPIES);
+    ring->image_copies = ALLOC_ARRAY(result, struct StagingImageCopy, MAX_STAGING_IMAGE_COPIES);
+
+    ring->batches = ALLOC_ARRAY(result, struct StagingBatch, batch_count);
+    ring->batch_count = batch_count;
+
+    for (uint32_t i = 0; i < batch_count; ++i) {
+        struct StagingBatch *batch = &ring->batches[i];
+
+        batch->cmd_buffer = transfer_cmd_buffers[i];
+        batch->fallback_cmd_buffer = fallback_cmd_buffers[i];
+
+        result.error = VK_RESULT(vkCreateFence(device, &fence_ci, NULL, &batch->fence));
+        EXPECT_SUCCESS(result);
+
+        result.error = VK_RESULT(vkCreateSemaphore(device, &semaphore_ci, NULL, &batch->uploaded));
+        EXPECT_SUCCESS(result);
+    }
+
+    result.object = ring;
+    info(LOG_TARGET, "new staging ring created successfully");
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        drop_staging_ring(ring);
+    });
+}
+
+void complete_staging_batch(struct StagingRing *ring, struct StagingBatch *batch) {
+    ring->tail = batch->end;
+    batch->is_pending = false;
+}
+
+// Moves the tail past the completed batches (in the submission order).
+// Blocks on the oldest pending batch if `is_blocking` and nothing was completed.
+Result reclaim_staging_ring(struct StagingRing *ring, bool is_blocking, bool *is_reclaimed) {
+    Result result = { 0 };
+
+    *is_reclaimed = false;
+
+    // The current batch is the oldest one: it was submitted `batch_count` batches ago
+    for (uint32_t i = 0; i < ring->batch_count; ++i) {
+        struct StagingBatch *batch = &ring->batches[(ring->current_batch_idx + i) % ring->batch_count];
+
+        if (!batch->is_pending)
+            continue;
+
+        VkResult status = vkGetFenceStatus(ring->device, batch->fence);
+
+        if (status == VK_NOT_READY) {
+            if (!is_blocking || *is_reclaimed)
+                break;
+
+            ring->stats.stall_count += 1;
+
+            result.error = VK_RESULT(vkWaitForFences(ring->device, 1, &batch->fence, VK_TRUE, UINT64_MAX));
+            EXPECT_SUCCESS(result);
+        } else {
+            result.error = VK_RESULT(status);
+            EXPECT_SUCCESS(result);
+        }
+
+        complete_staging_batch(ring, batch);
+        *is_reclaimed = true;
+    }
+
+    FN_FORCE_EXIT(result);
+}
+
+Result staging_ring_alloc(struct StagingRing *ring, VkDeviceSize size, VkDeviceSize *offset) {
+    ASSERT_NOT_NULL(ring);
+    ASSERT_NOT_NULL(offset);
+    assert(!ring->is_submitted && "the submitted staging batch is not acquired yet");
+
+    Result result = { 0 };
+    bool is_reclaimed = false;
+
+    size = (size + STAGING_ALIGNMENT - 1) & ~(AS(STAGING_ALIGNMENT, VkDeviceSize) - 1);
+
+    if (size > ring->size) {
+        result.error = STAGING_RING_OVERFLOW;
+        EXPECT_SUCCESS(result);
+    }
+
+    for (;;) {
+        uint64_t ring_offset = ring->head % ring->size;
+
+        // The data is never split by the end of the ring
+        uint64_t padding = ring_offset + size > ring->size
+            ? ring->size - ring_offset
+            : 0;
+
+        if (ring->head + padding + size - ring->tail <= ring->size) {
+            ring->head += padding;
+            *offset = ring->head % ring->size;
+            ring->head += size;
+            break;
+        }
+
+        result = reclaim_staging_ring(ring, false, &is_reclaimed);
+        EXPECT_SUCCESS(result);
+
+        if (is_reclaimed)
+            continue;
+
+        result = reclaim_staging_ring(ring, true, &is_reclaimed);
+        EXPECT_SUCCESS(result);
+
+        // The not submitted uploads of the current frame fill the ring
+        if (!is_reclaimed) {
+            result.error = STAGING_RING_OVERFLOW;
+            EXPECT_SUCCESS(result);
+        }
+    }
+
+    ring->pending_bytes += size;
+    result.object = AS(ring->allocation.mapped, Byte*) + *offset;
+
+    FN_FORCE_EXIT(result);
+}
+
+struct QueueOwnershipTransfer staging_dst_transfer(struct StagingRing *ring, const struct StagingDst *dst) {
+    struct QueueOwnershipTransfer transfer = upload_ownership_transfer(
+        ring->families,
+        dst->stage,
+        dst->access
+    );
+
+    // Concurrent resources are accessible from both families as is,
+    // the fallback batch is copied by the graphics family itself
+    if (dst->sharing_mode == VK_SHARING_MODE_CONCURRENT || ring->is_fallback)
+        transfer.src_family = transfer.dst_family;
+
+    return transfer;
+}
+
+Result staging_upload_buffer(
+    struct StagingRing *ring,
+    const void *data,
+    VkDeviceSize size,
+    VkBuffer buffer,
+    VkDeviceSize buffer_offset,
+    const struct StagingDst *dst
+) {
+    ASSERT_NOT_NULL(ring);
+    ASSERT_NOT_NULL(data);
+    ASSERT_NOT_NULL(buffer);
+    ASSERT_NOT_NULL(dst);
+
+    Result result = { 0 };
+    VkDeviceSize offset = 0;
+    Byte *mapped = NULL;
+
+    if (ring->buffer_copy_count == MAX_STAGING_BUFFER_COPIES) {
+        result.error = STAGING_RING_OVERFLOW;
+        EXPECT_SUCCESS(result);
+    }
+
+    result = staging_ring_alloc(ring, size, &offset);
+    RESULT_UNWRAP(mapped, result);
+
+    memcpy(mapped, data, size);
+
+    struct StagingBufferCopy *copy = &ring->buffer_copies[ring->buffer_copy_count];
+    copy->copy_idx = ring->buffer_copy_count;
+    copy->buffer = buffer;
+    copy->region.srcOffset = offset;
+    copy->region.dstOffset = buffer_offset;
+    copy->region.size = size;
+    copy->dst = *dst;
+
+    ring->buffer_copy_count += 1;
+    ring->dst_stages |= dst->stage;
+    ring->is_fallback |= dst->is_read_in_flight;
+
+    FN_FORCE_EXIT(result);
+}
+
+bool is_granularity_aligned(int32_t offset, uint32_t extent, uint32_t granularity) {
+    return granularity != 0
+        && AS(offset, uint32_t) % granularity == 0
+        && extent % granularity == 0;
+}
+
+// The image extent is unknown here: the copies reaching the image edge
+// with an unaligned extent fall back as well
+bool is_transfer_granularity_aligned(struct StagingRing *ring, const VkBufferImageCopy *region) {
+    const VkExtent3D *granularity = &ring->transfer_granularity;
+
+    if (ring->families->transfer_idx == ring->families->graphics_idx)
+        return true;
+
+    return is_granularity_aligned(region->imageOffset.x, region->imageExtent.width, granularity->width)
+        && is_granularity_aligned(region->imageOffset.y, region->imageExtent.height, granularity->height)
+        && is_granularity_aligned(region->imageOffset.z, region->imageExtent.depth, granularity->depth);
+}
+
+Result staging_upload_image(
+    struct StagingRing *ring,
+    const void *data,
+    VkDeviceSize size,
+    VkImage image,
+    const VkBufferImageCopy *region,
+    VkImageLayout old_layout,
+    VkImageLayout new_layout,
+    const struct StagingDst *dst
+) {
+    ASSERT_NOT_NULL(ring);
+    ASSERT_NOT_NULL(data);
+    ASSERT_NOT_NULL(image);
+    ASSERT_NOT_NULL(region);
+    ASSERT_NOT_NULL(dst);
+
+    Result result = { 0 };
+    VkDeviceSize offset = 0;
+    Byte *mapped = NULL;
+
+    if (ring->image_copy_count == MAX_STAGING_IMAGE_COPIES) {
+        result.error = STAGING_RING_OVERFLOW;
+        EXPECT_SUCCESS(result);
+    }
+
+    result = staging_ring_alloc(ring, size, &offset);
+    RESULT_UNWRAP(mapped, result);
+
+    memcpy(mapped, data, size);
+
+    struct StagingImageCopy *copy = &ring->image_copies[ring->image_copy_count];
+    copy->copy_idx = ring->image_copy_count;
+    copy->image = image;
+    copy->region = *region;
+    copy->region.bufferOffset = offset;
+    copy->subresource_range.aspectMask = region->imageSubresource.aspectMask;
+    copy->subresource_range.baseMipLevel = region->imageSubresource.mipLevel;
+    copy->subresource_range.levelCount = 1;
+    copy->subresource_range.baseArrayLayer = region->imageSubresource.baseArrayLayer;
+    copy->subresource_range.layerCount = region->imageSubresource.layerCount;
+    copy->old_layout = old_layout;
+    copy->new_layout = new_layout;
+    copy->dst = *dst;
+
+    ring->image_copy_count += 1;
+    ring->dst_stages |= dst->stage;
+    ring->is_fallback |= dst->is_read_in_flight || !is_transfer_granularity_aligned(ring, region);
+
+    FN_FORCE_EXIT(result);
+}
+
+#define COMPARE_STAGING_COPY_FIELD(field) \
+    if (a->field != b->field) \
+        return a->field < b->field ? -1 : 1
+
+int compare_staging_buffer_copies(const void *lhs, const void *rhs) {
+    const struct StagingBufferCopy *a = lhs;
+    const struct StagingBufferCopy *b = rhs;
+
+    COMPARE_STAGING_COPY_FIELD(buffer);
+
+    // Keeps the upload order of the same buffer copies (qsort is not stable)
+    COMPARE_STAGING_COPY_FIELD(copy_idx);
+
+    return 0;
+}
+
+bool is_same_image_subresource(const struct StagingImageCopy *a, const struct StagingImageCopy *b) {
+    return a->image == b->image
+        && a->subresource_range.aspectMask == b->subresource_range.aspectMask
+        && a->subresource_range.baseMipLevel == b->subresource_range.baseMipLevel
+        && a->subresource_range.baseArrayLayer == b->subresource_range.baseArrayLayer
+        && a->subresource_range.layerCount == b->subresource_range.layerCount;
+}
+
+int compare_staging_image_copies(const void *lhs, const void *rhs) {
+    const struct StagingImageCopy *a = lhs;
+    const struct StagingImageCopy *b = rhs;
+
+    COMPARE_STAGING_COPY_FIELD(image);
+    COMPARE_STAGING_COPY_FIELD(subresource_range.aspectMask);
+    COMPARE_STAGING_COPY_FIELD(subresource_range.baseMipLevel);
+    COMPARE_STAGING_COPY_FIELD(subresource_range.baseArrayLayer);
+    COMPARE_STAGING_COPY_FIELD(subresource_range.layerCount);
+
+    // Keeps the upload order of the same subresource copies (qsort is not stable)
+    COMPARE_STAGING_COPY_FIELD(copy_idx);
+
+    return 0;
+}
+
+#undef COMPARE_STAGING_COPY_FIELD
+
+bool is_buffer_copy_overlapping(const VkBufferCopy *a, const VkBufferCopy *b) {
+    return a->dstOffset < b->dstOffset + b->size
+        && b->dstOffset < a->dstOffset + a->size;
+}
+
+bool is_image_copy_overlapping(const VkBufferImageCopy *a, const VkBufferImageCopy *b) {
+    return a->imageOffset.x < b->imageOffset.x + AS(b->imageExtent.width, int64_t)
+        && b->imageOffset.x < a->imageOffset.x + AS(a->imageExtent.width, int64_t)
+        && a->imageOffset.y < b->imageOffset.y + AS(b->imageExtent.height, int64_t)
+        && b->imageOffset.y < a->imageOffset.y + AS(a->imageExtent.height, int64_t)
+        && a->imageOffset.z < b->imageOffset.z + AS(b->imageExtent.depth, int64_t)
+        && b->imageOffset.z < a->imageOffset.z + AS(a->imageExtent.depth, int64_t);
+}
+
+VkImageLayout staging_copy_layout(const struct StagingImageCopy *copy) {
+    return copy->new_layout == VK_IMAGE_LAYOUT_GENERAL
+        ? VK_IMAGE_LAYOUT_GENERAL
+        : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+}
+
+// The later copy of the same destination writes over the earlier one
+void cmd_staging_write_after_write_barrier(
+    VkCommandBuffer cmd_buffer,
+    const VkBufferMemoryBarrier *buffer_barrier,
+    const VkImageMemoryBarrier *image_barrier
+) {
+    vkCmdPipelineBarrier(
+        cmd_buffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0, NULL,
+        buffer_barrier != NULL ? 1 : 0, buffer_barrier,
+        image_barrier != NULL ? 1 : 0, image_barrier
+    );
+}
+
+// Transitions the images into the copy layout.
+// The destinations read by the frames in flight (the fallback batch only)
+// are written after these reads complete.
+void cmd_prepare_staging_dsts(struct StagingRing *ring, VkCommandBuffer cmd_buffer) {
+    VkBufferMemoryBarrier buffer_barriers[MAX_STAGING_BUFFER_COPIES];
+    VkImageMemoryBarrier image_barriers[MAX_STAGING_IMAGE_COPIES];
+    uint32_t buffer_barrier_count = 0;
+    uint32_t image_barrier_count = 0;
+    VkImageMemoryBarrier *image_barrier = NULL;
+    VkPipelineStageFlags src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+
+    for (uint32_t i = 0; i < ring->buffer_copy_count; ++i) {
+        struct StagingBufferCopy *copy = &ring->buffer_copies[i];
+
+        if (!copy->dst.is_read_in_flight)
+            continue;
+
+        src_stages |= copy->dst.stage;
+
+        buffer_barriers[buffer_barrier_count++] = (VkBufferMemoryBarrier) {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask = copy->dst.access,
+            .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = copy->buffer,
+            .offset = copy->region.dstOffset,
+            .size = copy->region.size
+        };
+    }
+
+    for (uint32_t i = 0; i < ring->image_copy_count; ++i) {
+        struct StagingImageCopy *copy = &ring->image_copies[i];
+
+        if (i == 0 || !is_same_image_subresource(copy, &ring->image_copies[i - 1])) {
+            image_barrier = &image_barriers[image_barrier_count++];
+
+            *image_barrier = (VkImageMemoryBarrier) {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = 0,
+                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .oldLayout = copy->old_layout,
+                .newLayout = staging_copy_layout(copy),
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = copy->image,
+                .subresourceRange = copy->subresource_range
+            };
+        }
+
+        if (!copy->dst.is_read_in_flight)
+            continue;
+
+        src_stages |= copy->dst.stage;
+        image_barrier->srcAccessMask |= copy->dst.access;
+    }
+
+    if (buffer_barrier_count == 0 && image_barrier_count == 0)
+        return;
+
+    vkCmdPipelineBarrier(
+        cmd_buffer,
+        src_stages,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0, NULL,
+        buffer_barrier_count, buffer_barriers,
+        image_barrier_count, image_barriers
+    );
+}
+
+// The copies are sorted, so every destination forms a single run:
+// one copy command per destination (split where the copies overlap) and one barrier per destination
+void record_staging_copies(struct StagingRing *ring, VkCommandBuffer cmd_buffer) {
+    VkBufferCopy regions[MAX_STAGING_BUFFER_COPIES];
+    VkBufferImageCopy image_regions[MAX_STAGING_IMAGE_COPIES];
+    uint32_t region_count = 0;
+
+    cmd_prepare_staging_dsts(ring, cmd_buffer);
+
+    for (uint32_t i = 0; i < ring->buffer_copy_count; ++i) {
+        struct StagingBufferCopy *copy = &ring->buffer_copies[i];
+        bool is_run_end = i + 1 == ring->buffer_copy_count
+            || ring->buffer_copies[i + 1].buffer != copy->buffer;
+        bool is_overlapping = false;
+
+        for (uint32_t j = 0; j < region_count && !is_overlapping; ++j)
+            is_overlapping = is_buffer_copy_overlapping(&regions[j], &copy->region);
+
+        // The regions of a single copy command must not overlap
+        if (is_overlapping) {
+            VkBufferMemoryBarrier barrier = {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .buffer = copy->buffer,
+                .offset = 0,
+                .size = VK_WHOLE_SIZE
+            };
+
+            vkCmdCopyBuffer(cmd_buffer, ring->buffer, copy->buffer, region_count, regions);
+            cmd_staging_write_after_write_barrier(cmd_buffer, &barrier, NULL);
+
+            region_count = 0;
+        }
+
+        regions[region_count++] = copy->region;
+
+        if (!is_run_end)
+            continue;
+
+        vkCmdCopyBuffer(cmd_buffer, ring->buffer, copy->buffer, region_count, regions);
+        cmd_release_buffer_ownership(cmd_buffer, &copy->transfer, copy->buffer);
+
+        region_count = 0;
+    }
+
+    for (uint32_t i = 0; i < ring->image_copy_count; ++i) {
+        struct StagingImageCopy *copy = &ring->image_copies[i];
+        bool is_run_end = i + 1 == ring->image_copy_count
+            || !is_same_image_subresource(copy, &ring->image_copies[i + 1]);
+        bool is_overlapping = false;
+
+        for (uint32_t j = 0; j < region_count && !is_overlapping; ++j)
+            is_overlapping = is_image_copy_overlapping(&image_regions[j], &copy->region);
+
+        if (is_overlapping) {
+            VkImageMemoryBarrier barrier = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .oldLayout = staging_copy_layout(copy),
+                .newLayout = staging_copy_layout(copy),
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = copy->image,
+                .subresourceRange = copy->subresource_range
+            };
+
+            vkCmdCopyBufferToImage(
+                cmd_buffer,
+                ring->buffer,
+                copy->image,
+                staging_copy_layout(copy),
+                region_count,
+                image_regions
+            );
+            cmd_staging_write_after_write_barrier(cmd_buffer, NULL, &barrier);
+
+            region_count = 0;
+        }
+
+        image_regions[region_count++] = copy->region;
+
+        if (!is_run_end)
+            continue;
+
+        vkCmdCopyBufferToImage(
+            cmd_buffer,
+            ring->buffer,
+            copy->image,
+            staging_copy_layout(copy),
+            region_count,
+            image_regions
+        );
+
+        region_count = 0;
+
+        cmd_release_image_ownership(
+            cmd_buffer,
+            &copy->transfer,
+            copy->image,
+            &copy->subresource_range,
+            staging_copy_layout(copy),
+            copy->new_layout
+        );
+    }
+}
+
+Result submit_staging_ring(
+    struct StagingRing *ring,
+    VkQueue transfer_queue,
+    VkQueue graphics_queue,
+    VkSemaphore *uploaded,
+    VkPipelineStageFlags *wait_stage
+) {
+    ASSERT_NOT_NULL(ring);
+    ASSERT_NOT_NULL(transfer_queue);
+    ASSERT_NOT_NULL(graphics_queue);
+    ASSERT_NOT_NULL(uploaded);
+    ASSERT_NOT_NULL(wait_stage);
+
+    Result result = { 0 };
+    struct StagingBatch *batch = &ring->batches[ring->current_batch_idx];
+    VkCommandBuffer cmd_buffer = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    VkCommandBufferBeginInfo cmd_buffer_bi = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+    VkSubmitInfo submit_info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .signalSemaphoreCount = 1
+    };
+
+    *uploaded = VK_NULL_HANDLE;
+    *wait_stage = 0;
+
+    ring->stats.frame_uploaded_bytes = ring->pending_bytes;
+    ring->stats.frame_copy_count = ring->buffer_copy_count + ring->image_copy_count;
+
+    if (ring->stats.frame_copy_count == 0)
+        goto exit;
+
+    // The batch slot is reused: its previous submission must be completed
+    if (batch->is_pending) {
+        result.error = VK_RESULT(vkWaitForFences(ring->device, 1, &batch->fence, VK_TRUE, UINT64_MAX));
+        EXPECT_SUCCESS(result);
+
+        complete_staging_batch(ring, batch);
+    }
+
+    qsort(ring->buffer_copies, ring->buffer_copy_count, sizeof(struct StagingBufferCopy), compare_staging_buffer_copies);
+    qsort(ring->image_copies, ring->image_copy_count, sizeof(struct StagingImageCopy), compare_staging_image_copies);
+
+    for (uint32_t i = 0; i < ring->buffer_copy_count; ++i)
+        ring->buffer_copies[i].transfer = staging_dst_transfer(ring, &ring->buffer_copies[i].dst);
+
+    for (uint32_t i = 0; i < ring->image_copy_count; ++i)
+        ring->image_copies[i].transfer = staging_dst_transfer(ring, &ring->image_copies[i].dst);
+
+    if (ring->is_fallback) {
+        cmd_buffer = batch->fallback_cmd_buffer;
+        queue = graphics_queue;
+
+        ring->stats.fallback_count += 1;
+    } else {
+        cmd_buffer = batch->cmd_buffer;
+        queue = transfer_queue;
+    }
+
+    result.error = VK_RESULT(vkResetCommandBuffer(cmd_buffer, 0));
+    EXPECT_SUCCESS(result);
+
+    result.error = VK_RESULT(vkBeginCommandBuffer(cmd_buffer, &cmd_buffer_bi));
+    EXPECT_SUCCESS(result);
+
+    record_staging_copies(ring, cmd_buffer);
+
+    result.error = VK_RESULT(vkEndCommandBuffer(cmd_buffer));
+    EXPECT_SUCCESS(result);
+
+    submit_info.pCommandBuffers = &cmd_buffer;
+    submit_info.pSignalSemaphores = &batch->uploaded;
+
+    // The fence is reset right before the submission: the earlier failures leave it signaled
+    result.error = VK_RESULT(vkResetFences(ring->device, 1, &batch->fence));
+    EXPECT_SUCCESS(result);
+
+    result.error = VK_RESULT(vkQueueSubmit(queue, 1, &submit_info, batch->fence));
+    if (result.error != SUCCESS) {
+        // An empty submission signals the fence, so a wait on the batch doesn't hang
+        if (vkQueueSubmit(queue, 0, NULL, batch->fence) != VK_SUCCESS)
+            error(LOG_TARGET, "unable to signal the fence of the failed staging submission");
+
+        EXPECT_SUCCESS(result);
+    }
+
+    batch->end = ring->head;
+    batch->is_pending = true;
+
+    ring->is_submitted = true;
+    ring->current_batch_idx = (ring->current_batch_idx + 1) % ring->batch_count;
+
+    ring->stats.total_uploaded_bytes += ring->pending_bytes;
+    ring->stats.submit_count += 1;
+
+    *uploaded = batch->uploaded;
+    *wait_stage = ring->dst_stages;
+
+    FN_FORCE_EXIT(result, {
+        // The batch is not submitted (and stays not pending unless its previous submission wait failed):
+        // its semaphore is not signaled and must not be waited.
+        // The copies stay collected and go with the next submission.
+        if (result.error != SUCCESS) {
+            if (cmd_buffer != VK_NULL_HANDLE)
+                vkResetCommandBuffer(cmd_buffer, 0);
+
+            *uploaded = VK_NULL_HANDLE;
+            *wait_stage = 0;
+        }
+    });
+}
+
+void cmd_acquire_staging_uploads(struct StagingRing *ring, VkCommandBuffer cmd_buffer) {
+    ASSERT_NOT_NULL(ring);
+    ASSERT_NOT_NULL(cmd_buffer);
+
+    if (!ring->is_submitted)
+        goto reset;
+
+    for (uint32_t i = 0; i < ring->buffer_copy_count; ++i) {
+        struct StagingBufferCopy *copy = &ring->buffer_copies[i];
+
+        if (i + 1 < ring->buffer_copy_count && ring->buffer_copies[i + 1].buffer == copy->buffer)
+            continue;
+
+        cmd_acquire_buffer_ownership(cmd_buffer, &copy->transfer, copy->buffer);
+    }
+
+    for (uint32_t i = 0; i < ring->image_copy_count; ++i) {
+        struct StagingImageCopy *copy = &ring->image_copies[i];
+
+        if (i + 1 < ring->image_copy_count && is_same_image_subresource(copy, &ring->image_copies[i + 1]))
+            continue;
+
+        cmd_acquire_image_ownership(
+            cmd_buffer,
+            &copy->transfer,
+            copy->image,
+            &copy->subresource_range,
+            staging_copy_layout(copy),
+            copy->new_layout
+        );
+    }
+
+reset:
+    ring->buffer_copy_count = 0;
+    ring->image_copy_count = 0;
+    ring->pending_bytes = 0;
+    ring->dst_stages = 0;
+    ring->is_fallback = false;
+    ring->is_submitted = false;
+}
+
+void drop_staging_ring(struct StagingRing *ring) {
+    if (ring == NULL)
+        goto exit;
+
+    if (ring->batches != NULL) {
+        for (uint32_t i = 0; i < ring->batch_count; ++i) {
+            vkDestroyFence(ring->device, ring->batches[i].fence, NULL);
+            vkDestroySemaphore(ring->device, ring->batches[i].uploaded, NULL);
+        }
+    }
+
+    gpu_free_buffer(ring->allocator, ring->buffer, &ring->allocation);
+
+    free(ring->batches);
+    free(ring->image_copies);
+    free(ring->buffer_copies);
+    free(ring);
+
+exit:
+    debug(LOG_TARGET, "drop staging ring");
+}
@@ -0,0 +1,177 @@
+#ifndef ___APRIORI2_GRAPHICS_RENDERER_STAGING_H___
+#define ___APRIORI2_GRAPHICS_RENDERER_STAGING_H___
+
+#include <vulkan/vulkan.h>
+#include <stdbool.h>
+
+#include "ffi/core/result.h"
+#include "ffi/graphics/memory/allocator.h"
+#include "queues.h"
+#include "ownership.h"
+#include "stats.h"
+
+// Persistently mapped ring buffer the uploads of the whole frame are written to.
+// The copies are recorded and submitted as a single batch on the transfer queue;
+// the graphics queue waits for the batch with a semaphore
+// and acquires the destinations right before their first use.
+//
+// A batch overwriting the data the frames in flight may still read
+// goes to the graphics queue instead: only there a barrier can wait for these reads.
+// So does a batch with an image copy not aligned to the transfer queue granularity
+// (the graphics queues support any copy region).
+//
+// The ring space of a batch is reclaimed once the batch fence is signaled.
+
+#define STAGING_RING_SIZE (8ULL << 20)
+
+// Satisfies the buffer offset alignment of the copies into any color format
+#define STAGING_ALIGNMENT 16
+
+#define MAX_STAGING_BUFFER_COPIES 512
+#define MAX_STAGING_IMAGE_COPIES 128
+
+// Where the uploaded resource is used first on the graphics queue
+struct StagingDst {
+    // Exclusive destinations are released by the transfer family
+    // and acquired by the graphics family after the copy.
+    // Destinations written repeatedly (e.g. partially updated atlases)
+    // must be concurrent between these families to keep the rest of their content.
+    VkSharingMode sharing_mode;
+
+    VkPipelineStageFlags stage;
+    VkAccessFlags access;
+
+    // The written part can be read (at `stage`) by the frames in flight,
+    // the copy waits for these reads
+    bool is_read_in_flight;
+};
+
+// The copies are grouped by the destination,
+// the copies of the same destination keep the upload order (`copy_idx`):
+// the overlapping ones are separated by the barriers, the later one wins
+
+struct StagingBufferCopy {
+    uint32_t copy_idx;
+    VkBuffer buffer;
+    VkBufferCopy region;
+    struct StagingDst dst;
+
+    // Known once the batch queue is chosen
+    struct QueueOwnershipTransfer transfer;
+};
+
+struct StagingImageCopy {
+    uint32_t copy_idx;
+    VkImage image;
+    VkBufferImageCopy region;
+    VkImageSubresourceRange subresource_range;
+    VkImageLayout old_layout;
+    VkImageLayout new_layout;
+    struct StagingDst dst;
+    struct QueueOwnershipTransfer transfer;
+};
+
+struct StagingBatch {
+    VkCommandBuffer cmd_buffer;
+    VkCommandBuffer fallback_cmd_buffer;
+    VkFence fence;
+    VkSemaphore uploaded;
+
+    // The ring position right after the batch data
+    uint64_t end;
+    bool is_pending;
+};
+
+struct StagingRing {
+    VkDevice device;
+    struct GpuAllocator *allocator;
+    struct RendererQueueFamilies *families;
+
+    // `minImageTransferGranularity` of the transfer family,
+    // (0, 0, 0) allows the whole mip level copies only
+    VkExtent3D transfer_granularity;
+
+    VkBuffer buffer;
+    struct GpuAllocation allocation;
+    VkDeviceSize size;
+
+    // Monotonic positions, the ring offset is `position % size`
+    uint64_t head;
+    uint64_t tail;
+
+    struct StagingBatch *batches;
+    uint32_t batch_count;
+    uint32_t current_batch_idx;
+
+    // The copies of the batch being collected
+    // (kept after the submission until the graphics queue acquires them)
+    struct StagingBufferCopy *buffer_copies;
+    uint32_t buffer_copy_count;
+    struct StagingImageCopy *image_copies;
+    uint32_t image_copy_count;
+    uint64_t pending_bytes;
+    VkPipelineStageFlags dst_stages;
+
+    // The collected batch goes to the graphics queue
+    bool is_fallback;
+    bool is_submitted;
+
+    RendererUploadStats stats;
+};
+
+Result new_staging_ring(
+    VkPhysicalDevice phy_device,
+    VkDevice device,
+    struct GpuAllocator *allocator,
+    struct RendererQueueFamilies *families,
+    VkCommandBuffer *transfer_cmd_buffers,
+    VkCommandBuffer *fallback_cmd_buffers,
+    uint32_t batch_count
+);
+
+// Reserves `size` bytes of the ring, returns the mapped pointer.
+// Blocks on the oldest batch fence if the ring is full.
+Result staging_ring_alloc(struct StagingRing *ring, VkDeviceSize size, VkDeviceSize *offset);
+
+Result staging_upload_buffer(
+    struct StagingRing *ring,
+    const void *data,
+    VkDeviceSize size,
+    VkBuffer buffer,
+    VkDeviceSize buffer_offset,
+    const struct StagingDst *dst
+);
+
+// `region->bufferOffset` is filled by the ring,
+// the region covers a single mip level.
+//
+// Images staying in `VK_IMAGE_LAYOUT_GENERAL` are copied in place:
+// the parts of such an image not covered by the region can be read by the frames in flight.
+Result staging_upload_image(
+    struct StagingRing *ring,
+    const void *data,
+    VkDeviceSize size,
+    VkImage image,
+    const VkBufferImageCopy *region,
+    VkImageLayout old_layout,
+    VkImageLayout new_layout,
+    const struct StagingDst *dst
+);
+
+// Submits the collected copies to `transfer_queue` (or to `graphics_queue` if the batch falls back).
+// `uploaded` is VK_NULL_HANDLE if there was nothing to upload,
+// otherwise the graphics submission must wait for it at `wait_stage`.
+Result submit_staging_ring(
+    struct StagingRing *ring,
+    VkQueue transfer_queue,
+    VkQueue graphics_queue,
+    VkSemaphore *uploaded,
+    VkPipelineStageFlags *wait_stage
+);
+
+// Records the graphics side of the submitted batch and starts collecting the next one
+void cmd_acquire_staging_uploads(struct StagingRing *ring, VkCommandBuffer cmd_buffer);
+
+void drop_staging_ring(struct StagingRing *ring);
+
+#endif // ___APRIORI2_GRAPHICS_RENDERER_STAGING_H___
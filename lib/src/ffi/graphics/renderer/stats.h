@@ -0,0 +1,78 @@
+#ifndef ___APRIORI2_GRAPHICS_RENDERER_STATS_H___
+#define ___APRIORI2_GRAPHICS_RENDERER_STATS_H___
+
+#include <stdint.h>
+
+typedef struct RendererFrameStats {
+    uint64_t frame_count;
+    uint32_t frames_in_flight;
+
+    // Time between the starts of the two last frames
+    uint64_t frame_time_ns;
+
+    // Time the CPU was blocked on the frame slot fence,
+    // i.e. waiting for the GPU to finish the frame that used the slot last time
+    uint64_t fence_wait_time_ns;
+
+    // Acquire + recording + submit + present time
+    uint64_t cpu_time_ns;
+
+    // Totals since the renderer creation (to compute averages)
+    uint64_t total_frame_time_ns;
+    uint64_t total_fence_wait_time_ns;
+    uint64_t total_cpu_time_ns;
+} RendererFrameStats;
+
+typedef struct RendererUploadStats {
+    uint64_t ring_size;
+
+    // The last submitted upload batch
+    uint64_t frame_uploaded_bytes;
+    uint32_t frame_copy_count;
+
+    uint64_t total_uploaded_bytes;
+    uint64_t submit_count;
+
+    // Uploads which blocked on a fence to reclaim the ring space
+    uint64_t stall_count;
+
+    // Batches copied on the graphics queue: overwriting the data of the frames in flight
+    // or not aligned to the transfer queue granularity
+    uint64_t fallback_count;
+} RendererUploadStats;
+
+typedef struct OverlayDrawStats {
+    // The last drawn frame
+    uint32_t quad_count;
+    uint32_t draw_call_count;
+
+    // Quads beyond the draw list capacity
+    uint32_t dropped_quad_count;
+} OverlayDrawStats;
+
+typedef struct OverlayAtlasStats {
+    uint32_t page_count;
+    uint32_t page_size;
+    uint32_t image_count;
+
+    // Texels covered by the packed images (including the padding)
+    uint64_t used_texel_count;
+
+    // Texels uploaded with the last frame (including the extruded edges)
+    uint64_t frame_uploaded_texel_count;
+
+    uint64_t eviction_count;
+} OverlayAtlasStats;
+
+typedef struct DescrAllocatorStats {
+    // All the frame slots
+    uint32_t pool_count;
+
+    // Pools added to the exhausted frame slots
+    uint64_t grow_count;
+
+    // Transient sets of the current frame
+    uint32_t frame_set_count;
+} DescrAllocatorStats;
+
+#endif // ___APRIORI2_GRAPHICS_RENDERER_STATS_H___
@@ -1,12 +1,171 @@
 #include "swapchain.h"
 
 #include "ffi/util/mod.h"
+#include "ffi/math/mod.h"
 #include "ffi/core/log.h"
+#include "ffi/core/cpu_profiler/mod.h"
 #include "renderer/mod.h"
 
 #define LOG_TARGET LOG_STRUCT_TARGET(Swapchain)
 
 Result new_swapchain(struct SwapchainCreateParams *params) {
+    Result result = { 0 };
+
+    PROFILE_ZONE_BEGIN(new_swapchain);
+
+#   ifdef SWAPCHAIN_OFFSCREEN
+    result = new_offscreen_swapchain(params);
+#   else
+    result = new_surface_swapchain(params);
+#   endif // SWAPCHAIN_OFFSCREEN
+
+    PROFILE_ZONE_END(new_swapchain);
+
+    return result;
+}
+
+VkExtent2D select_image_extent(
+    VkSurfaceCapabilitiesKHR *surface_caps,
+    VkExtent2D requested_extent
+) {
+    ASSERT_NOT_NULL(surface_caps);
+
+    VkExtent2D extent = surface_caps->currentExtent;
+
+    // The surface size is determined by the swapchain extent
+    if (extent.width == UINT32_MAX) {
+        extent.width = CLAMP(
+            requested_extent.width,
+            surface_caps->minImageExtent.width,
+            surface_caps->maxImageExtent.width
+        );
+        extent.height = CLAMP(
+            requested_extent.height,
+            surface_caps->minImageExtent.height,
+            surface_caps->maxImageExtent.height
+        );
+    }
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "image extent: %dx%d (requested: %dx%d)"),
+        extent.width, extent.height,
+        requested_extent.width, requested_extent.height
+    );
+
+    return extent;
+}
+
+const char *present_mode_to_string(PresentMode present_mode) {
+#define PRESENT_MODE_CASE(mode) case PRESENT_MODE_##mode: return #mode
+
+    switch (present_mode) {
+        PRESENT_MODE_CASE(NONE);
+        PRESENT_MODE_CASE(IMMEDIATE);
+        PRESENT_MODE_CASE(MAILBOX);
+        PRESENT_MODE_CASE(FIFO);
+        PRESENT_MODE_CASE(FIFO_RELAXED);
+        default:
+            return "UNKNOWN";
+    }
+
+#undef PRESENT_MODE_CASE
+}
+
+PresentMode to_present_mode(VkPresentModeKHR vk_present_mode) {
+    switch (vk_present_mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR: return PRESENT_MODE_IMMEDIATE;
+        case VK_PRESENT_MODE_MAILBOX_KHR: return PRESENT_MODE_MAILBOX;
+        case VK_PRESENT_MODE_FIFO_KHR: return PRESENT_MODE_FIFO;
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return PRESENT_MODE_FIFO_RELAXED;
+        default: return PRESENT_MODE_NONE;
+    }
+}
+
+VkPresentModeKHR select_present_mode(
+    PresentPolicy policy,
+    VkPresentModeKHR *present_modes,
+    uint32_t present_modes_count
+) {
+    ASSERT_NOT_NULL(present_modes);
+
+    // Ordered by preference, FIFO is the fallback: it is always supported
+    static const VkPresentModeKHR low_latency_modes[] = {
+        VK_PRESENT_MODE_IMMEDIATE_KHR,
+        VK_PRESENT_MODE_MAILBOX_KHR
+    };
+    static const VkPresentModeKHR throughput_modes[] = {
+        VK_PRESENT_MODE_FIFO_KHR
+    };
+    static const VkPresentModeKHR power_saving_modes[] = {
+        VK_PRESENT_MODE_FIFO_RELAXED_KHR
+    };
+
+    const VkPresentModeKHR *preferred_modes = NULL;
+    uint32_t preferred_modes_count = 0;
+
+#define POLICY_CASE(policy, modes) \
+    case PRESENT_POLICY_##policy: \
+        preferred_modes = modes; \
+        preferred_modes_count = STATIC_ARRAY_SIZE(modes); \
+        trace(LOG_TARGET, LOG_GROUP(struct_op, "present policy: " #policy)); \
+        break
+
+    switch (policy) {
+        POLICY_CASE(LOW_LATENCY, low_latency_modes);
+        POLICY_CASE(THROUGHPUT, throughput_modes);
+        POLICY_CASE(POWER_SAVING, power_saving_modes);
+        default:
+            assert(false && "unknown present policy");
+            break;
+    }
+
+#undef POLICY_CASE
+
+    for (uint32_t i = 0; i < preferred_modes_count; ++i) {
+        for (uint32_t j = 0; j < present_modes_count; ++j) {
+            if (present_modes[j] == preferred_modes[i])
+                return preferred_modes[i];
+        }
+    }
+
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+uint32_t select_image_count(PresentPolicy policy, VkSurfaceCapabilitiesKHR *surface_caps) {
+    ASSERT_NOT_NULL(surface_caps);
+
+    uint32_t image_count = surface_caps->minImageCount;
+
+    switch (policy) {
+        case PRESENT_POLICY_LOW_LATENCY:
+            // One extra image so the acquire never waits for the presentation engine
+            image_count = surface_caps->minImageCount + 1;
+            break;
+        case PRESENT_POLICY_THROUGHPUT:
+            image_count = 3;
+            break;
+        case PRESENT_POLICY_POWER_SAVING:
+        default:
+            break;
+    }
+
+    image_count = MAX(image_count, surface_caps->minImageCount);
+
+    // Zero max image count means there is no limit
+    if (surface_caps->maxImageCount != 0)
+        image_count = MIN(image_count, surface_caps->maxImageCount);
+
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "image count: %d (surface min: %d, max: %d)"),
+        image_count, surface_caps->minImageCount, surface_caps->maxImageCount
+    );
+
+    return image_count;
+}
+
+Result new_surface_swapchain(struct SwapchainCreateParams *params) {
     ASSERT_NOT_NULL(params);
     ASSERT_NOT_NULL(params->phy_device);
     ASSERT_NOT_NULL(params->device);
@@ -16,7 +175,7 @@ Result new_swapchain(struct SwapchainCreateParams *params) {
     uint32_t present_modes_count = 0;
     VkPresentModeKHR *present_modes = NULL;
     VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
-    uint32_t avg_image_count = 0;
+    uint32_t image_count = 0;
     uint32_t queues[] = {
         params->families->graphics_idx,
         params->families->present_idx,
@@ -48,57 +207,58 @@ Result new_swapchain(struct SwapchainCreateParams *params) {
 
     trace(LOG_TARGET, LOG_GROUP(struct, "getting surface capabilities..."));
     VkSurfaceCapabilitiesKHR surface_caps = { 0 };
-    result.error = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(
+    result.error = VK_RESULT(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(
         params->phy_device,
         params->surface,
         &surface_caps
-    );
+    ));
     EXPECT_SUCCESS(result);
 
     trace(LOG_TARGET, LOG_GROUP(struct, "selecting present mode..."));
-    result.error = vkGetPhysicalDeviceSurfacePresentModesKHR(
+    result.error = VK_RESULT(vkGetPhysicalDeviceSurfacePresentModesKHR(
         params->phy_device,
         params->surface,
         &present_modes_count,
         NULL
-    );
+    ));
     EXPECT_SUCCESS(result);
 
     present_modes = ALLOC_ARRAY_UNINIT(result, VkPresentModeKHR, present_modes_count);
 
-    result.error = vkGetPhysicalDeviceSurfacePresentModesKHR(
+    result.error = VK_RESULT(vkGetPhysicalDeviceSurfacePresentModesKHR(
         params->phy_device,
         params->surface,
         &present_modes_count,
         present_modes
-    );
+    ));
     EXPECT_SUCCESS(result);
 
-    for (uint32_t i = 0; i < present_modes_count; ++i) {
-        if (present_modes[i] == VK_PRESENT_MODE_MAILBOX_KHR) {
-            trace(LOG_TARGET, LOG_GROUP(struct_op, "found MAILBOX present mode"));
-            present_mode = present_modes[i];
-            break;
-        }
-    }
+    present_mode = select_present_mode(
+        params->present_policy,
+        present_modes,
+        present_modes_count
+    );
 
-    trace(LOG_TARGET, LOG_GROUP(struct, "present mode selected"));
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "present mode selected: %s"),
+        present_mode_to_string(to_present_mode(present_mode))
+    );
 
-    avg_image_count = (
-        surface_caps.minImageCount + surface_caps.maxImageCount
-    ) / 2;
+    image_count = select_image_count(params->present_policy, &surface_caps);
 
     swapchain_ci.surface = params->surface;
-    swapchain_ci.minImageCount = avg_image_count;
+    swapchain_ci.minImageCount = image_count;
     swapchain_ci.imageFormat = params->surface_format.format;
     swapchain_ci.imageColorSpace = params->surface_format.colorSpace;
-    swapchain_ci.imageExtent = params->image_extent;
+    swapchain_ci.imageExtent = select_image_extent(&surface_caps, params->image_extent);
     swapchain_ci.imageArrayLayers = 1;
     swapchain_ci.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
     swapchain_ci.preTransform = surface_caps.currentTransform;
     swapchain_ci.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    swapchain_ci.presentMode = present_mode;
     swapchain_ci.clipped = VK_TRUE;
-    swapchain_ci.oldSwapchain = VK_NULL_HANDLE;
+    swapchain_ci.oldSwapchain = params->old_swapchain;
 
     if (queues[0] == queues[1]) {
         swapchain_ci.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
@@ -108,37 +268,45 @@ Result new_swapchain(struct SwapchainCreateParams *params) {
         swapchain_ci.pQueueFamilyIndices = queues;
     }
 
-    result.error = vkCreateSwapchainKHR(
+    result.error = VK_RESULT(vkCreateSwapchainKHR(
         params->device,
         &swapchain_ci,
         NULL,
         &swapchain->vk_handle
-    );
+    ));
     result.object = swapchain;
     EXPECT_SUCCESS(result);
 
     trace(LOG_TARGET, LOG_GROUP(struct, "getting swapchain images..."));
-    result.error = vkGetSwapchainImagesKHR(
+    result.error = VK_RESULT(vkGetSwapchainImagesKHR(
         params->device,
         swapchain->vk_handle,
         &swapchain->image_count,
         NULL
-    );
+    ));
     EXPECT_SUCCESS(result);
 
     swapchain->device = params->device;
+    swapchain->image_format = params->surface_format.format;
+    swapchain->image_extent = swapchain_ci.imageExtent;
+    swapchain->present_policy = params->present_policy;
+    swapchain->present_mode = to_present_mode(present_mode);
 
     swapchain->images = ALLOC_ARRAY_UNINIT(result, VkImage, swapchain->image_count);
 
-    result.error = vkGetSwapchainImagesKHR(
+    result.error = VK_RESULT(vkGetSwapchainImagesKHR(
         params->device,
         swapchain->vk_handle,
         &swapchain->image_count,
         swapchain->images
-    );
+    ));
     EXPECT_SUCCESS(result);
 
-    trace(LOG_TARGET, LOG_GROUP(struct, "swapchain images received successufully"));
+    trace(
+        LOG_TARGET,
+        LOG_GROUP(struct, "swapchain images received successufully (requested: %d, actual: %d)"),
+        image_count, swapchain->image_count
+    );
 
     trace(LOG_TARGET, LOG_GROUP(struct, "creating new swapchain image views..."));
 
@@ -151,19 +319,24 @@ Result new_swapchain(struct SwapchainCreateParams *params) {
     for (uint32_t i = 0; i < swapchain->image_count; ++i) {
         image_view_ci.image = AS(swapchain->images, VkImage*)[i];
 
-        result.error = vkCreateImageView(
+        result.error = VK_RESULT(vkCreateImageView(
             params->device,
             &image_view_ci,
             NULL,
             &AS(swapchain->views, VkImageView*)[i]
-        );
+        ));
         EXPECT_SUCCESS(result);
     }
 
     trace(LOG_TARGET, LOG_GROUP(struct, "new swapchain image views created successfully"));
 
     result.object = swapchain;
-    info(LOG_TARGET, "new swapchain created successfully");
+    info(
+        LOG_TARGET,
+        "new swapchain created successfully (present mode: %s, image count: %d)",
+        present_mode_to_string(swapchain->present_mode),
+        swapchain->image_count
+    );
 
     FN_EXIT(result, {
         free(present_modes);
@@ -188,6 +361,17 @@ void drop_swapchain(struct Swapchain *swapchain) {
         }
     }
 
+    if (swapchain->offscreen_allocations != NULL) {
+        for (uint32_t i = 0; i < swapchain->image_count; ++i) {
+            gpu_free_image(
+                swapchain->allocator,
+                AS(swapchain->images, VkImage*)[i],
+                &swapchain->offscreen_allocations[i]
+            );
+        }
+    }
+
+    free(swapchain->offscreen_allocations);
     free(swapchain->views);
     free(swapchain->images);
 
@@ -197,3 +381,90 @@ void drop_swapchain(struct Swapchain *swapchain) {
 exit:
     debug(LOG_TARGET, "drop swapchain");
 }
+
+SwapchainInfo swapchain_info(struct Swapchain *swapchain) {
+    ASSERT_NOT_NULL(swapchain);
+
+    SwapchainInfo actual_info = { 0 };
+
+    actual_info.policy = swapchain->present_policy;
+    actual_info.present_mode = swapchain->present_mode;
+    actual_info.image_count = swapchain->image_count;
+    actual_info.image_width = swapchain->image_extent.width;
+    actual_info.image_height = swapchain->image_extent.height;
+
+    return actual_info;
+}
+
+bool is_offscreen_swapchain(struct Swapchain *swapchain) {
+    ASSERT_NOT_NULL(swapchain);
+
+    return swapchain->offscreen_allocations != NULL;
+}
+
+Result swapchain_acquire_next_image(
+    struct Swapchain *swapchain,
+    VkSemaphore image_available,
+    uint32_t *image_idx
+) {
+    ASSERT_NOT_NULL(swapchain);
+    ASSERT_NOT_NULL(image_idx);
+
+    Result result = { 0 };
+
+    if (is_offscreen_swapchain(swapchain)) {
+        *image_idx = swapchain->next_offscreen_image_idx;
+        swapchain->next_offscreen_image_idx = (*image_idx + 1) % swapchain->image_count;
+        goto exit;
+    }
+
+    VkResult acquire_result = vkAcquireNextImageKHR(
+        swapchain->device,
+        swapchain->vk_handle,
+        UINT64_MAX,
+        image_available,
+        VK_NULL_HANDLE,
+        image_idx
+    );
+
+    // The image is acquired even if the swapchain is suboptimal
+    result.error = VK_RESULT(acquire_result);
+    if (acquire_result != VK_SUBOPTIMAL_KHR)
+        EXPECT_SUCCESS(result);
+
+    FN_FORCE_EXIT(result);
+}
+
+Result swapchain_present(
+    struct Swapchain *swapchain,
+    VkQueue present_queue,
+    VkSemaphore render_finished,
+    uint32_t image_idx
+) {
+    ASSERT_NOT_NULL(swapchain);
+
+    Result result = { 0 };
+    VkPresentInfoKHR present_info = {
+        .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+        .waitSemaphoreCount = 1,
+        .swapchainCount = 1
+    };
+
+    if (is_offscreen_swapchain(swapchain))
+        goto exit;
+
+    ASSERT_NOT_NULL(present_queue);
+
+    present_info.pWaitSemaphores = &render_finished;
+    present_info.pSwapchains = &swapchain->vk_handle;
+    present_info.pImageIndices = &image_idx;
+
+    VkResult present_result = vkQueuePresentKHR(present_queue, &present_info);
+
+    // The image is presented even if the swapchain is suboptimal
+    result.error = VK_RESULT(present_result);
+    if (present_result != VK_SUBOPTIMAL_KHR)
+        EXPECT_SUCCESS(result);
+
+    FN_FORCE_EXIT(result);
+}
@@ -2,10 +2,21 @@
 #define ___APRIORI2_GRAPHICS_SWAPCHAIN_H___
 
 #include <vulkan/vulkan.h>
+#include <stdbool.h>
 
 #include "ffi/core/def.h"
 #include "ffi/core/result.h"
 #include "renderer/queues.h"
+#include "present_policy.h"
+#include "memory/allocator.h"
+
+// There is no window system integration on Linux yet:
+// the renderer draws into the offscreen image ring instead of the surface swapchain.
+#ifdef ___linux___
+#   define SWAPCHAIN_OFFSCREEN
+#endif // ___linux___
+
+#define OFFSCREEN_SWAPCHAIN_IMAGE_COUNT 3
 
 struct RendererQueues;
 
@@ -15,6 +26,15 @@ struct Swapchain {
     VkImage *images;
     VkImageView *views;
     uint32_t image_count;
+    VkFormat image_format;
+    VkExtent2D image_extent;
+    PresentPolicy present_policy;
+    PresentMode present_mode;
+
+    // Offscreen swapchain only (`vk_handle` is VK_NULL_HANDLE)
+    struct GpuAllocator *allocator;
+    struct GpuAllocation *offscreen_allocations;
+    uint32_t next_offscreen_image_idx;
 };
 
 struct SwapchainCreateParams {
@@ -24,10 +44,45 @@ struct SwapchainCreateParams {
     VkSurfaceFormatKHR surface_format;
     VkExtent2D image_extent;
     struct RendererQueueFamilies *families;
+    PresentPolicy present_policy;
+
+    // The offscreen swapchain images memory is sub-allocated from it
+    struct GpuAllocator *allocator;
+
+    // The swapchain being replaced (or VK_NULL_HANDLE).
+    // It is retired but not destroyed by the new swapchain creation.
+    VkSwapchainKHR old_swapchain;
 };
 
 Result new_swapchain(struct SwapchainCreateParams *params);
 
+Result new_surface_swapchain(struct SwapchainCreateParams *params);
+
+Result new_offscreen_swapchain(struct SwapchainCreateParams *params);
+
+bool is_offscreen_swapchain(struct Swapchain *swapchain);
+
+SwapchainInfo swapchain_info(struct Swapchain *swapchain);
+
+// The offscreen swapchain hands out its images round-robin
+// and never signals `image_available`.
+// `VK_SUBOPTIMAL_KHR` is returned with the acquired image:
+// the image must be presented and then the swapchain recreated.
+Result swapchain_acquire_next_image(
+    struct Swapchain *swapchain,
+    VkSemaphore image_available,
+    uint32_t *image_idx
+);
+
+// No-op for the offscreen swapchain.
+// `VK_SUBOPTIMAL_KHR` means the image is presented, but the swapchain should be recreated.
+Result swapchain_present(
+    struct Swapchain *swapchain,
+    VkQueue present_queue,
+    VkSemaphore render_finished,
+    uint32_t image_idx
+);
+
 void drop_swapchain(struct Swapchain *swapchain);
 
 #endif // ___APRIORI2_GRAPHICS_SWAPCHAIN_H___
\ No newline at end of file
@@ -6,5 +6,10 @@
 
 #define CEIL_32(value) (((AS((value), float) - AS((value), int32_t)) == 0) ? AS((value), int32_t) : AS((value), int32_t) + 1)
 #define FLOOR_32(value) AS((value), int32_t)
+#define ROUND_32(value) AS((value) + (((value) < 0) ? -0.5f : 0.5f), int32_t)
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define CLAMP(value, min, max) MAX((min), MIN((max), (value)))
 
 #endif // ___APRIORI2_MATH_H___
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef ___APRIORI2_MATH_VEC_H___
 #define ___APRIORI2_MATH_VEC_H___
 
+#include <stdint.h>
 
 typedef struct {
     union {
@@ -23,4 +24,18 @@ typedef struct {
     };
 } float4;
 
+// Packed vertex attribute types
+
+typedef struct {
+    int16_t x, y;
+} short2;
+
+typedef struct {
+    uint16_t u, v;
+} ushort2;
+
+typedef struct {
+    uint8_t r, g, b, a;
+} ubyte4;
+
 #endif // ___APRIORI2_MATH_VEC_H___
\ No newline at end of file
@@ -0,0 +1,9 @@
+#ifndef ___APRIORI2_OS_FILE_H___
+#define ___APRIORI2_OS_FILE_H___
+
+#include <stdbool.h>
+
+// Renames `src_path` to `dst_path` replacing the existing file in one step
+bool replace_os_file(const char *src_path, const char *dst_path);
+
+#endif // ___APRIORI2_OS_FILE_H___
@@ -0,0 +1,7 @@
+#include <stdio.h>
+
+#include "ffi/os/file.h"
+
+bool replace_os_file(const char *src_path, const char *dst_path) {
+    return rename(src_path, dst_path) == 0;
+}
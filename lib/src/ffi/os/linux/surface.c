@@ -0,0 +1,49 @@
+#include "ffi/os/surface.h"
+#include "ffi/core/log.h"
+
+#define LOG_TARGET LOG_SUB_TARGET( \
+    LOG_STRUCT_TARGET(Renderer), LOG_STRUCT_TARGET(Surface) \
+)
+
+Result new_surface(
+    VkInstance instance,
+    Handle window_platform_handle
+) {
+    Result result = { 0 };
+
+    VkHeadlessSurfaceCreateInfoEXT surface_ci = {
+        .sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT
+    };
+
+    // Linux windows are virtual (headless) ones, there is no platform handle
+    UNUSED_VAR(window_platform_handle);
+
+    info(LOG_TARGET, "creating new renderer headless surface...");
+
+    PFN_vkCreateHeadlessSurfaceEXT
+    vkCreateHeadlessSurfaceEXT = (PFN_vkCreateHeadlessSurfaceEXT)vkGetInstanceProcAddr(
+        instance,
+        "vkCreateHeadlessSurfaceEXT"
+    );
+    UNWRAP_NOT_NULL(result, VK_PROC_NOT_FOUND, (Handle)vkCreateHeadlessSurfaceEXT);
+
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
+    result.error = VK_RESULT(vkCreateHeadlessSurfaceEXT(
+        instance,
+        &surface_ci,
+        NULL,
+        &surface
+    ));
+    result.object = surface;
+    EXPECT_SUCCESS(result);
+
+    info(LOG_TARGET, "new renderer headless surface created successfully");
+
+    FN_FORCE_EXIT(result);
+}
+
+void drop_surface(VkInstance instance, VkSurfaceKHR surface) {
+    vkDestroySurfaceKHR(instance, surface, NULL);
+
+    debug(LOG_TARGET, "drop surface");
+}
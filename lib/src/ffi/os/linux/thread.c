@@ -0,0 +1,156 @@
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "ffi/os/thread.h"
+#include "ffi/util/mod.h"
+
+struct OsThreadFFI {
+    pthread_t handle;
+    OsThreadFn thread_fn;
+    Handle arg;
+};
+
+struct OsMutexFFI {
+    pthread_mutex_t handle;
+};
+
+struct OsCondFFI {
+    pthread_cond_t handle;
+};
+
+uint32_t os_cpu_count() {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? AS(count, uint32_t) : 1;
+}
+
+void *os_thread_main(void *arg) {
+    OsThread thread = arg;
+
+    thread->thread_fn(thread->arg);
+
+    return NULL;
+}
+
+Result new_os_thread(OsThreadFn thread_fn, Handle arg) {
+    ASSERT_NOT_NULL(thread_fn);
+
+    Result result = { 0 };
+    OsThread thread = ALLOC(result, struct OsThreadFFI);
+
+    thread->thread_fn = thread_fn;
+    thread->arg = arg;
+
+    if (pthread_create(&thread->handle, NULL, os_thread_main, thread) != 0) {
+        result.error = THREAD_CREATION_FAILED;
+        EXPECT_SUCCESS(result);
+    }
+
+    result.object = thread;
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        free(thread);
+    });
+}
+
+void join_os_thread(OsThread thread) {
+    if (thread == NULL)
+        return;
+
+    pthread_join(thread->handle, NULL);
+    free(thread);
+}
+
+void yield_os_thread() {
+    sched_yield();
+}
+
+Result new_os_mutex() {
+    Result result = { 0 };
+    OsMutex mutex = ALLOC(result, struct OsMutexFFI);
+
+    pthread_mutex_init(&mutex->handle, NULL);
+    result.object = mutex;
+
+    FN_FORCE_EXIT(result);
+}
+
+void lock_os_mutex(OsMutex mutex) {
+    pthread_mutex_lock(&mutex->handle);
+}
+
+void unlock_os_mutex(OsMutex mutex) {
+    pthread_mutex_unlock(&mutex->handle);
+}
+
+void drop_os_mutex(OsMutex mutex) {
+    if (mutex == NULL)
+        return;
+
+    pthread_mutex_destroy(&mutex->handle);
+    free(mutex);
+}
+
+Result new_os_cond() {
+    Result result = { 0 };
+    OsCond cond = ALLOC(result, struct OsCondFFI);
+
+    pthread_cond_init(&cond->handle, NULL);
+    result.object = cond;
+
+    FN_FORCE_EXIT(result);
+}
+
+void wait_os_cond(OsCond cond, OsMutex mutex) {
+    pthread_cond_wait(&cond->handle, &mutex->handle);
+}
+
+void broadcast_os_cond(OsCond cond) {
+    pthread_cond_broadcast(&cond->handle);
+}
+
+void drop_os_cond(OsCond cond) {
+    if (cond == NULL)
+        return;
+
+    pthread_cond_destroy(&cond->handle);
+    free(cond);
+}
+
+uint32_t os_atomic_add_u32(volatile uint32_t *value, uint32_t addend) {
+    return __atomic_fetch_add(value, addend, __ATOMIC_SEQ_CST);
+}
+
+bool os_atomic_cas_u32(volatile uint32_t *value, uint32_t *expected, uint32_t new_value) {
+    return __atomic_compare_exchange_n(
+        value,
+        expected,
+        new_value,
+        false,
+        __ATOMIC_SEQ_CST,
+        __ATOMIC_SEQ_CST
+    );
+}
+
+uint32_t os_atomic_load_u32(volatile uint32_t *value) {
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+void os_atomic_store_u32(volatile uint32_t *value, uint32_t new_value) {
+    __atomic_store_n(value, new_value, __ATOMIC_RELEASE);
+}
+
+Handle os_atomic_load_ptr(Handle volatile *ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+void os_atomic_store_ptr(Handle volatile *ptr, Handle new_ptr) {
+    __atomic_store_n(ptr, new_ptr, __ATOMIC_RELEASE);
+}
+
+Handle os_atomic_exchange_ptr(Handle volatile *ptr, Handle new_ptr) {
+    return __atomic_exchange_n(ptr, new_ptr, __ATOMIC_SEQ_CST);
+}
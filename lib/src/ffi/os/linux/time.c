@@ -0,0 +1,11 @@
+#include <time.h>
+
+#include "ffi/os/time.h"
+
+uint64_t now_ns() {
+    struct timespec time = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (uint64_t)time.tv_sec * NS_PER_SEC + (uint64_t)time.tv_nsec;
+}
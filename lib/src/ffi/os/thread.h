@@ -0,0 +1,71 @@
+#ifndef ___APRIORI2_OS_THREAD_H___
+#define ___APRIORI2_OS_THREAD_H___
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ffi/core/def.h"
+#include "ffi/core/result.h"
+
+#ifdef ___windows___
+#   define OS_THREAD_LOCAL __declspec(thread)
+#else
+#   define OS_THREAD_LOCAL _Thread_local
+#endif // ___windows___
+
+typedef void (*OsThreadFn)(Handle arg);
+
+typedef struct OsThreadFFI *OsThread;
+typedef struct OsMutexFFI *OsMutex;
+typedef struct OsCondFFI *OsCond;
+
+// Logical processors available to the process
+uint32_t os_cpu_count();
+
+Result new_os_thread(OsThreadFn thread_fn, Handle arg);
+
+// Waits for the thread function to return and drops the thread
+void join_os_thread(OsThread thread);
+
+// Lets the other threads run on the calling thread processor
+void yield_os_thread();
+
+Result new_os_mutex();
+
+void lock_os_mutex(OsMutex mutex);
+
+void unlock_os_mutex(OsMutex mutex);
+
+void drop_os_mutex(OsMutex mutex);
+
+Result new_os_cond();
+
+// `mutex` must be locked, it is locked again on return.
+// Spurious wakeups are possible: the condition must be checked in a loop.
+void wait_os_cond(OsCond cond, OsMutex mutex);
+
+void broadcast_os_cond(OsCond cond);
+
+void drop_os_cond(OsCond cond);
+
+// Returns the previous value, a full barrier
+uint32_t os_atomic_add_u32(volatile uint32_t *value, uint32_t addend);
+
+// Stores `new_value` if the value equals `*expected`, otherwise loads the value into `*expected`.
+// A full barrier.
+bool os_atomic_cas_u32(volatile uint32_t *value, uint32_t *expected, uint32_t new_value);
+
+// Acquire: the writes released before the stored value are visible after the load
+uint32_t os_atomic_load_u32(volatile uint32_t *value);
+
+// Release
+void os_atomic_store_u32(volatile uint32_t *value, uint32_t new_value);
+
+Handle os_atomic_load_ptr(Handle volatile *ptr);
+
+void os_atomic_store_ptr(Handle volatile *ptr, Handle new_ptr);
+
+// Returns the previous pointer, a full barrier
+Handle os_atomic_exchange_ptr(Handle volatile *ptr, Handle new_ptr);
+
+#endif // ___APRIORI2_OS_THREAD_H___
@@ -0,0 +1,16 @@
+#ifndef ___APRIORI2_OS_TIME_H___
+#define ___APRIORI2_OS_TIME_H___
+
+#include <stdint.h>
+
+#include "ffi/core/def.h"
+
+#define NS_PER_MS (1000000ULL)
+#define NS_PER_SEC (1000000000ULL)
+
+#define NS_TO_MS(ns) (AS((ns), double) / AS(NS_PER_MS, double))
+
+// Monotonic clock, nanoseconds
+uint64_t now_ns();
+
+#endif // ___APRIORI2_OS_TIME_H___
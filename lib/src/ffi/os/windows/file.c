@@ -0,0 +1,8 @@
+#include <Windows.h>
+
+#include "ffi/os/file.h"
+
+// Unlike `rename`, replaces the existing file
+bool replace_os_file(const char *src_path, const char *dst_path) {
+    return MoveFileExA(src_path, dst_path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
@@ -23,12 +23,12 @@ Result new_surface(
     surface_ci.hwnd = window_platform_handle;
 
     VkSurfaceKHR surface = VK_NULL_HANDLE;
-    result.error = vkCreateWin32SurfaceKHR(
+    result.error = VK_RESULT(vkCreateWin32SurfaceKHR(
         instance,
         &surface_ci,
         NULL,
         &surface
-    );
+    ));
     result.object = surface;
     EXPECT_SUCCESS(result);
 
@@ -0,0 +1,155 @@
+#include <Windows.h>
+
+#include "ffi/os/thread.h"
+#include "ffi/util/mod.h"
+
+struct OsThreadFFI {
+    HANDLE handle;
+    OsThreadFn thread_fn;
+    Handle arg;
+};
+
+struct OsMutexFFI {
+    SRWLOCK handle;
+};
+
+struct OsCondFFI {
+    CONDITION_VARIABLE handle;
+};
+
+uint32_t os_cpu_count() {
+    SYSTEM_INFO system_info = { 0 };
+
+    GetSystemInfo(&system_info);
+
+    return system_info.dwNumberOfProcessors > 0 ? AS(system_info.dwNumberOfProcessors, uint32_t) : 1;
+}
+
+DWORD WINAPI os_thread_main(LPVOID arg) {
+    OsThread thread = arg;
+
+    thread->thread_fn(thread->arg);
+
+    return 0;
+}
+
+Result new_os_thread(OsThreadFn thread_fn, Handle arg) {
+    ASSERT_NOT_NULL(thread_fn);
+
+    Result result = { 0 };
+    OsThread thread = ALLOC(result, struct OsThreadFFI);
+
+    thread->thread_fn = thread_fn;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, os_thread_main, thread, 0, NULL);
+
+    if (thread->handle == NULL) {
+        result.error = THREAD_CREATION_FAILED;
+        EXPECT_SUCCESS(result);
+    }
+
+    result.object = thread;
+
+    FN_EXIT(result);
+
+    FN_FAILURE(result, {
+        free(thread);
+    });
+}
+
+void join_os_thread(OsThread thread) {
+    if (thread == NULL)
+        return;
+
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    free(thread);
+}
+
+void yield_os_thread() {
+    SwitchToThread();
+}
+
+Result new_os_mutex() {
+    Result result = { 0 };
+    OsMutex mutex = ALLOC(result, struct OsMutexFFI);
+
+    InitializeSRWLock(&mutex->handle);
+    result.object = mutex;
+
+    FN_FORCE_EXIT(result);
+}
+
+void lock_os_mutex(OsMutex mutex) {
+    AcquireSRWLockExclusive(&mutex->handle);
+}
+
+void unlock_os_mutex(OsMutex mutex) {
+    ReleaseSRWLockExclusive(&mutex->handle);
+}
+
+void drop_os_mutex(OsMutex mutex) {
+    // SRW locks don't need to be destroyed
+    free(mutex);
+}
+
+Result new_os_cond() {
+    Result result = { 0 };
+    OsCond cond = ALLOC(result, struct OsCondFFI);
+
+    InitializeConditionVariable(&cond->handle);
+    result.object = cond;
+
+    FN_FORCE_EXIT(result);
+}
+
+void wait_os_cond(OsCond cond, OsMutex mutex) {
+    SleepConditionVariableSRW(&cond->handle, &mutex->handle, INFINITE, 0);
+}
+
+void broadcast_os_cond(OsCond cond) {
+    WakeAllConditionVariable(&cond->handle);
+}
+
+void drop_os_cond(OsCond cond) {
+    free(cond);
+}
+
+// The interlocked functions are full barriers on every architecture
+
+uint32_t os_atomic_add_u32(volatile uint32_t *value, uint32_t addend) {
+    return AS(InterlockedExchangeAdd(AS(value, volatile LONG*), AS(addend, LONG)), uint32_t);
+}
+
+bool os_atomic_cas_u32(volatile uint32_t *value, uint32_t *expected, uint32_t new_value) {
+    uint32_t previous = AS(
+        InterlockedCompareExchange(AS(value, volatile LONG*), AS(new_value, LONG), AS(*expected, LONG)),
+        uint32_t
+    );
+
+    if (previous == *expected)
+        return true;
+
+    *expected = previous;
+    return false;
+}
+
+uint32_t os_atomic_load_u32(volatile uint32_t *value) {
+    return AS(InterlockedOr(AS(value, volatile LONG*), 0), uint32_t);
+}
+
+void os_atomic_store_u32(volatile uint32_t *value, uint32_t new_value) {
+    InterlockedExchange(AS(value, volatile LONG*), AS(new_value, LONG));
+}
+
+Handle os_atomic_load_ptr(Handle volatile *ptr) {
+    return InterlockedCompareExchangePointer(ptr, NULL, NULL);
+}
+
+void os_atomic_store_ptr(Handle volatile *ptr, Handle new_ptr) {
+    InterlockedExchangePointer(ptr, new_ptr);
+}
+
+Handle os_atomic_exchange_ptr(Handle volatile *ptr, Handle new_ptr) {
+    return InterlockedExchangePointer(ptr, new_ptr);
+}
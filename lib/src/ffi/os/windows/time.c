@@ -0,0 +1,18 @@
+#include <Windows.h>
+
+#include "ffi/os/time.h"
+
+uint64_t now_ns() {
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter = { 0 };
+
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+
+    QueryPerformanceCounter(&counter);
+
+    return (uint64_t)(
+        (counter.QuadPart / frequency.QuadPart) * NS_PER_SEC
+        + (counter.QuadPart % frequency.QuadPart) * NS_PER_SEC / frequency.QuadPart
+    );
+}
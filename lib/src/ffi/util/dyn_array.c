@@ -10,6 +10,8 @@ Result ___apriori_impl_new_dyn_array(uint32_t count, size_t element_size) {
     array->count = count;
     array->data = AS(array, Bytes) + sizeof(DynArrayT);
 
+    result.object = array;
+
     FN_FORCE_EXIT(result);
 }
 
@@ -33,17 +35,14 @@ Result ___apriori_impl_combine_dyn_arrays(DynArray arrays, uint32_t arrays_count
     data = combined_array->data;
 
     for (uint32_t i = 0; i < arrays_count; ++i) {
-        errno_t copy_result = memcpy_s(
-            data,
-            combined_size,
-            arrays[i].data,
-            arrays[i].count
-        );
+        size_t array_size = arrays[i].count * element_size;
 
-        assert(copy_result == 0 && "unable to combine dyn arrays");
+        assert(array_size <= combined_size && "unable to combine dyn arrays");
 
-        data += element_size;
-        combined_size -= element_size;
+        memcpy(data, arrays[i].data, array_size);
+
+        data += array_size;
+        combined_size -= array_size;
     }
 
     FN_EXIT(result);
@@ -68,14 +67,9 @@ Result ___apriori_impl_new_array_from_object(void *object, uint32_t count, size_
     data = array->data;
 
     for (uint32_t i = 0; i < count; ++i) {
-        errno_t copy_error = memcpy_s(
-            data,
-            data_size,
-            object,
-            element_size
-        );
-
-        assert(copy_error == 0 && "unable to copy object into array");
+        assert(element_size <= data_size && "unable to copy object into array");
+
+        memcpy(data, object, element_size);
 
         data += element_size;
         data_size -= element_size;
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "file.h"
+#include "mod.h"
+
+#include "ffi/os/file.h"
+
+#define TMP_FILE_SUFFIX ".tmp"
+
+Result read_binary_file(const char *path) {
+    ASSERT_NOT_NULL(path);
+
+    Result result = { 0 };
+    DynArray content = NULL;
+    long file_size = 0;
+
+    FILE *file = fopen(path, "rb");
+    UNWRAP_NOT_NULL(result, FILE_IO, file);
+
+    if (fseek(file, 0, SEEK_END) != 0 || (file_size = ftell(file)) < 0) {
+        result.error = FILE_IO;
+        EXPECT_SUCCESS(result);
+    }
+
+    rewind(file);
+
+    result = NEW_DYN_ARRAY(Byte, (uint32_t)file_size);
+    RESULT_UNWRAP(content, result);
+
+    if (fread(content->data, 1, (size_t)file_size, file) != (size_t)file_size) {
+        result.error = FILE_IO;
+        EXPECT_SUCCESS(result);
+    }
+
+    result.object = content;
+
+    FN_EXIT(result, {
+        if (file != NULL)
+            fclose(file);
+    });
+
+    FN_FAILURE(result, {
+        free(content);
+    });
+}
+
+Result write_binary_file(const char *path, const void *data, size_t size) {
+    ASSERT_NOT_NULL(path);
+    ASSERT_NOT_NULL(data);
+
+    Result result = { 0 };
+
+    FILE *file = fopen(path, "wb");
+    UNWRAP_NOT_NULL(result, FILE_IO, file);
+
+    if (fwrite(data, 1, size, file) != size) {
+        result.error = FILE_IO;
+        EXPECT_SUCCESS(result);
+    }
+
+    // The buffered data is written by `fclose`, its failure is a write failure too
+    FILE *closed_file = file;
+    file = NULL;
+
+    if (fclose(closed_file) != 0) {
+        result.error = FILE_IO;
+        EXPECT_SUCCESS(result);
+    }
+
+    result.object = NULL;
+
+    FN_FORCE_EXIT(result, {
+        if (file != NULL)
+            fclose(file);
+    });
+}
+
+Result replace_binary_file(const char *path, const void *data, size_t size) {
+    ASSERT_NOT_NULL(path);
+    ASSERT_NOT_NULL(data);
+
+    Result result = { 0 };
+    size_t path_len = strlen(path);
+
+    char *tmp_path = ALLOC_ARRAY_UNINIT(result, char, path_len + sizeof(TMP_FILE_SUFFIX));
+
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, TMP_FILE_SUFFIX, sizeof(TMP_FILE_SUFFIX));
+
+    result = write_binary_file(tmp_path, data, size);
+    EXPECT_SUCCESS(result);
+
+    if (!replace_os_file(tmp_path, path)) {
+        result.error = FILE_IO;
+        EXPECT_SUCCESS(result);
+    }
+
+    result.object = NULL;
+
+    FN_FORCE_EXIT(result, {
+        // The partially written or not renamed temporary file
+        if (tmp_path != NULL && result.error != SUCCESS)
+            remove(tmp_path);
+
+        free(tmp_path);
+    });
+}
@@ -0,0 +1,17 @@
+#ifndef ___APRIORI2_UTIL_FILE_H___
+#define ___APRIORI2_UTIL_FILE_H___
+
+#include <stddef.h>
+
+#include "ffi/core/result.h"
+
+// Reads the whole file into the DynArray of bytes
+Result read_binary_file(const char *path);
+
+Result write_binary_file(const char *path, const void *data, size_t size);
+
+// Writes the data next to the file and renames it over the file:
+// an interrupted write leaves the old file intact
+Result replace_binary_file(const char *path, const void *data, size_t size);
+
+#endif // ___APRIORI2_UTIL_FILE_H___
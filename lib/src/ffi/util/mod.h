@@ -5,6 +5,7 @@
 #include <stdbool.h>
 
 #include "dyn_array.h"
+#include "file.h"
 
 #define ASSERT_NOT_NULL(ptr) assert((ptr) != NULL && #ptr " must be not NULL")
 
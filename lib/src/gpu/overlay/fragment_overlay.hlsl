@@ -1,12 +1,58 @@
 #pragma shader_stage fragment
+#pragma shader_variant OVL_BINDLESS
 
 #include "ffi/graphics/gpu.h"
 #include "ffi/graphics/pipeline/overlay/gpu_info.h"
 
+#if OVL_BINDLESS
+#   include "ffi/graphics/pipeline/bindless_info.h"
+#   include "ffi/graphics/pipeline/overlay/vertex_overlay.h"
+
+// The atlas pages are selected by the bindless slot from the push constants
+vk_binding(BINDLESS_TEXTURES_BINDING, OVL_DESCR_SET)
+Texture2D bindless_textures[BINDLESS_MAX_TEXTURES];
+
+vk_binding(BINDLESS_SAMPLERS_BINDING, OVL_DESCR_SET)
+SamplerState bindless_samplers[BINDLESS_SAMPLER_COUNT];
+
+[[vk::push_constant]]
+PushConstantsOVL push_constants;
+#else
+vk_binding(OVL_ATLAS_DESCR_BINDING, OVL_DESCR_SET)
+Texture2D atlas;
+
+vk_binding(OVL_SAMPLER_DESCR_BINDING, OVL_DESCR_SET)
+SamplerState atlas_sampler;
+#endif // OVL_BINDLESS
+
+// A specialization constant: the disabled test is removed by the driver
+vk_constant_id(OVL_ALPHA_TEST_CONSTANT_ID)
+const bool alpha_test = false;
+
+// The texture coordinates are in texels (the sampler uses unnormalized coordinates),
+// such a sampler supports the explicit LOD only
 float4 main(
     vk_location(OVL_FRAGMENT_INPUT_LOCATION_COLOR)
-    float4 color semantics(COLOR)
+    float4 color semantics(COLOR),
+
+    vk_location(OVL_FRAGMENT_INPUT_LOCATION_TEXTURE)
+    float2 tex semantics(TEXCOORD)
 ) semantics(SV_TARGET)
 {
-    return color;
+#if OVL_BINDLESS
+    float4 texel = bindless_textures[push_constants.texture_idx].SampleLevel(
+        bindless_samplers[BINDLESS_SAMPLER_TEXEL],
+        tex,
+        0
+    );
+#else
+    float4 texel = atlas.SampleLevel(atlas_sampler, tex, 0);
+#endif // OVL_BINDLESS
+
+    float4 out_color = color * texel;
+
+    if (alpha_test && out_color.a < OVL_ALPHA_TEST_THRESHOLD)
+        discard;
+
+    return out_color;
 }
@@ -1,3 +1,29 @@
 #pragma shader_stage vertex
 
+#include "ffi/graphics/gpu.h"
 #include "ffi/graphics/pipeline/overlay/vertex_overlay.h"
+
+[[vk::push_constant]]
+PushConstantsOVL push_constants;
+
+struct VertexOutput {
+    float4 position semantics(SV_POSITION);
+
+    vk_location(OVL_FRAGMENT_INPUT_LOCATION_COLOR)
+    float4 color semantics(COLOR);
+
+    vk_location(OVL_FRAGMENT_INPUT_LOCATION_TEXTURE)
+    float2 tex semantics(TEXCOORD);
+};
+
+VertexOutput main(VertexOVL vertex) {
+    VertexOutput output;
+
+    float2 pos = float2(vertex.pos) * OVL_POS_SCALE;
+
+    output.position = float4(pos * push_constants.scale + push_constants.translate, 0.0, 1.0);
+    output.color = vertex.color;
+    output.tex = float2(vertex.tex);
+
+    return output;
+}
@@ -1,3 +1,28 @@
 pub mod renderer;
 
-pub use renderer::Renderer;
+#[cfg(feature = "shader-hot-reload")]
+mod shader_hot_reload;
+
+pub use renderer::{
+    Renderer,
+    RendererCreateParams,
+    PresentPolicy,
+    PresentMode,
+    SwapchainInfo,
+    FrameStats,
+    GpuProfile,
+    GpuScopeTiming,
+    PipelineStats,
+    PassStats,
+    OverlayQuad,
+    OverlayRect,
+    OverlayScissor,
+    OverlayStats,
+    OverlayImageId,
+    OverlayAtlasStats,
+    DescrAllocatorStats,
+    UploadStats,
+    GpuHeapStats,
+    PipelineCacheStats,
+    PipelineCreationTime,
+};
@@ -1,12 +1,404 @@
-use crate::{
-    ffi,
-    os::{self, WindowMethods},
-    core::{Result, VulkanInstance},
-    io,
+use {
+    std::{
+        ffi::{CString, CStr},
+        fmt,
+        path::PathBuf,
+        time::Duration,
+    },
+    crate::{
+        ffi,
+        os::{self, WindowMethods},
+        core::{Result, VulkanInstance},
+        io,
+    }
 };
 
+pub struct RendererCreateParams {
+    /// Path to the on-disk pipeline cache.
+    /// The pipeline cache is not persistent if `None`.
+    pub pipeline_cache_path: Option<PathBuf>,
+
+    /// How many frames the CPU can record ahead of the GPU
+    pub frames_in_flight: u32,
+
+    pub present_policy: PresentPolicy,
+
+    /// Threads recording the frame commands (including the rendering one),
+    /// 0 picks the default for the machine
+    pub record_thread_count: u32,
+
+    /// Selects the textures through a single bindless descriptor set
+    /// if the device supports the descriptor indexing
+    pub bindless: bool,
+
+    /// Discards the almost transparent overlay fragments
+    /// instead of blending them (a specialization constant of the overlay pipeline)
+    pub overlay_alpha_test: bool,
+}
+
+impl Default for RendererCreateParams {
+    fn default() -> Self {
+        Self {
+            pipeline_cache_path: Some(PathBuf::from("apriori2.pipeline.cache")),
+            frames_in_flight: 2,
+            present_policy: PresentPolicy::Throughput,
+            record_thread_count: 0,
+            bindless: true,
+            overlay_alpha_test: false,
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum PresentPolicy {
+    /// IMMEDIATE or MAILBOX present mode with (min + 1) swapchain images
+    LowLatency,
+
+    /// FIFO present mode with triple buffering
+    Throughput,
+
+    /// FIFO_RELAXED present mode with the minimal swapchain image count
+    PowerSaving,
+}
+
+impl PresentPolicy {
+    fn from_ffi(policy: ffi::PresentPolicy) -> Self {
+        match policy {
+            ffi::PresentPolicy_PRESENT_POLICY_LOW_LATENCY => Self::LowLatency,
+            ffi::PresentPolicy_PRESENT_POLICY_POWER_SAVING => Self::PowerSaving,
+            _ => Self::Throughput,
+        }
+    }
+
+    fn to_ffi(self) -> ffi::PresentPolicy {
+        match self {
+            Self::LowLatency => ffi::PresentPolicy_PRESENT_POLICY_LOW_LATENCY,
+            Self::Throughput => ffi::PresentPolicy_PRESENT_POLICY_THROUGHPUT,
+            Self::PowerSaving => ffi::PresentPolicy_PRESENT_POLICY_POWER_SAVING,
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum PresentMode {
+    Immediate,
+    Mailbox,
+    Fifo,
+    FifoRelaxed,
+}
+
+impl PresentMode {
+    fn from_ffi(present_mode: ffi::PresentMode) -> Option<Self> {
+        match present_mode {
+            ffi::PresentMode_PRESENT_MODE_IMMEDIATE => Some(Self::Immediate),
+            ffi::PresentMode_PRESENT_MODE_MAILBOX => Some(Self::Mailbox),
+            ffi::PresentMode_PRESENT_MODE_FIFO => Some(Self::Fifo),
+            ffi::PresentMode_PRESENT_MODE_FIFO_RELAXED => Some(Self::FifoRelaxed),
+            _ => None
+        }
+    }
+}
+
+/// What the swapchain actually got for the requested present policy
+#[derive(Debug, Clone, Copy)]
+pub struct SwapchainInfo {
+    pub policy: PresentPolicy,
+
+    /// `None` if the swapchain is offscreen (it is never presented)
+    pub present_mode: Option<PresentMode>,
+
+    pub image_count: u32,
+    pub image_width: u32,
+    pub image_height: u32,
+}
+
+#[derive(Debug, Clone, Copy)]
+pub enum PipelineCreationTime {
+    /// Pipelines were created without the on-disk cache data
+    Cold(Duration),
+
+    /// Pipelines were created using the on-disk cache data
+    Warm(Duration),
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct PipelineCacheStats {
+    pub creation_time: PipelineCreationTime,
+    pub loaded_data_size: u64,
+}
+
+/// In pixels, the origin is the top left corner of the render target
+#[derive(Debug, Clone, Copy, Default)]
+pub struct OverlayRect {
+    pub x: f32,
+    pub y: f32,
+    pub width: f32,
+    pub height: f32,
+}
+
+impl OverlayRect {
+    fn to_ffi(&self) -> ffi::OverlayRect {
+        ffi::OverlayRect {
+            x: self.x,
+            y: self.y,
+            width: self.width,
+            height: self.height,
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy, Default)]
+pub struct OverlayScissor {
+    pub x: i32,
+    pub y: i32,
+    pub width: u32,
+    pub height: u32,
+}
+
+#[derive(Debug, Clone, Copy, Default)]
+pub struct OverlayQuad {
+    pub rect: OverlayRect,
+
+    /// In texels of the image, the origin is the top left corner of the image
+    pub tex_rect: OverlayRect,
+
+    /// Multiplies the image texels
+    pub color: [f32; 4],
+
+    /// `OverlayImageId` of the image, 0 means untextured.
+    /// The removed and evicted images are drawn untextured.
+    pub texture_id: u32,
+
+    /// Quads are drawn from the lowest layer to the highest one,
+    /// the order inside of a layer is unspecified
+    pub layer: u32,
+
+    /// `None` means the whole render target
+    pub scissor: Option<OverlayScissor>,
+}
+
+impl OverlayQuad {
+    fn to_ffi(&self) -> ffi::OverlayQuad {
+        let scissor = self.scissor.unwrap_or_default();
+
+        ffi::OverlayQuad {
+            rect: self.rect.to_ffi(),
+            tex_rect: self.tex_rect.to_ffi(),
+            color: self.color,
+            texture_id: self.texture_id,
+            layer: self.layer,
+            scissor: ffi::OverlayScissor {
+                x: scissor.x,
+                y: scissor.y,
+                width: scissor.width,
+                height: scissor.height,
+            },
+        }
+    }
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct OverlayStats {
+    pub quad_count: u32,
+    pub draw_call_count: u32,
+
+    /// Quads beyond the overlay draw list capacity
+    pub dropped_quad_count: u32,
+}
+
+/// Refers to an image packed into the overlay atlas
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub struct OverlayImageId(pub u32);
+
+#[derive(Debug, Clone, Copy)]
+pub struct OverlayAtlasStats {
+    pub page_count: u32,
+    pub page_size: u32,
+    pub image_count: u32,
+
+    /// Texels covered by the packed images (including the padding)
+    pub used_texel_count: u64,
+
+    /// Texels uploaded with the last frame
+    pub frame_uploaded_texel_count: u64,
+
+    pub eviction_count: u64,
+}
+
+impl OverlayAtlasStats {
+    pub fn occupancy(&self) -> f64 {
+        let page_texel_count = self.page_size as u64 * self.page_size as u64;
+        let total_texel_count = page_texel_count * self.page_count as u64;
+
+        if total_texel_count == 0 {
+            return 0.0;
+        }
+
+        self.used_texel_count as f64 / total_texel_count as f64
+    }
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct DescrAllocatorStats {
+    /// Descriptor pools of all the frame slots
+    pub pool_count: u32,
+
+    /// Pools added to the exhausted frame slots
+    pub grow_count: u64,
+
+    /// Transient descriptor sets of the current frame
+    pub frame_set_count: u32,
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct UploadStats {
+    pub ring_size: u64,
+
+    /// The last submitted upload batch
+    pub frame_uploaded_bytes: u64,
+    pub frame_copy_count: u32,
+
+    pub total_uploaded_bytes: u64,
+    pub submit_count: u64,
+
+    /// Uploads which blocked waiting for the GPU to free the ring space
+    pub stall_count: u64,
+
+    /// Batches copied on the graphics queue: overwriting the data of the frames in flight
+    /// or not aligned to the transfer queue granularity
+    pub fallback_count: u64,
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct GpuHeapStats {
+    pub heap_size: u64,
+    pub is_device_local: bool,
+
+    /// Device memory objects allocated from the heap
+    pub block_count: u32,
+    pub allocated_size: u64,
+
+    /// Sub-allocations inside of the blocks
+    pub allocation_count: u32,
+    pub used_size: u64,
+}
+
+#[derive(Debug, Clone)]
+pub struct GpuScopeTiming {
+    pub name: String,
+
+    /// Nesting level inside of the frame
+    pub depth: u32,
+
+    pub time: Duration,
+
+    /// Over the last frames the scope was recorded in
+    pub avg_time: Duration,
+}
+
+/// GPU time of the scopes of a single frame.
+/// The frame is resolved a few frames later, so the numbers lag behind.
+#[derive(Debug, Clone)]
+pub struct GpuProfile {
+    pub frame_number: u64,
+
+    /// In the recording order
+    pub scopes: Vec<GpuScopeTiming>,
+}
+
+impl fmt::Display for GpuProfile {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        writeln!(f, "GPU frame #{}", self.frame_number)?;
+        writeln!(f, "{:<32} {:>10} {:>10}", "scope", "ms", "avg ms")?;
+
+        for scope in &self.scopes {
+            let name = format!("{:indent$}{}", "", scope.name, indent = scope.depth as usize * 2);
+
+            writeln!(
+                f,
+                "{:<32} {:>10.3} {:>10.3}",
+                name,
+                scope.time.as_secs_f64() * 1000.0,
+                scope.avg_time.as_secs_f64() * 1000.0
+            )?;
+        }
+
+        Ok(())
+    }
+}
+
+#[derive(Debug, Clone)]
+pub struct PassStats {
+    pub name: String,
+
+    pub input_vertices: u64,
+    pub input_primitives: u64,
+    pub vertex_invocations: u64,
+    pub clipping_invocations: u64,
+    pub clipping_primitives: u64,
+    pub fragment_invocations: u64,
+
+    /// Render area of the pass
+    pub pixel_count: u64,
+}
+
+impl PassStats {
+    /// Fragment shader invocations per pixel of the render area
+    pub fn overdraw(&self) -> f64 {
+        if self.pixel_count == 0 {
+            return 0.0;
+        }
+
+        self.fragment_invocations as f64 / self.pixel_count as f64
+    }
+}
+
+/// Pipeline statistics of the passes of a single frame.
+/// Like `GpuProfile`, the frame is resolved a few frames later.
+#[derive(Debug, Clone)]
+pub struct PipelineStats {
+    pub frame_number: u64,
+
+    /// In the recording order
+    pub passes: Vec<PassStats>,
+}
+
+#[derive(Debug, Clone, Copy)]
+pub struct FrameStats {
+    pub frame_count: u64,
+    pub frames_in_flight: u32,
+
+    /// Time between the starts of the two last frames
+    pub frame_time: Duration,
+
+    /// Time the CPU was blocked waiting for the GPU
+    pub fence_wait_time: Duration,
+
+    /// Time the CPU spent on acquiring, recording, submitting and presenting
+    pub cpu_time: Duration,
+
+    pub avg_frame_time: Duration,
+    pub avg_fence_wait_time: Duration,
+    pub avg_cpu_time: Duration,
+}
+
+impl FrameStats {
+    /// The fraction of the frame time during which the CPU was not blocked by the GPU.
+    /// 1.0 means the CPU work fully overlaps with the GPU work of the previous frames.
+    pub fn cpu_gpu_overlap(&self) -> f64 {
+        if self.avg_frame_time.is_zero() {
+            return 0.0;
+        }
+
+        1.0 - self.avg_fence_wait_time.as_secs_f64() / self.avg_frame_time.as_secs_f64()
+    }
+}
+
 pub struct Renderer {
-    renderer_ffi: ffi::Renderer
+    renderer_ffi: ffi::Renderer,
+
+    #[cfg(feature = "shader-hot-reload")]
+    shader_hot_reload: Option<super::shader_hot_reload::ShaderHotReload>,
 }
 
 impl Renderer {
@@ -15,6 +407,7 @@ impl Renderer {
     pub fn new<Id: io::InputId>(
         vk_instance: &VulkanInstance,
         window: &os::Window<Id>,
+        params: &RendererCreateParams,
     ) -> Result<Self> {
         log::info! {
             target: Self::LOG_TARGET,
@@ -23,6 +416,21 @@ impl Renderer {
 
         let size = window.size()?;
 
+        let pipeline_cache_path = match &params.pipeline_cache_path {
+            Some(path) => Some(CString::new(path.to_string_lossy().as_bytes())?),
+            None => None
+        };
+
+        let mut params_ffi = ffi::RendererCreateParams {
+            pipeline_cache_path: pipeline_cache_path.as_ref()
+                .map_or(std::ptr::null(), |path| path.as_ptr()),
+            frames_in_flight: params.frames_in_flight,
+            present_policy: params.present_policy.to_ffi(),
+            record_thread_count: params.record_thread_count,
+            disable_bindless: !params.bindless,
+            overlay_alpha_test: params.overlay_alpha_test,
+        };
+
         let renderer;
         unsafe {
             renderer = Self {
@@ -30,8 +438,12 @@ impl Renderer {
                     vk_instance.instance_ffi,
                     window.platform_handle(),
                     size.width,
-                    size.height
-                ).try_unwrap()?
+                    size.height,
+                    &mut params_ffi
+                ).try_unwrap()?,
+
+                #[cfg(feature = "shader-hot-reload")]
+                shader_hot_reload: None,
             }
         }
 
@@ -42,12 +454,341 @@ impl Renderer {
 
         Ok(renderer)
     }
+
+    pub fn draw_frame(&mut self) -> Result<()> {
+        let _zone = crate::profile_zone!("draw_frame");
+
+        unsafe {
+            ffi::renderer_draw_frame(self.renderer_ffi).try_unwrap::<()>()?;
+        }
+
+        Ok(())
+    }
+
+    /// Queues the quads for the next frame.
+    /// The quads of all the panels are batched into as few draw calls as possible.
+    pub fn draw_overlay(&mut self, quads: &[OverlayQuad]) {
+        let quads_ffi: Vec<_> = quads.iter()
+            .map(OverlayQuad::to_ffi)
+            .collect();
+
+        unsafe {
+            ffi::renderer_draw_overlay(self.renderer_ffi, quads_ffi.as_ptr(), quads_ffi.len() as u32);
+        }
+    }
+
+    /// Packs the RGBA8 image into the overlay atlas.
+    /// Evicts the least recently drawn atlas page if there is no room for the image.
+    /// Fails if the image is empty.
+    pub fn add_overlay_image(&mut self, width: u32, height: u32, pixels: &[u8]) -> Result<OverlayImageId> {
+        assert_eq!(pixels.len(), width as usize * height as usize * 4, "RGBA8 pixels expected");
+
+        let mut image_id = 0;
+        unsafe {
+            ffi::renderer_add_overlay_image(
+                self.renderer_ffi,
+                width,
+                height,
+                pixels.as_ptr() as *const _,
+                &mut image_id
+            ).try_unwrap::<()>()?;
+        }
+
+        Ok(OverlayImageId(image_id))
+    }
+
+    /// Uploads the changed region of the image only.
+    /// Fails if the region is empty or not inside of the image.
+    pub fn update_overlay_image(
+        &mut self,
+        image_id: OverlayImageId,
+        region: &OverlayScissor,
+        pixels: &[u8]
+    ) -> Result<()> {
+        assert_eq!(
+            pixels.len(),
+            region.width as usize * region.height as usize * 4,
+            "RGBA8 pixels expected"
+        );
+
+        unsafe {
+            ffi::renderer_update_overlay_image(
+                self.renderer_ffi,
+                image_id.0,
+                region.x,
+                region.y,
+                region.width,
+                region.height,
+                pixels.as_ptr() as *const _
+            ).try_unwrap::<()>()?;
+        }
+
+        Ok(())
+    }
+
+    pub fn remove_overlay_image(&mut self, image_id: OverlayImageId) {
+        unsafe {
+            ffi::renderer_remove_overlay_image(self.renderer_ffi, image_id.0);
+        }
+    }
+
+    /// `false` if the image was removed or evicted (it has to be added again)
+    pub fn is_overlay_image_resident(&self, image_id: OverlayImageId) -> bool {
+        unsafe {
+            ffi::renderer_is_overlay_image_resident(self.renderer_ffi, image_id.0)
+        }
+    }
+
+    /// False if the renderer fell back to the per-resource descriptor sets
+    pub fn is_bindless(&self) -> bool {
+        unsafe {
+            ffi::renderer_is_bindless(self.renderer_ffi)
+        }
+    }
+
+    /// Requests the swapchain recreation.
+    /// Several resizes between two frames are collapsed into a single recreation.
+    pub fn resize(&mut self, size: &os::WindowSize) {
+        log::trace! {
+            target: Self::LOG_TARGET,
+            "resize requested: {}", size
+        }
+
+        unsafe {
+            ffi::renderer_resize(self.renderer_ffi, size.width, size.height);
+        }
+    }
+
+    pub fn swapchain_info(&self) -> SwapchainInfo {
+        let info;
+        unsafe {
+            info = ffi::renderer_swapchain_info(self.renderer_ffi);
+        }
+
+        SwapchainInfo {
+            policy: PresentPolicy::from_ffi(info.policy),
+            present_mode: PresentMode::from_ffi(info.present_mode),
+            image_count: info.image_count,
+            image_width: info.image_width,
+            image_height: info.image_height,
+        }
+    }
+
+    pub fn frame_stats(&self) -> FrameStats {
+        let stats;
+        unsafe {
+            stats = ffi::renderer_frame_stats(self.renderer_ffi);
+        }
+
+        let avg = |total_ns: u64, count: u64| match count {
+            0 => Duration::default(),
+            count => Duration::from_nanos(total_ns / count)
+        };
+
+        // The frame time is known starting from the second frame only
+        let frame_intervals = stats.frame_count.saturating_sub(1);
+
+        FrameStats {
+            frame_count: stats.frame_count,
+            frames_in_flight: stats.frames_in_flight,
+            frame_time: Duration::from_nanos(stats.frame_time_ns),
+            fence_wait_time: Duration::from_nanos(stats.fence_wait_time_ns),
+            cpu_time: Duration::from_nanos(stats.cpu_time_ns),
+            avg_frame_time: avg(stats.total_frame_time_ns, frame_intervals),
+            avg_fence_wait_time: avg(stats.total_fence_wait_time_ns, stats.frame_count),
+            avg_cpu_time: avg(stats.total_cpu_time_ns, stats.frame_count),
+        }
+    }
+
+    pub fn overlay_stats(&self) -> OverlayStats {
+        let stats;
+        unsafe {
+            stats = ffi::renderer_overlay_stats(self.renderer_ffi);
+        }
+
+        OverlayStats {
+            quad_count: stats.quad_count,
+            draw_call_count: stats.draw_call_count,
+            dropped_quad_count: stats.dropped_quad_count,
+        }
+    }
+
+    pub fn overlay_atlas_stats(&self) -> OverlayAtlasStats {
+        let stats;
+        unsafe {
+            stats = ffi::renderer_overlay_atlas_stats(self.renderer_ffi);
+        }
+
+        OverlayAtlasStats {
+            page_count: stats.page_count,
+            page_size: stats.page_size,
+            image_count: stats.image_count,
+            used_texel_count: stats.used_texel_count,
+            frame_uploaded_texel_count: stats.frame_uploaded_texel_count,
+            eviction_count: stats.eviction_count,
+        }
+    }
+
+    /// `None` if the graphics queue doesn't support timestamps
+    pub fn gpu_profile(&self) -> Option<GpuProfile> {
+        let stats;
+        unsafe {
+            stats = ffi::renderer_gpu_profiler_stats(self.renderer_ffi);
+        }
+
+        if !stats.is_supported {
+            return None;
+        }
+
+        let scopes = stats.scopes[..stats.scope_count as usize]
+            .iter()
+            .map(|scope| GpuScopeTiming {
+                // The scope names are static C strings
+                name: unsafe { CStr::from_ptr(scope.name) }.to_string_lossy().into_owned(),
+                depth: scope.depth,
+                time: Duration::from_nanos(scope.time_ns),
+                avg_time: Duration::from_nanos(scope.avg_time_ns),
+            })
+            .collect();
+
+        Some(GpuProfile {
+            frame_number: stats.frame_number,
+            scopes,
+        })
+    }
+
+    /// Watches the shader sources of the crate (`src/gpu`) and rebuilds the pipelines
+    /// using the changed shaders in the background. The rebuilt pipelines are swapped in
+    /// at a frame boundary, the frames don't wait for the compilation.
+    #[cfg(feature = "shader-hot-reload")]
+    pub fn enable_shader_hot_reload(&mut self) -> Result<()> {
+        if self.shader_hot_reload.is_none() {
+            self.shader_hot_reload = Some(
+                super::shader_hot_reload::ShaderHotReload::new(self.renderer_ffi)?
+            );
+        }
+
+        Ok(())
+    }
+
+    /// The counters are disabled by default and ignored if the device doesn't support them
+    pub fn set_pipeline_stats_enabled(&mut self, is_enabled: bool) {
+        unsafe {
+            ffi::renderer_set_pipeline_stats_enabled(self.renderer_ffi, is_enabled);
+        }
+    }
+
+    /// `None` if the counters are unsupported, disabled or not resolved yet
+    pub fn pipeline_stats(&self) -> Option<PipelineStats> {
+        let stats;
+        unsafe {
+            stats = ffi::renderer_pipeline_stats(self.renderer_ffi);
+        }
+
+        if !stats.is_supported || !stats.is_enabled || stats.pass_count == 0 {
+            return None;
+        }
+
+        let passes = stats.passes[..stats.pass_count as usize]
+            .iter()
+            .map(|pass| PassStats {
+                // The pass names are static C strings
+                name: unsafe { CStr::from_ptr(pass.name) }.to_string_lossy().into_owned(),
+                input_vertices: pass.input_vertex_count,
+                input_primitives: pass.input_primitive_count,
+                vertex_invocations: pass.vertex_invocation_count,
+                clipping_invocations: pass.clipping_invocation_count,
+                clipping_primitives: pass.clipping_primitive_count,
+                fragment_invocations: pass.fragment_invocation_count,
+                pixel_count: pass.pixel_count,
+            })
+            .collect();
+
+        Some(PipelineStats {
+            frame_number: stats.frame_number,
+            passes,
+        })
+    }
+
+    pub fn descr_allocator_stats(&self) -> DescrAllocatorStats {
+        let stats;
+        unsafe {
+            stats = ffi::renderer_descr_allocator_stats(self.renderer_ffi);
+        }
+
+        DescrAllocatorStats {
+            pool_count: stats.pool_count,
+            grow_count: stats.grow_count,
+            frame_set_count: stats.frame_set_count,
+        }
+    }
+
+    pub fn upload_stats(&self) -> UploadStats {
+        let stats;
+        unsafe {
+            stats = ffi::renderer_upload_stats(self.renderer_ffi);
+        }
+
+        UploadStats {
+            ring_size: stats.ring_size,
+            frame_uploaded_bytes: stats.frame_uploaded_bytes,
+            frame_copy_count: stats.frame_copy_count,
+            total_uploaded_bytes: stats.total_uploaded_bytes,
+            submit_count: stats.submit_count,
+            stall_count: stats.stall_count,
+            fallback_count: stats.fallback_count,
+        }
+    }
+
+    pub fn gpu_memory_stats(&self) -> Vec<GpuHeapStats> {
+        let stats;
+        unsafe {
+            stats = ffi::renderer_gpu_memory_stats(self.renderer_ffi);
+        }
+
+        stats.heaps[..stats.heap_count as usize]
+            .iter()
+            .map(|heap| GpuHeapStats {
+                heap_size: heap.heap_size,
+                is_device_local: heap.is_device_local,
+                block_count: heap.block_count,
+                allocated_size: heap.allocated_size,
+                allocation_count: heap.allocation_count,
+                used_size: heap.used_size,
+            })
+            .collect()
+    }
+
+    pub fn pipeline_cache_stats(&self) -> PipelineCacheStats {
+        let stats;
+        unsafe {
+            stats = ffi::renderer_pipeline_cache_stats(self.renderer_ffi);
+        }
+
+        let creation_time = Duration::from_nanos(stats.creation_time_ns);
+        let creation_time = if stats.is_warm {
+            PipelineCreationTime::Warm(creation_time)
+        } else {
+            PipelineCreationTime::Cold(creation_time)
+        };
+
+        PipelineCacheStats {
+            creation_time,
+            loaded_data_size: stats.loaded_data_size,
+        }
+    }
 }
 
 impl Drop for Renderer {
     fn drop(&mut self) {
+        // The watcher rebuilds the pipelines of the renderer
+        #[cfg(feature = "shader-hot-reload")]
+        {
+            self.shader_hot_reload = None;
+        }
+
         unsafe  {
             ffi::drop_renderer(self.renderer_ffi);
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,233 @@
+use {
+    std::{
+        fs,
+        thread,
+        path::{Path, PathBuf},
+        time::{Duration, SystemTime},
+        sync::{
+            Arc,
+            atomic::{AtomicBool, Ordering},
+        },
+    },
+    crate::{
+        ffi,
+        core::{Result, AssumeThreadSafe},
+    }
+};
+
+const POLL_INTERVAL: Duration = Duration::from_millis(250);
+
+// Relative to the shader root, the same as in the build
+const OVERLAY_VERTEX_SHADER: &'static str = "gpu/overlay/vertex_overlay.hlsl";
+const OVERLAY_FRAGMENT_SHADER: &'static str = "gpu/overlay/fragment_overlay.hlsl";
+
+/// Watches the shader sources of the overlay pipeline (the shaders and their includes).
+/// A change is compiled and the pipeline is rebuilt on the watcher thread,
+/// the renderer swaps the new pipeline in at the next frame boundary.
+/// The frames keep rendering with the old pipeline meanwhile (or if the compilation fails).
+pub(crate) struct ShaderHotReload {
+    is_running: Arc<AtomicBool>,
+    watcher: Option<thread::JoinHandle<()>>,
+}
+
+impl ShaderHotReload {
+    const LOG_TARGET: &'static str = "Rust/ShaderHotReload";
+
+    /// The watcher must be dropped before the renderer
+    pub(crate) fn new(renderer_ffi: ffi::Renderer) -> Result<Self> {
+        let src_path = Path::new(env!("CARGO_MANIFEST_DIR")).join("src");
+        let fragment_variant;
+        unsafe {
+            fragment_variant = ffi::renderer_overlay_fragment_variant(renderer_ffi);
+        }
+
+        log::info! {
+            target: Self::LOG_TARGET,
+            "watching the shader sources in {}", src_path.display()
+        }
+
+        let is_running = Arc::new(AtomicBool::new(true));
+        let renderer_ffi = AssumeThreadSafe::from(renderer_ffi);
+
+        let watcher = thread::Builder::new()
+            .name("shader-hot-reload".to_string())
+            .spawn({
+                let is_running = is_running.clone();
+
+                move || {
+                    let mut overlay = OverlayShaders::new(src_path, fragment_variant);
+
+                    while is_running.load(Ordering::Acquire) {
+                        if overlay.is_changed() {
+                            overlay.reload(*renderer_ffi);
+                        }
+
+                        thread::sleep(POLL_INTERVAL);
+                    }
+                }
+            })?;
+
+        Ok(Self {
+            is_running,
+            watcher: Some(watcher),
+        })
+    }
+}
+
+impl Drop for ShaderHotReload {
+    fn drop(&mut self) {
+        self.is_running.store(false, Ordering::Release);
+
+        if let Some(watcher) = self.watcher.take() {
+            if watcher.join().is_err() {
+                log::error! {
+                    target: Self::LOG_TARGET,
+                    "the shader watcher thread panicked"
+                }
+            }
+        }
+    }
+}
+
+struct OverlayShaders {
+    src_path: PathBuf,
+    fragment_variant: u32,
+
+    // The shaders and their includes with the modification times seen by the last reload
+    dependencies: Vec<(PathBuf, Option<SystemTime>)>,
+}
+
+impl OverlayShaders {
+    fn new(src_path: PathBuf, fragment_variant: u32) -> Self {
+        let mut shaders = Self {
+            src_path,
+            fragment_variant,
+            dependencies: vec![],
+        };
+
+        // The includes are known after the first compilation,
+        // the pipeline built from the embedded shaders is up to date
+        if let Err(err) = shaders.compile_and_watch() {
+            log::error! {
+                target: ShaderHotReload::LOG_TARGET,
+                "{}", err
+            }
+        }
+
+        shaders
+    }
+
+    /// The modification times are taken before the compilation:
+    /// a file saved while the shaders are compiled is reloaded again
+    fn compile_and_watch(&mut self) -> std::result::Result<(Vec<u32>, Vec<u32>), infra::Error> {
+        let compile_start = SystemTime::now();
+
+        let snapshot = if self.dependencies.is_empty() {
+            vec![
+                self.src_path.join(OVERLAY_VERTEX_SHADER),
+                self.src_path.join(OVERLAY_FRAGMENT_SHADER),
+            ]
+            .into_iter()
+            .map(|path| {
+                let modified = modification_time(&path);
+                (path, modified)
+            })
+            .collect()
+        } else {
+            self.dependencies.iter()
+                .map(|(path, _)| (path.clone(), modification_time(path)))
+                .collect::<Vec<_>>()
+        };
+
+        // Retried on the next change, the old pipeline is kept meanwhile
+        self.dependencies = snapshot;
+
+        let (vertex_spirv, fragment_spirv, dependencies) = self.compile()?;
+
+        self.dependencies = dependencies.into_iter()
+            .map(|path| {
+                let modified = match self.dependencies.iter().find(|(known_path, _)| *known_path == path) {
+                    Some((_, modified)) => *modified,
+
+                    // A new include: if it was saved after the compilation started,
+                    // the time never matches, so the shaders are reloaded again
+                    None => modification_time(&path)
+                        .filter(|modified| *modified < compile_start),
+                };
+
+                (path, modified)
+            })
+            .collect();
+
+        Ok((vertex_spirv, fragment_spirv))
+    }
+
+    fn is_changed(&self) -> bool {
+        self.dependencies.iter()
+            .any(|(path, modified)| modification_time(path) != *modified)
+    }
+
+    /// Returns the vertex and the fragment SPIR-V and all the source files they are made of
+    fn compile(&self) -> std::result::Result<(Vec<u32>, Vec<u32>, Vec<PathBuf>), infra::Error> {
+        let vertex_path = self.src_path.join(OVERLAY_VERTEX_SHADER);
+        let fragment_path = self.src_path.join(OVERLAY_FRAGMENT_SHADER);
+
+        let vertex = infra::shader::compile_hot_shader(&self.src_path, &vertex_path, 0)?;
+        let fragment = infra::shader::compile_hot_shader(&self.src_path, &fragment_path, self.fragment_variant)?;
+
+        let mut dependencies = vec![vertex_path, fragment_path];
+        dependencies.extend(vertex.includes);
+        dependencies.extend(fragment.includes);
+        dependencies.sort();
+        dependencies.dedup();
+
+        Ok((vertex.spirv, fragment.spirv, dependencies))
+    }
+
+    fn reload(&mut self, renderer_ffi: ffi::Renderer) {
+        log::info! {
+            target: ShaderHotReload::LOG_TARGET,
+            "the overlay shaders changed, rebuilding the overlay pipeline..."
+        }
+
+        let (vertex_spirv, fragment_spirv) = match self.compile_and_watch() {
+            Ok(output) => output,
+            Err(err) => {
+                log::error! {
+                    target: ShaderHotReload::LOG_TARGET,
+                    "{}", err
+                }
+
+                return;
+            }
+        };
+
+        let result;
+        unsafe {
+            result = ffi::renderer_rebuild_overlay_pipeline(
+                renderer_ffi,
+                vertex_spirv.as_ptr(),
+                (vertex_spirv.len() * std::mem::size_of::<u32>()) as _,
+                fragment_spirv.as_ptr(),
+                (fragment_spirv.len() * std::mem::size_of::<u32>()) as _,
+            ).try_unwrap::<()>();
+        }
+
+        match result {
+            Ok(_) => log::info! {
+                target: ShaderHotReload::LOG_TARGET,
+                "the overlay pipeline is rebuilt, it is used from the next frame"
+            },
+            Err(err) => log::error! {
+                target: ShaderHotReload::LOG_TARGET,
+                "unable to rebuild the overlay pipeline: {}", err
+            },
+        }
+    }
+}
+
+fn modification_time(path: &Path) -> Option<SystemTime> {
+    fs::metadata(path)
+        .and_then(|metadata| metadata.modified())
+        .ok()
+}
@@ -0,0 +1,123 @@
+use crate::{
+    core::Result,
+    os::*,
+    io,
+};
+
+/// Headless (virtual) window.
+///
+/// There is no window system integration on Linux yet,
+/// so the renderer draws into the offscreen swapchain of the window size.
+pub struct Window<Id: io::InputId> {
+    size: WindowSize,
+    input_handler: io::InputHandler<Id>,
+    state_handler: Box<dyn FnMut(WindowState)>,
+}
+
+impl<Id: io::InputId> Window<Id> {
+    const LOG_TARGET: &'static str = "Window";
+
+    pub fn new(
+        title: &str,
+        size: WindowSize,
+        position: WindowPosition
+    ) -> Result<Self> {
+        log::info! {
+            target: Self::LOG_TARGET,
+            "creating new headless window..."
+        };
+
+        log::trace! {
+            target: Self::LOG_TARGET,
+            "\twindow title: \"{}\"",
+            title
+        };
+
+        log::trace! {
+            target: Self::LOG_TARGET,
+            "\twindow size: \"{}\"",
+            size
+        };
+
+        log::trace! {
+            target: Self::LOG_TARGET,
+            "\twindow position: \"{}\"",
+            position
+        };
+
+        let wnd = Self {
+            size,
+            input_handler: io::InputHandler::new(),
+            state_handler: Box::new(|_| { /* do nothing by default */ }),
+        };
+
+        log::info! {
+            target: Self::LOG_TARGET,
+            "new headless window created successfully"
+        };
+
+        Ok(wnd)
+    }
+
+    pub fn resize(&mut self, size: WindowSize) {
+        self.size = WindowSize {
+            width: size.width,
+            height: size.height
+        };
+
+        (self.state_handler)(WindowState::SizeChanged(size));
+    }
+}
+
+impl<Id: io::InputId> Drop for Window<Id> {
+    fn drop(&mut self) {
+        log::debug! {
+            target: Self::LOG_TARGET,
+            "drop headless window"
+        }
+    }
+}
+
+impl<Id: io::InputId> WindowMethods<Id> for Window<Id> {
+    fn show(&self) {
+        log::trace! {
+            target: Self::LOG_TARGET,
+            "show headless window"
+        }
+    }
+
+    fn hide(&self) {
+        log::trace! {
+            target: Self::LOG_TARGET,
+            "hide headless window"
+        }
+    }
+
+    fn size(&self) -> Result<WindowSize> {
+        Ok(
+            WindowSize {
+                width: self.size.width,
+                height: self.size.height
+            }
+        )
+    }
+
+    fn platform_handle(&self) -> ffi::Handle {
+        std::ptr::null_mut()
+    }
+
+    fn input_handler(&self) -> &io::InputHandler<Id> {
+        &self.input_handler
+    }
+
+    fn input_handler_mut(&mut self) -> &mut io::InputHandler<Id> {
+        &mut self.input_handler
+    }
+
+    fn handle_window_state<H>(&mut self, handler: H)
+    where
+        H: FnMut(WindowState) + 'static
+    {
+        self.state_handler = Box::new(handler);
+    }
+}
@@ -9,6 +9,12 @@ pub mod windows;
 #[cfg(target_os = "windows")]
 pub use windows::Window;
 
+#[cfg(target_os = "linux")]
+pub mod linux;
+
+#[cfg(target_os = "linux")]
+pub use linux::Window;
+
 #[derive(Debug)]
 pub struct WindowSize {
     pub width: u16,